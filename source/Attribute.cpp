@@ -0,0 +1,129 @@
+/* Attribute.cpp
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "Attribute.h"
+
+namespace {
+	// The names of the attributes, in the same order as their IDs.
+	const char *const NAMES[Attribute::COUNT] = {
+		"absolute threshold",
+		"active cooling",
+		"afterburner energy",
+		"afterburner fuel",
+		"afterburner heat",
+		"afterburner thrust",
+		"asteroid scan power",
+		"atmosphere scan",
+		"automaton",
+		"bunks",
+		"cargo scan power",
+		"cargo scan speed",
+		"cargo space",
+		"cloak",
+		"cloaking energy",
+		"cloaking fuel",
+		"cloaking heat",
+		"cooling",
+		"cooling energy",
+		"cooling inefficiency",
+		"depleted shield delay",
+		"disabled repair delay",
+		"disruption protection",
+		"disruption resistance",
+		"disruption resistance energy",
+		"disruption resistance fuel",
+		"disruption resistance heat",
+		"drag",
+		"energy capacity",
+		"energy consumption",
+		"energy generation",
+		"energy protection",
+		"force protection",
+		"fuel capacity",
+		"fuel consumption",
+		"fuel energy",
+		"fuel generation",
+		"fuel heat",
+		"fuel protection",
+		"heat dissipation",
+		"heat generation",
+		"heat protection",
+		"hull",
+		"hull energy",
+		"hull energy multiplier",
+		"hull fuel",
+		"hull fuel multiplier",
+		"hull heat",
+		"hull heat multiplier",
+		"hull protection",
+		"hull repair multiplier",
+		"hull repair rate",
+		"hull threshold",
+		"hyperdrive",
+		"ion protection",
+		"ion resistance",
+		"ion resistance energy",
+		"ion resistance fuel",
+		"ion resistance heat",
+		"jump drive",
+		"jump fuel",
+		"jump range",
+		"jump speed",
+		"outfit scan power",
+		"outfit scan speed",
+		"piercing protection",
+		"piercing resistance",
+		"ramscoop",
+		"repair delay",
+		"required crew",
+		"reverse thrust",
+		"reverse thrusting energy",
+		"reverse thrusting heat",
+		"scram drive",
+		"self destruct",
+		"shield delay",
+		"shield energy",
+		"shield energy multiplier",
+		"shield fuel",
+		"shield fuel multiplier",
+		"shield generation",
+		"shield generation multiplier",
+		"shield heat",
+		"shield heat multiplier",
+		"shield protection",
+		"shields",
+		"slowing protection",
+		"slowing resistance",
+		"slowing resistance energy",
+		"slowing resistance fuel",
+		"slowing resistance heat",
+		"solar collection",
+		"solar heat",
+		"threshold percentage",
+		"thrust",
+		"thrusting energy",
+		"thrusting heat",
+		"turn",
+		"turning energy",
+		"turning heat",
+		"turret mounts",
+	};
+}
+
+
+
+// Get the name of the attribute with the given ID (which must be less than
+// COUNT).
+const char *Attribute::Name(Dictionary::Id id)
+{
+	return NAMES[id];
+}
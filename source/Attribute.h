@@ -0,0 +1,141 @@
+/* Attribute.h
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef ATTRIBUTE_H_
+#define ATTRIBUTE_H_
+
+#include "Dictionary.h"
+
+
+
+// Class listing the attributes that ships and the AI look up over and over,
+// usually for every ship in every step. These attribute names are given the
+// first Dictionary IDs, in this order, so that their IDs are known at compile
+// time and looking one of them up never involves comparing strings.
+class Attribute {
+public:
+	enum : Dictionary::Id {
+		ABSOLUTE_THRESHOLD,
+		ACTIVE_COOLING,
+		AFTERBURNER_ENERGY,
+		AFTERBURNER_FUEL,
+		AFTERBURNER_HEAT,
+		AFTERBURNER_THRUST,
+		ASTEROID_SCAN_POWER,
+		ATMOSPHERE_SCAN,
+		AUTOMATON,
+		BUNKS,
+		CARGO_SCAN_POWER,
+		CARGO_SCAN_SPEED,
+		CARGO_SPACE,
+		CLOAK,
+		CLOAKING_ENERGY,
+		CLOAKING_FUEL,
+		CLOAKING_HEAT,
+		COOLING,
+		COOLING_ENERGY,
+		COOLING_INEFFICIENCY,
+		DEPLETED_SHIELD_DELAY,
+		DISABLED_REPAIR_DELAY,
+		DISRUPTION_PROTECTION,
+		DISRUPTION_RESISTANCE,
+		DISRUPTION_RESISTANCE_ENERGY,
+		DISRUPTION_RESISTANCE_FUEL,
+		DISRUPTION_RESISTANCE_HEAT,
+		DRAG,
+		ENERGY_CAPACITY,
+		ENERGY_CONSUMPTION,
+		ENERGY_GENERATION,
+		ENERGY_PROTECTION,
+		FORCE_PROTECTION,
+		FUEL_CAPACITY,
+		FUEL_CONSUMPTION,
+		FUEL_ENERGY,
+		FUEL_GENERATION,
+		FUEL_HEAT,
+		FUEL_PROTECTION,
+		HEAT_DISSIPATION,
+		HEAT_GENERATION,
+		HEAT_PROTECTION,
+		HULL,
+		HULL_ENERGY,
+		HULL_ENERGY_MULTIPLIER,
+		HULL_FUEL,
+		HULL_FUEL_MULTIPLIER,
+		HULL_HEAT,
+		HULL_HEAT_MULTIPLIER,
+		HULL_PROTECTION,
+		HULL_REPAIR_MULTIPLIER,
+		HULL_REPAIR_RATE,
+		HULL_THRESHOLD,
+		HYPERDRIVE,
+		ION_PROTECTION,
+		ION_RESISTANCE,
+		ION_RESISTANCE_ENERGY,
+		ION_RESISTANCE_FUEL,
+		ION_RESISTANCE_HEAT,
+		JUMP_DRIVE,
+		JUMP_FUEL,
+		JUMP_RANGE,
+		JUMP_SPEED,
+		OUTFIT_SCAN_POWER,
+		OUTFIT_SCAN_SPEED,
+		PIERCING_PROTECTION,
+		PIERCING_RESISTANCE,
+		RAMSCOOP,
+		REPAIR_DELAY,
+		REQUIRED_CREW,
+		REVERSE_THRUST,
+		REVERSE_THRUSTING_ENERGY,
+		REVERSE_THRUSTING_HEAT,
+		SCRAM_DRIVE,
+		SELF_DESTRUCT,
+		SHIELD_DELAY,
+		SHIELD_ENERGY,
+		SHIELD_ENERGY_MULTIPLIER,
+		SHIELD_FUEL,
+		SHIELD_FUEL_MULTIPLIER,
+		SHIELD_GENERATION,
+		SHIELD_GENERATION_MULTIPLIER,
+		SHIELD_HEAT,
+		SHIELD_HEAT_MULTIPLIER,
+		SHIELD_PROTECTION,
+		SHIELDS,
+		SLOWING_PROTECTION,
+		SLOWING_RESISTANCE,
+		SLOWING_RESISTANCE_ENERGY,
+		SLOWING_RESISTANCE_FUEL,
+		SLOWING_RESISTANCE_HEAT,
+		SOLAR_COLLECTION,
+		SOLAR_HEAT,
+		THRESHOLD_PERCENTAGE,
+		THRUST,
+		THRUSTING_ENERGY,
+		THRUSTING_HEAT,
+		TURN,
+		TURNING_ENERGY,
+		TURNING_HEAT,
+		TURRET_MOUNTS,
+		
+		COUNT
+	};
+
+
+public:
+	// Get the name of the attribute with the given ID (which must be less than
+	// COUNT).
+	static const char *Name(Dictionary::Id id);
+};
+
+
+
+#endif
@@ -22,13 +22,24 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 using namespace std;
 
 namespace {
-	void Push(vector<float> &v, const Point &pos, float s, float t, float frame)
+	// The vertex data for a texture that has not been drawn in this many frames
+	// is freed, rather than being kept around in case it is needed again.
+	const int MAX_UNUSED_COUNT = 300;
+	
+	void Push(vector<float> &v, const Point &pos, float s, float t, const Sprite::Region &first,
+		const Sprite::Region &second, float fade)
 	{
 		v.push_back(pos.X());
 		v.push_back(pos.Y());
-		v.push_back(s);
-		v.push_back(t);
-		v.push_back(frame);
+		// Convert the coordinates within the sprite into the coordinates of each
+		// frame within its texture, which may be part of an atlas.
+		for(const Sprite::Region *region : {&first, &second})
+		{
+			v.push_back(region->rect[0] + s * (region->rect[2] - region->rect[0]));
+			v.push_back(region->rect[1] + t * (region->rect[3] - region->rect[1]));
+			v.push_back(region->layer);
+		}
+		v.push_back(fade);
 	}
 }
 
@@ -37,7 +48,20 @@ namespace {
 // Clear the list, also setting the global time step for animation.
 void BatchDrawList::Clear(int step, double zoom)
 {
-	data.clear();
+	for(auto it = data.begin(); it != data.end(); )
+	{
+		Batch &batch = it->second;
+		if(!batch.vertices.empty())
+			batch.unusedCount = 0;
+		else if(++batch.unusedCount > MAX_UNUSED_COUNT)
+		{
+			it = data.erase(it);
+			continue;
+		}
+		// This keeps the memory that was allocated for the vertices.
+		batch.vertices.clear();
+		++it;
+	}
 	this->step = step;
 	this->zoom = zoom;
 	isHighDPI = (Screen::IsHighResolution() ? zoom > .5 : zoom > 1.);
@@ -83,8 +107,8 @@ void BatchDrawList::Draw() const
 {
 	BatchShader::Bind();
 	
-	for(const pair<const Sprite * const, vector<float>> &it : data)
-		BatchShader::Add(it.first, isHighDPI, it.second);
+	for(const pair<const uint32_t, Batch> &it : data)
+		BatchShader::Add(it.first, it.second.vertices);
 	
 	BatchShader::Unbind();
 }
@@ -119,10 +143,13 @@ bool BatchDrawList::Add(const Body &body, Point position, float clip)
 	if(Cull(body, position))
 		return false;
 	
-	// Get the data vector for this particular sprite.
-	vector<float> &v = data[body.GetSprite()];
+	// Get the data vector for this particular sprite's texture.
+	const Sprite *sprite = body.GetSprite();
+	vector<float> &v = data[sprite->Texture(isHighDPI)].vertices;
 	// The sprite frame is the same for every vertex.
-	float frame = body.GetFrame(step);
+	Sprite::Region first;
+	Sprite::Region second;
+	float fade = sprite->GetRegions(body.GetFrame(step), isHighDPI, first, second);
 	
 	// Get unit vectors in the direction of the object's width and height.
 	Point unit = body.Unit() * zoom;
@@ -142,12 +169,12 @@ bool BatchDrawList::Add(const Body &body, Point position, float clip)
 	
 	// Push two copies of the first and last vertices to mark the break between
 	// the sprites.
-	Push(v, topLeft, 0.f, 1.f, frame);
-	Push(v, topLeft, 0.f, 1.f, frame);
-	Push(v, topRight, 1.f, 1.f, frame);
-	Push(v, bottomLeft, 0.f, 1.f - clip, frame);
-	Push(v, bottomRight, 1.f, 1.f - clip, frame);
-	Push(v, bottomRight, 1.f, 1.f - clip, frame);
+	Push(v, topLeft, 0.f, 1.f, first, second, fade);
+	Push(v, topLeft, 0.f, 1.f, first, second, fade);
+	Push(v, topRight, 1.f, 1.f, first, second, fade);
+	Push(v, bottomLeft, 0.f, 1.f - clip, first, second, fade);
+	Push(v, bottomRight, 1.f, 1.f - clip, first, second, fade);
+	Push(v, bottomRight, 1.f, 1.f - clip, first, second, fade);
 	
 	return true;
 }
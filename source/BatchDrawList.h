@@ -15,16 +15,17 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "Point.h"
 
+#include <cstdint>
 #include <map>
 #include <vector>
 
 class Body;
-class Sprite;
 
 
 
 // This class collects a set of OpenGL draw commands to issue and groups them by
-// sprite, so all instances of each sprite can be drawn with a single command.
+// texture, so all instances of each sprite (and of all the small sprites that
+// share a texture atlas) can be drawn with a single command.
 class BatchDrawList {
 public:
 	// Clear the list, also setting the global time step for animation.
@@ -55,9 +56,20 @@ private:
 	
 	// Each sprite consists of six vertices (four vertices to form a quad and
 	// two dummy vertices to mark the break in between them). Each of those
-	// vertices has five attributes: (x, y) position in pixels, (s, t) texture
-	// coordinates, and the index of the sprite frame.
-	std::map<const Sprite *, std::vector<float>> data;
+	// vertices has nine attributes: (x, y) position in pixels, the (s, t, layer)
+	// texture coordinates in each of the two frames to blend between, and how
+	// much of the second frame to blend in.
+	class Batch {
+	public:
+		std::vector<float> vertices;
+		// How many times in a row this list was cleared without any sprites
+		// having been drawn with this texture.
+		int unusedCount = 0;
+	};
+	// The batches are kept from one frame to the next, along with the memory
+	// allocated for them, so that drawing the same sprites as in the previous
+	// frames does not need to allocate any memory.
+	std::map<uint32_t, Batch> data;
 };
 
 
@@ -12,9 +12,9 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "BatchShader.h"
 
+#include "RenderCommands.h"
 #include "Screen.h"
 #include "Shader.h"
-#include "Sprite.h"
 
 using namespace std;
 
@@ -22,10 +22,11 @@ namespace {
 	Shader shader;
 	// Uniforms:
 	GLint scaleI;
-	GLint frameCountI;
 	// Vertex data:
 	GLint vertI;
-	GLint texCoordI;
+	GLint firstI;
+	GLint secondI;
+	GLint fadeI;
 	
 	GLuint vao;
 	GLuint vbo;
@@ -40,100 +41,108 @@ void BatchShader::Init()
 		"// vertex batch shader\n"
 		"uniform vec2 scale;\n"
 		"in vec2 vert;\n"
-		"in vec3 texCoord;\n"
+		"in vec3 first;\n"
+		"in vec3 second;\n"
+		"in float fade;\n"
 		
-		"out vec3 fragTexCoord;\n"
+		"out vec3 fragFirst;\n"
+		"out vec3 fragSecond;\n"
+		"out float fragFade;\n"
 		
 		"void main() {\n"
 		"  gl_Position = vec4(vert * scale, 0, 1);\n"
-		"  fragTexCoord = texCoord;\n"
+		"  fragFirst = first;\n"
+		"  fragSecond = second;\n"
+		"  fragFade = fade;\n"
 		"}\n";
 	
 	static const char *fragmentCode =
 		"// fragment batch shader\n"
 		"uniform sampler2DArray tex;\n"
-		"uniform float frameCount;\n"
 		
-		"in vec3 fragTexCoord;\n"
+		"in vec3 fragFirst;\n"
+		"in vec3 fragSecond;\n"
+		"in float fragFade;\n"
 		
 		"out vec4 finalColor;\n"
 		
 		"void main() {\n"
-		"  float first = floor(fragTexCoord.z);\n"
-		"  float second = mod(ceil(fragTexCoord.z), frameCount);\n"
-		"  float fade = fragTexCoord.z - first;\n"
-		"  finalColor = mix(\n"
-		"    texture(tex, vec3(fragTexCoord.xy, first)),\n"
-		"    texture(tex, vec3(fragTexCoord.xy, second)), fade);\n"
+		"  finalColor = mix(texture(tex, fragFirst), texture(tex, fragSecond), fragFade);\n"
 		"}\n";
 	
 	// Compile the shaders.
 	shader = Shader(vertexCode, fragmentCode);
 	// Get the indices of the uniforms and attributes.
 	scaleI = shader.Uniform("scale");
-	frameCountI = shader.Uniform("frameCount");
 	vertI = shader.Attrib("vert");
-	texCoordI = shader.Attrib("texCoord");
+	firstI = shader.Attrib("first");
+	secondI = shader.Attrib("second");
+	fadeI = shader.Attrib("fade");
 	
 	// Make sure we're using texture 0.
-	glUseProgram(shader.Object());
-	glUniform1i(shader.Uniform("tex"), 0);
-	glUseProgram(0);
+	RenderCommands::UseProgram(shader.Object());
+	RenderCommands::Uniform1i(shader.Uniform("tex"), 0);
+	RenderCommands::UseProgram(0);
 	
 	// Generate the buffer for uploading the batch vertex data.
-	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
+	vao = RenderCommands::GenVertexArray();
+	RenderCommands::BindVertexArray(vao);
 	
-	glGenBuffers(1, &vbo);
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	vbo = RenderCommands::GenBuffer();
+	RenderCommands::BindBuffer(GL_ARRAY_BUFFER, vbo);
 	
-	// In this VAO, enable the two vertex arrays and specify their byte offsets.
-	constexpr auto stride = 5 * sizeof(float);
-	glEnableVertexAttribArray(vertI);
-	glVertexAttribPointer(vertI, 2, GL_FLOAT, GL_FALSE, stride, nullptr);
-	// The 3 texture fields (s, t, frame) come after the x,y pixel fields.
-	auto textureOffset = reinterpret_cast<const GLvoid *>(2 * sizeof(float));
-	glEnableVertexAttribArray(texCoordI);
-	glVertexAttribPointer(texCoordI, 3, GL_FLOAT, GL_FALSE, stride, textureOffset);
+	// In this VAO, enable the four vertex arrays and specify their byte offsets.
+	constexpr auto stride = 9 * sizeof(float);
+	RenderCommands::EnableVertexAttribArray(vertI);
+	RenderCommands::VertexAttribPointer(vertI, 2, GL_FLOAT, false, stride, 0);
+	// The texture coordinates (s, t, layer) of the two frames to blend between
+	// come after the x,y pixel fields, followed by how much to blend them.
+	auto firstOffset = 2 * sizeof(float);
+	RenderCommands::EnableVertexAttribArray(firstI);
+	RenderCommands::VertexAttribPointer(firstI, 3, GL_FLOAT, false, stride, firstOffset);
+	auto secondOffset = 5 * sizeof(float);
+	RenderCommands::EnableVertexAttribArray(secondI);
+	RenderCommands::VertexAttribPointer(secondI, 3, GL_FLOAT, false, stride, secondOffset);
+	auto fadeOffset = 8 * sizeof(float);
+	RenderCommands::EnableVertexAttribArray(fadeI);
+	RenderCommands::VertexAttribPointer(fadeI, 1, GL_FLOAT, false, stride, fadeOffset);
 	
 	// Unbind the buffer and the VAO, but leave the vertex attrib arrays enabled
 	// in the VAO so they will be used when it is bound.
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	RenderCommands::BindBuffer(GL_ARRAY_BUFFER, 0);
+	RenderCommands::BindVertexArray(0);
 }
 
 
 
 void BatchShader::Bind()
 {
-	glUseProgram(shader.Object());
-	glBindVertexArray(vao);
+	RenderCommands::UseProgram(shader.Object());
+	RenderCommands::BindVertexArray(vao);
 	// Bind the vertex buffer so we can upload data to it.
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	RenderCommands::BindBuffer(GL_ARRAY_BUFFER, vbo);
 	
 	// Set up the screen scale.
 	GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
-	glUniform2fv(scaleI, 1, scale);
+	RenderCommands::Uniform2fv(scaleI, scale);
 }
 
 
 
-void BatchShader::Add(const Sprite *sprite, bool isHighDPI, const vector<float> &data)
+void BatchShader::Add(uint32_t texture, const vector<float> &data)
 {
 	// Do nothing if there are no sprites to draw.
 	if(data.empty())
 		return;
 	
 	// First, bind the proper texture.
-	glBindTexture(GL_TEXTURE_2D_ARRAY, sprite->Texture(isHighDPI));
-	// The shader also needs to know how many frames the texture has.
-	glUniform1f(frameCountI, sprite->Frames());
+	RenderCommands::BindTexture(GL_TEXTURE_2D_ARRAY, texture);
 	
 	// Upload the vertex data.
-	glBufferData(GL_ARRAY_BUFFER, sizeof(float) * data.size(), data.data(), GL_STREAM_DRAW);
+	RenderCommands::BufferData(GL_ARRAY_BUFFER, sizeof(float) * data.size(), data.data(), GL_STREAM_DRAW);
 	
 	// Draw all the vertices.
-	glDrawArrays(GL_TRIANGLE_STRIP, 0, data.size() / 5);
+	RenderCommands::DrawArrays(GL_TRIANGLE_STRIP, 0, data.size() / 9);
 }
 
 
@@ -141,7 +150,7 @@ void BatchShader::Add(const Sprite *sprite, bool isHighDPI, const vector<float>
 void BatchShader::Unbind()
 {
 	// Unbind everything in reverse order.
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
-	glUseProgram(0);
+	RenderCommands::BindBuffer(GL_ARRAY_BUFFER, 0);
+	RenderCommands::BindVertexArray(0);
+	RenderCommands::UseProgram(0);
 }
@@ -20,6 +20,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include <algorithm>
 #include <cmath>
 #include <limits>
+#include <map>
 #include <set>
 
 using namespace std;
@@ -147,33 +148,6 @@ namespace {
 		return false;
 	}
 	
-	// Converts the given vector of condition tokens (like "reputation: Republic",
-	// "random", or "4") into the integral values they have at runtime.
-	vector<int64_t> SubstituteValues(const vector<string> &side, const map<string, int64_t> &conditions, const map<string, int64_t> &created)
-	{
-		auto result = vector<int64_t>();
-		result.reserve(side.size());
-		for(const string &str : side)
-		{
-			int64_t value = 0;
-			if(str == "random")
-				value = Random::Int(100);
-			else if(DataNode::IsNumber(str))
-				value = static_cast<int64_t>(DataNode::Value(str));
-			else
-			{
-				const auto temp = created.find(str);
-				const auto perm = conditions.find(str);
-				if(temp != created.end())
-					value = temp->second;
-				else if(perm != conditions.end())
-					value = perm->second;
-			}
-			result.emplace_back(value);
-		}
-		return result;
-	}
-	
 	bool UsedAll(const vector<bool> &status)
 	{
 		for(auto v : status)
@@ -208,6 +182,14 @@ namespace {
 		Files::LogError(message);
 	}
 	
+	// Get the slot of a condition that may have a temporary value, or -1 if
+	// it is never assigned to.
+	int64_t TemporarySlot(const vector<ConditionsStore::Id> &temporaries, ConditionsStore::Id id)
+	{
+		auto it = find(temporaries.begin(), temporaries.end(), id);
+		return (it == temporaries.end()) ? -1 : it - temporaries.begin();
+	}
+	
 	bool IsUnrepresentable(const string &token)
 	{
 		if(DataNode::IsNumber(token))
@@ -240,6 +222,7 @@ void ConditionSet::Load(const DataNode &node)
 	isOr = (node.Token(0) == "or");
 	for(const DataNode &child : node)
 		Add(child);
+	Compile();
 }
 
 
@@ -346,6 +329,7 @@ void ConditionSet::Add(const DataNode &node)
 		node.PrintTrace("Condition parses to an empty set:");
 		expressions.pop_back();
 	}
+	needsCompile = true;
 }
 
 
@@ -370,6 +354,7 @@ bool ConditionSet::Add(const string &firstToken, const string &secondToken)
 		return false;
 	
 	hasAssign |= !expressions.back().IsTestable();
+	needsCompile = true;
 	return true;
 }
 
@@ -385,6 +370,7 @@ bool ConditionSet::Add(const string &name, const string &op, const string &value
 	
 	hasAssign |= !IsComparison(op);
 	expressions.emplace_back(name, op, value);
+	needsCompile = true;
 	return true;
 }
 
@@ -399,22 +385,27 @@ bool ConditionSet::Add(const vector<string> &lhs, const string &op, const vector
 	
 	hasAssign |= !IsComparison(op);
 	expressions.emplace_back(lhs, op, rhs);
+	needsCompile = true;
 	return true;
 }
 
 
 
 // Check if the given condition values satify this set of conditions. Performs any assignments
-// on a temporary condition map, if this set mixes comparisons and modifications.
+// on temporary conditions, if this set mixes comparisons and modifications.
 bool ConditionSet::Test(const Conditions &conditions) const
 {
+	if(needsCompile)
+		Compile();
+	
+	// A set that nothing has been added to is always satisfied.
+	if(program.empty())
+		return true;
+	
 	// If this ConditionSet contains any expressions with operators that
-	// modify the condition map, then they must be applied before testing,
+	// modify the conditions, then they must be applied before testing,
 	// to generate any temporary conditions needed.
-	Conditions created;
-	if(hasAssign)
-		TestApply(conditions, created);
-	return TestSet(conditions, created);
+	return Run(conditions, nullptr, hasAssign ? 0 : testStart, program.size());
 }
 
 
@@ -422,54 +413,195 @@ bool ConditionSet::Test(const Conditions &conditions) const
 // Modify the given set of conditions.
 void ConditionSet::Apply(Conditions &conditions) const
 {
-	Conditions unused;
+	if(needsCompile)
+		Compile();
+	
+	Run(conditions, &conditions, 0, testStart);
+}
+
+
+
+// Add the IDs of all the conditions that testing this set reads to the given
+// list. Returns false if the result of testing it also depends on chance.
+bool ConditionSet::AddDependencies(vector<ConditionsStore::Id> &ids) const
+{
+	if(needsCompile)
+		Compile();
+	
+	bool isDeterministic = true;
+	for(const Instruction &instruction : program)
+	{
+		if(instruction.code == Instruction::RANDOM)
+			isDeterministic = false;
+		else if(instruction.code == Instruction::CONDITION || instruction.code == Instruction::TEMPORARY)
+			ids.push_back(instruction.id);
+	}
+	return isDeterministic;
+}
+
+
+
+// Compile the expressions in this set and in its children into one program.
+void ConditionSet::Compile() const
+{
+	needsCompile = false;
+	vector<ConditionsStore::Id> temporaries;
+	AddTemporaries(temporaries);
+	
+	program.clear();
+	CompileAssignments(program, temporaries);
+	testStart = program.size();
+	CompileTests(program, temporaries);
+	
+	// Work out how big the stack must be. Anywhere a branch goes to, the stack
+	// is the same size as it would be after the instruction before it.
+	temporaryCount = temporaries.size();
+	stackSize = 0;
+	size_t size = 0;
+	for(const Instruction &instruction : program)
+	{
+		if(instruction.code <= Instruction::TEMPORARY)
+			stackSize = max(stackSize, ++size);
+		else if(instruction.code != Instruction::CREATE)
+			--size;
+	}
+}
+
+
+
+// List the conditions that this set or its children assign to, which are the
+// ones that may have temporary values when testing.
+void ConditionSet::AddTemporaries(vector<ConditionsStore::Id> &temporaries) const
+{
+	for(const Expression &expression : expressions)
+		if(!expression.IsTestable())
+		{
+			ConditionsStore::Id id = ConditionsStore::GetId(expression.Name());
+			if(TemporarySlot(temporaries, id) < 0)
+				temporaries.push_back(id);
+		}
+	
+	for(const ConditionSet &child : children)
+		child.AddTemporaries(temporaries);
+}
+
+
+
+// Compile this set's assignment expressions, then those of its children.
+void ConditionSet::CompileAssignments(vector<Instruction> &out, const vector<ConditionsStore::Id> &temporaries) const
+{
 	for(const Expression &expression : expressions)
 		if(!expression.IsTestable())
-			expression.Apply(conditions, unused);
+			expression.CompileAssignment(out, temporaries);
 	
 	for(const ConditionSet &child : children)
-		child.Apply(conditions);
+		child.CompileAssignments(out, temporaries);
 }
 
 
 
-// Check if this set is satisfied by either the created, temporary conditions, or the given conditions.
-bool ConditionSet::TestSet(const Conditions &conditions, const Conditions &created) const
+// Compile this set's comparisons, then those of its children. Not all
+// expressions may be testable: some may be assignments to temporary conditions.
+void ConditionSet::CompileTests(vector<Instruction> &out, const vector<ConditionsStore::Id> &temporaries) const
 {
-	// Not all expressions may be testable: some may have been used to form the "created" condition map.
+	// If this is a set of "and" conditions, bail out as soon as one of them is
+	// false. If it is an "or", bail out if anything is true.
+	const Instruction::Code branch = isOr ? Instruction::BRANCH_IF_TRUE : Instruction::BRANCH_IF_FALSE;
+	vector<size_t> branches;
 	for(const Expression &expression : expressions)
 		if(expression.IsTestable())
 		{
-			bool result = expression.Test(conditions, created);
-			// If this is a set of "and" conditions, bail out as soon as one of them
-			// returns false. If it is an "or", bail out if anything returns true.
-			if(result == isOr)
-				return result;
+			expression.CompileTest(out, temporaries);
+			branches.push_back(out.size());
+			out.push_back(Instruction{branch, 0, 0, nullptr});
 		}
 	
 	for(const ConditionSet &child : children)
 	{
-		bool result = child.TestSet(conditions, created);
-		if(result == isOr)
-			return result;
+		child.CompileTests(out, temporaries);
+		branches.push_back(out.size());
+		out.push_back(Instruction{branch, 0, 0, nullptr});
 	}
-	// If this is an "and" condition, all the above conditions were true, so return
-	// true. If it is an "or," no condition returned true, so return false.
-	return !isOr;
+	// If this is an "and" condition, all the above conditions were true, so the
+	// result is true. If it is an "or," no condition was true, so it is false.
+	out.push_back(Instruction{Instruction::CONSTANT, 0, !isOr, nullptr});
+	for(size_t index : branches)
+		out[index].value = out.size();
 }
 
 
 
-// Construct new, temporary conditions based on the assignment expressions in
-// this ConditionSet and the values in the player's conditions map.
-void ConditionSet::TestApply(const Conditions &conditions, Conditions &created) const
+// Run part of the program. If "applied" is null, any assignments are made to
+// temporary conditions, which are preferred over the given conditions with
+// the same names. Returns the value left on the stack, if any.
+int64_t ConditionSet::Run(const Conditions &conditions, Conditions *applied, size_t begin, size_t end) const
 {
-	for(const Expression &expression : expressions)
-		if(!expression.IsTestable())
-			expression.TestApply(conditions, created);
+	// The temporary conditions (and whether each one has been created yet) and
+	// the stack are almost always small enough to fit in this buffer, in which
+	// case nothing needs to be allocated.
+	static const size_t BUFFER_SIZE = 64;
+	int64_t buffer[BUFFER_SIZE];
+	vector<int64_t> allocated;
+	int64_t *values = buffer;
+	size_t size = 2 * temporaryCount + stackSize;
+	if(size > BUFFER_SIZE)
+	{
+		allocated.resize(size);
+		values = allocated.data();
+	}
+	int64_t *created = values + temporaryCount;
+	int64_t *stack = created + temporaryCount;
+	fill(created, stack, 0);
 	
-	for(const ConditionSet &child : children)
-		child.TestApply(conditions, created);
+	size_t top = 0;
+	for(size_t i = begin; i < end; ++i)
+	{
+		const Instruction &instruction = program[i];
+		switch(instruction.code)
+		{
+			case Instruction::CONSTANT:
+				stack[top++] = instruction.value;
+				break;
+			case Instruction::RANDOM:
+				stack[top++] = Random::Int(100);
+				break;
+			case Instruction::CONDITION:
+				stack[top++] = conditions.Get(instruction.id);
+				break;
+			case Instruction::TEMPORARY:
+				stack[top++] = created[instruction.value] ? values[instruction.value] : conditions.Get(instruction.id);
+				break;
+			case Instruction::OPERATOR:
+				--top;
+				stack[top - 1] = instruction.fun(stack[top - 1], stack[top]);
+				break;
+			case Instruction::CREATE:
+				if(!applied && !created[instruction.value])
+				{
+					created[instruction.value] = true;
+					values[instruction.value] = 0;
+				}
+				break;
+			case Instruction::ASSIGN:
+				--top;
+				if(applied)
+				{
+					int64_t &value = (*applied)[instruction.id];
+					value = instruction.fun(value, stack[top]);
+				}
+				else
+					values[instruction.value] = instruction.fun(values[instruction.value], stack[top]);
+				break;
+			case Instruction::BRANCH_IF_FALSE:
+			case Instruction::BRANCH_IF_TRUE:
+				if(static_cast<bool>(stack[top - 1]) == (instruction.code == Instruction::BRANCH_IF_TRUE))
+					i = instruction.value - 1;
+				else
+					--top;
+				break;
+		}
+	}
+	return top ? stack[top - 1] : 0;
 }
 
 
@@ -478,6 +610,8 @@ void ConditionSet::TestApply(const Conditions &conditions, Conditions &created)
 ConditionSet::Expression::Expression(const vector<string> &left, const string &op, const vector<string> &right)
 	: op(op), fun(Op(op)), left(left), right(right)
 {
+	if(!IsTestable())
+		name = ConditionsStore::GetId(Name());
 }
 
 
@@ -486,6 +620,8 @@ ConditionSet::Expression::Expression(const vector<string> &left, const string &o
 ConditionSet::Expression::Expression(const string &left, const string &op, const string &right)
 	: op(op), fun(Op(op)), left(left), right(right)
 {
+	if(!IsTestable())
+		name = ConditionsStore::GetId(Name());
 }
 
 
@@ -536,31 +672,24 @@ bool ConditionSet::Expression::IsTestable() const
 
 
 // Evaluate both the left- and right-hand sides of the expression, then compare the evaluated numeric values.
-bool ConditionSet::Expression::Test(const Conditions &conditions, const Conditions &created) const
+void ConditionSet::Expression::CompileTest(vector<Instruction> &program, const vector<ConditionsStore::Id> &temporaries) const
 {
-	int64_t lhs = left.Evaluate(conditions, created);
-	int64_t rhs = right.Evaluate(conditions, created);
-	return fun(lhs, rhs);
+	left.Compile(program, temporaries);
+	right.Compile(program, temporaries);
+	program.push_back(Instruction{Instruction::OPERATOR, 0, 0, fun});
 }
 
 
 
-// Assign the computed value to the desired condition.
-void ConditionSet::Expression::Apply(Conditions &conditions, Conditions &created) const
+// Assign the computed value to the desired condition. When testing, the
+// temporary condition is created before the right-hand side is evaluated, so
+// if it refers to the condition that is being assigned, it sees a value of 0.
+void ConditionSet::Expression::CompileAssignment(vector<Instruction> &program, const vector<ConditionsStore::Id> &temporaries) const
 {
-	int64_t &c = conditions[Name()];
-	int64_t value = right.Evaluate(conditions, created);
-	c = fun(c, value);
-}
-
-
-
-// Assign the computed value to the desired temporary condition.
-void ConditionSet::Expression::TestApply(const Conditions &conditions, Conditions &created) const
-{
-	int64_t &c = created[Name()];
-	int64_t value = right.Evaluate(conditions, created);
-	c = fun(c, value);
+	int64_t slot = TemporarySlot(temporaries, name);
+	program.push_back(Instruction{Instruction::CREATE, name, slot, nullptr});
+	right.Compile(program, temporaries);
+	program.push_back(Instruction{Instruction::ASSIGN, name, slot, fun});
 }
 
 
@@ -641,26 +770,18 @@ bool ConditionSet::Expression::SubExpression::IsEmpty() const
 
 
 
-// Evaluate the SubExpression using the given condition maps.
-int64_t ConditionSet::Expression::SubExpression::Evaluate(const Conditions &conditions, const Conditions &created) const
+// Add the instructions that compute the value of this SubExpression.
+void ConditionSet::Expression::SubExpression::Compile(vector<Instruction> &program, const vector<ConditionsStore::Id> &temporaries) const
 {
 	// Sanity check.
 	if(tokens.empty())
-		return 0;
-	
-	// For SubExpressions with no Operations (i.e. simple conditions), tokens will consist
-	// of only the condition or numeric value to be returned as-is after substitution.
-	auto data = SubstituteValues(tokens, conditions, created);
-	
-	if(!sequence.empty())
-	{
-		// Each Operation adds to the end of the data vector.
-		data.reserve(operatorCount + data.size());
-		for(const Operation &op : sequence)
-			data.emplace_back(op.fun(data[op.a], data[op.b]));
-	}
-	
-	return data.back();
+		program.push_back(Instruction{Instruction::CONSTANT, 0, 0, nullptr});
+	// For SubExpressions with no Operations (i.e. simple conditions), the value is the
+	// last token. Otherwise, it is the result of the last Operation.
+	else if(sequence.empty())
+		CompileValue(tokens.size() - 1, program, temporaries);
+	else
+		CompileValue(tokens.size() + sequence.size() - 1, program, temporaries);
 }
 
 
@@ -821,3 +942,36 @@ ConditionSet::Expression::SubExpression::Operation::Operation(const string &op,
 	: fun(Op(op)), a(a), b(b)
 {
 }
+
+
+
+// Add the instructions for the token or Operation result at the given index
+// of the data that the Operations refer to. Operations use their operands in
+// the same left-to-right order as the tokens appear, so any "random" tokens
+// are evaluated in the same order as they are written.
+void ConditionSet::Expression::SubExpression::CompileValue(size_t index, vector<Instruction> &program,
+	const vector<ConditionsStore::Id> &temporaries) const
+{
+	if(index >= tokens.size())
+	{
+		const Operation &operation = sequence[index - tokens.size()];
+		CompileValue(operation.a, program, temporaries);
+		CompileValue(operation.b, program, temporaries);
+		program.push_back(Instruction{Instruction::OPERATOR, 0, 0, operation.fun});
+		return;
+	}
+	
+	// Each token is either a number, the "random" keyword (a new random number
+	// from 0 to 99 each time it is used), or the name of a condition.
+	const string &token = tokens[index];
+	if(token == "random")
+		program.push_back(Instruction{Instruction::RANDOM, 0, 0, nullptr});
+	else if(DataNode::IsNumber(token))
+		program.push_back(Instruction{Instruction::CONSTANT, 0, static_cast<int64_t>(DataNode::Value(token)), nullptr});
+	else
+	{
+		ConditionsStore::Id id = ConditionsStore::GetId(token);
+		int64_t slot = TemporarySlot(temporaries, id);
+		program.push_back(Instruction{slot < 0 ? Instruction::CONDITION : Instruction::TEMPORARY, id, slot, nullptr});
+	}
+}
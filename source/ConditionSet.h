@@ -13,7 +13,9 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #ifndef CONDITION_SET_H_
 #define CONDITION_SET_H_
 
-#include <map>
+#include "ConditionsStore.h"
+
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -28,7 +30,7 @@ class DataWriter;
 // values.
 class ConditionSet {
 public:
-	using Conditions = std::map<std::string, int64_t>;
+	using Conditions = ConditionsStore;
 	ConditionSet() noexcept = default;
 	// Construct and Load() at the same time.
 	ConditionSet(const DataNode &node);
@@ -57,13 +59,54 @@ public:
 	// (Order of operations is like the order of specification: all sibling
 	// expressions are applied, then any and/or nodes are applied.)
 	void Apply(Conditions &conditions) const;
+	// Add the IDs of all the conditions that testing this set reads to the given
+	// list. Returns false if the result of testing it also depends on chance.
+	bool AddDependencies(std::vector<ConditionsStore::Id> &ids) const;
+	
+	
+private:
+	// One step of a compiled ConditionSet. The program is in postfix order:
+	// values are pushed onto a stack, and operators replace the top two values
+	// on the stack with their result.
+	class Instruction {
+	public:
+		enum Code : uint8_t {
+			// Push a value onto the stack.
+			CONSTANT, RANDOM, CONDITION, TEMPORARY,
+			// Replace the top two values with the result of a binary function.
+			OPERATOR,
+			// Make a temporary condition (if it does not exist yet), or pop a
+			// value and assign it to a condition.
+			CREATE, ASSIGN,
+			// If the top value is false (or true), skip to the given instruction.
+			// Otherwise, pop that value and continue.
+			BRANCH_IF_FALSE, BRANCH_IF_TRUE
+		};
+		
+		Code code;
+		// The condition that is read or assigned.
+		ConditionsStore::Id id;
+		// The constant, the slot of a temporary condition, or where to branch to.
+		int64_t value;
+		// The binary function of an operator or assignment.
+		int64_t (*fun)(int64_t, int64_t);
+	};
 	
 	
 private:
-	// Compare this set's expressions and the union of created and supplied conditions.
-	bool TestSet(const Conditions &conditions, const Conditions &created) const;
-	// Evaluate this set's assignment expressions and store the result in "created" (for use by TestSet).
-	void TestApply(const Conditions &conditions, Conditions &created) const;
+	// Compile the expressions in this set and in its children into one program.
+	void Compile() const;
+	// List the conditions that this set or its children assign to, which
+	// are the ones that may have temporary values when testing.
+	void AddTemporaries(std::vector<ConditionsStore::Id> &temporaries) const;
+	// Compile this set's assignment expressions, then those of its children.
+	void CompileAssignments(std::vector<Instruction> &out, const std::vector<ConditionsStore::Id> &temporaries) const;
+	// Compile this set's comparisons, then those of its children. The result
+	// is known as soon as one of them is false (for "and") or true (for "or").
+	void CompileTests(std::vector<Instruction> &out, const std::vector<ConditionsStore::Id> &temporaries) const;
+	// Run part of the program. If "applied" is null, any assignments are made
+	// to temporary conditions. Returns the value left on the stack, if any.
+	int64_t Run(const Conditions &conditions, Conditions *applied, size_t begin, size_t end) const;
 	
 	
 private:
@@ -86,10 +129,9 @@ private:
 		// True if this Expression performs a comparison and false if it performs an assignment.
 		bool IsTestable() const;
 		
-		// Functions to use this expression:
-		bool Test(const Conditions &conditions, const Conditions &created) const;
-		void Apply(Conditions &conditions, Conditions &created) const;
-		void TestApply(const Conditions &conditions, Conditions &created) const;
+		// Add the instructions for this expression to the given program.
+		void CompileTest(std::vector<Instruction> &program, const std::vector<ConditionsStore::Id> &temporaries) const;
+		void CompileAssignment(std::vector<Instruction> &program, const std::vector<ConditionsStore::Id> &temporaries) const;
 		
 		
 	private:
@@ -109,14 +151,16 @@ private:
 			
 			bool IsEmpty() const;
 			
-			// Substitute numbers for any string values and then compute the result.
-			int64_t Evaluate(const Conditions &conditions, const Conditions &created) const;
+			// Add the instructions that compute the value of this SubExpression.
+			void Compile(std::vector<Instruction> &program, const std::vector<ConditionsStore::Id> &temporaries) const;
 			
 			
 		private:
 			void ParseSide(const std::vector<std::string> &side);
 			void GenerateSequence();
 			bool AddOperation(std::vector<int> &data, size_t &index, const size_t &opIndex);
+			// Add the instructions for the token or Operation result at the given data index.
+			void CompileValue(size_t index, std::vector<Instruction> &program, const std::vector<ConditionsStore::Id> &temporaries) const;
 			
 			
 		private:
@@ -135,7 +179,7 @@ private:
 		private:
 			// Iteration of the sequence vector yields the result.
 			std::vector<Operation> sequence;
-			// The tokens vector converts into a data vector of numeric values during evaluation.
+			// The tokens are the first values of the data that the Operations refer to.
 			std::vector<std::string> tokens;
 			std::vector<std::string> operators;
 			// The number of true (non-parentheses) operators.
@@ -146,6 +190,8 @@ private:
 	private:
 		// String representation of the Expression's binary function.
 		std::string op;
+		// For an assignment, the ID of the condition that it assigns to.
+		ConditionsStore::Id name = 0;
 		// Pointer to a binary function that defines the assignment or
 		// comparison operation to be performed between SubExpressions.
 		int64_t (*fun)(int64_t, int64_t);
@@ -168,6 +214,18 @@ private:
 	std::vector<Expression> expressions;
 	// Nested sets of conditions to be tested.
 	std::vector<ConditionSet> children;
+	
+	// The compiled form of this set: all the assignments, in the order they are
+	// applied, followed by all the comparisons. A set that is loaded is compiled
+	// once it is complete; one that is built up through Add() is compiled the
+	// first time it is used.
+	mutable bool needsCompile = false;
+	mutable std::vector<Instruction> program;
+	mutable size_t testStart = 0;
+	// The number of conditions that may have temporary values, and the most
+	// values that are ever on the stack at once.
+	mutable size_t temporaryCount = 0;
+	mutable size_t stackSize = 0;
 };
 
 
@@ -0,0 +1,465 @@
+/* ConditionsStore.cpp
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "ConditionsStore.h"
+
+#include <functional>
+#include <limits>
+#include <type_traits>
+
+using namespace std;
+
+namespace {
+	using Id = ConditionsStore::Id;
+	
+	// The ID that marks an empty cell in the hash table.
+	const Id EMPTY = numeric_limits<Id>::max();
+	// The smallest hash table that is ever allocated.
+	const size_t MIN_CELLS = 16;
+	
+	// Every condition name that has been given an ID. The sorted map allows the
+	// conditions in a store to be visited in order of their names, and the hash
+	// index (which, like a store, is a flat table with linear probing) makes
+	// looking up a name fast.
+	class NameTable {
+	public:
+		// Each cell of the index points to the name and ID in the sorted map.
+		class IndexCell {
+		public:
+			size_t hash;
+			const pair<const string, Id> *entry;
+		};
+		
+		map<string, Id> ids;
+		vector<map<string, Id>::const_iterator> names;
+		vector<IndexCell> index = vector<IndexCell>(MIN_CELLS, IndexCell{0, nullptr});
+	};
+	
+	NameTable &Table()
+	{
+		static NameTable table;
+		return table;
+	}
+	
+	// Find the index cell that holds the given name, or the empty cell where
+	// it would go if it has no ID.
+	NameTable::IndexCell &IndexSlot(NameTable &table, const string &name, size_t hash)
+	{
+		size_t mask = table.index.size() - 1;
+		size_t slot = hash & mask;
+		while(table.index[slot].entry)
+		{
+			const NameTable::IndexCell &cell = table.index[slot];
+			if(cell.hash == hash && cell.entry->first == name)
+				break;
+			slot = (slot + 1) & mask;
+		}
+		return table.index[slot];
+	}
+	
+	// Find the ID of the given name without giving it one if it has none.
+	bool Lookup(const string &name, Id &id)
+	{
+		const NameTable::IndexCell &cell = IndexSlot(Table(), name, hash<string>()(name));
+		if(!cell.entry)
+			return false;
+		
+		id = cell.entry->second;
+		return true;
+	}
+	
+	// Successive IDs multiplied by an odd number land in different cells, so
+	// conditions that were named one after another do not collide.
+	size_t Hash(Id id, size_t mask)
+	{
+		return (static_cast<size_t>(id) * 2654435761u) & mask;
+	}
+}
+
+
+
+// Get the ID for the given condition name, giving it one if it does not
+// have one yet. IDs are never taken away, so they may be kept forever.
+ConditionsStore::Id ConditionsStore::GetId(const string &name)
+{
+	NameTable &table = Table();
+	size_t hash = std::hash<string>()(name);
+	NameTable::IndexCell *cell = &IndexSlot(table, name, hash);
+	if(cell->entry)
+		return cell->entry->second;
+	
+	Id id = table.names.size();
+	auto it = table.ids.emplace(name, id).first;
+	table.names.push_back(it);
+	// Keep the index at most half full, as with the stores.
+	if(2 * table.names.size() > table.index.size())
+	{
+		vector<NameTable::IndexCell> old(2 * table.index.size(), NameTable::IndexCell{0, nullptr});
+		old.swap(table.index);
+		for(const NameTable::IndexCell &oldCell : old)
+			if(oldCell.entry)
+				IndexSlot(table, oldCell.entry->first, oldCell.hash) = oldCell;
+		cell = &IndexSlot(table, name, hash);
+	}
+	*cell = NameTable::IndexCell{hash, &*it};
+	return id;
+}
+
+
+
+// Get the name that has the given ID.
+const string &ConditionsStore::Name(Id id)
+{
+	return Table().names[id]->first;
+}
+
+
+
+ConditionsStore::ConditionsStore(initializer_list<pair<const string, int64_t>> values)
+{
+	for(const auto &it : values)
+		(*this)[it.first] = it.second;
+}
+
+
+
+// Access the conditions by ID. Getting the value of a condition that is
+// not in the store returns 0, and Find() returns a null pointer.
+int64_t ConditionsStore::Get(Id id) const
+{
+	const int64_t *value = Find(id);
+	return value ? *value : 0;
+}
+
+
+
+const int64_t *ConditionsStore::Find(Id id) const
+{
+	if(cells.empty())
+		return nullptr;
+	
+	const Cell &cell = cells[Slot(id)];
+	return (cell.id == id) ? &cell.value : nullptr;
+}
+
+
+
+bool ConditionsStore::Has(Id id) const
+{
+	return Find(id);
+}
+
+
+
+// Get a reference to the value of the given condition, adding it with a
+// value of 0 if it is not already in the store. The reference is only
+// valid until another condition is added.
+int64_t &ConditionsStore::operator[](Id id)
+{
+	Touch(id);
+	if(cells.empty())
+		cells.assign(MIN_CELLS, Cell{EMPTY, 0});
+	
+	size_t slot = Slot(id);
+	if(cells[slot].id == id)
+		return cells[slot].value;
+	
+	// Keep the table at most half full, so that the probe sequences stay short.
+	if(2 * (used + 1) > cells.size())
+	{
+		Grow();
+		slot = Slot(id);
+	}
+	++used;
+	cells[slot] = Cell{id, 0};
+	return cells[slot].value;
+}
+
+
+
+// Remove a condition. Returns false if it was not in the store.
+bool ConditionsStore::Erase(Id id)
+{
+	if(cells.empty())
+		return false;
+	
+	size_t slot = Slot(id);
+	if(cells[slot].id != id)
+		return false;
+	
+	Touch(id);
+	// Rather than leaving a marker in the emptied cell, move any of the values
+	// after it that would have been placed there back into it. That way, empty
+	// cells always end a probe sequence.
+	size_t mask = cells.size() - 1;
+	size_t next = slot;
+	while(true)
+	{
+		next = (next + 1) & mask;
+		if(cells[next].id == EMPTY)
+			break;
+		
+		// A value can be moved back if the empty cell is not before its home
+		// cell, going around the table from the empty cell to where it is now.
+		size_t home = Hash(cells[next].id, mask);
+		if(((next - home) & mask) >= ((next - slot) & mask))
+		{
+			cells[slot] = cells[next];
+			slot = next;
+		}
+	}
+	cells[slot] = Cell{EMPTY, 0};
+	--used;
+	return true;
+}
+
+
+
+// Access the conditions by name, as with a std::map.
+int64_t &ConditionsStore::operator[](const string &name)
+{
+	return (*this)[GetId(name)];
+}
+
+
+
+ConditionsStore::iterator ConditionsStore::find(const string &name)
+{
+	Id id;
+	if(!Lookup(name, id) || !Has(id))
+		return end();
+	return iterator(this, Table().names[id]);
+}
+
+
+
+ConditionsStore::const_iterator ConditionsStore::find(const string &name) const
+{
+	Id id;
+	if(!Lookup(name, id) || !Has(id))
+		return end();
+	return const_iterator(this, Table().names[id]);
+}
+
+
+
+size_t ConditionsStore::count(const string &name) const
+{
+	Id id;
+	return Lookup(name, id) && Has(id);
+}
+
+
+
+pair<ConditionsStore::iterator, bool> ConditionsStore::emplace(const string &name, int64_t value)
+{
+	Id id = GetId(name);
+	bool isNew = !Has(id);
+	if(isNew)
+		(*this)[id] = value;
+	return make_pair(iterator(this, Table().names[id]), isNew);
+}
+
+
+
+size_t ConditionsStore::erase(const string &name)
+{
+	Id id;
+	return Lookup(name, id) && Erase(id);
+}
+
+
+
+ConditionsStore::iterator ConditionsStore::erase(iterator it)
+{
+	iterator next = it;
+	++next;
+	Erase(it.it->second);
+	return next;
+}
+
+
+
+ConditionsStore::iterator ConditionsStore::erase(iterator first, iterator last)
+{
+	while(first != last)
+		first = erase(first);
+	return last;
+}
+
+
+
+// Get the first condition whose name is not less than the given string.
+// This is useful for finding all the conditions with a certain prefix.
+ConditionsStore::iterator ConditionsStore::lower_bound(const string &name)
+{
+	return iterator(this, Table().ids.lower_bound(name));
+}
+
+
+
+ConditionsStore::const_iterator ConditionsStore::lower_bound(const string &name) const
+{
+	return const_iterator(this, Table().ids.lower_bound(name));
+}
+
+
+
+ConditionsStore::iterator ConditionsStore::begin()
+{
+	return iterator(this, Table().ids.begin());
+}
+
+
+
+ConditionsStore::const_iterator ConditionsStore::begin() const
+{
+	return const_iterator(this, Table().ids.begin());
+}
+
+
+
+ConditionsStore::iterator ConditionsStore::end()
+{
+	return iterator(this, Table().ids.end());
+}
+
+
+
+ConditionsStore::const_iterator ConditionsStore::end() const
+{
+	return const_iterator(this, Table().ids.end());
+}
+
+
+
+size_t ConditionsStore::size() const
+{
+	return used;
+}
+
+
+
+bool ConditionsStore::empty() const
+{
+	return !used;
+}
+
+
+
+void ConditionsStore::clear()
+{
+	cells.clear();
+	used = 0;
+	changed.clear();
+	clearedAt = ++revision;
+}
+
+
+
+// Get a number that increases whenever any condition may have changed.
+uint64_t ConditionsStore::Revision() const
+{
+	return revision;
+}
+
+
+
+// Check if the given condition may have changed since the given revision.
+bool ConditionsStore::HasChanged(Id id, uint64_t since) const
+{
+	return clearedAt > since || (id < changed.size() && changed[id] > since);
+}
+
+
+
+// Find the slot that holds the given ID, or the empty slot where it would
+// go if it is not in the table.
+size_t ConditionsStore::Slot(Id id) const
+{
+	size_t mask = cells.size() - 1;
+	size_t slot = Hash(id, mask);
+	while(cells[slot].id != id && cells[slot].id != EMPTY)
+		slot = (slot + 1) & mask;
+	return slot;
+}
+
+
+
+// Make the table bigger, and put all the values into their new slots.
+void ConditionsStore::Grow()
+{
+	vector<Cell> old(2 * cells.size(), Cell{EMPTY, 0});
+	old.swap(cells);
+	for(const Cell &cell : old)
+		if(cell.id != EMPTY)
+			cells[Slot(cell.id)] = cell;
+}
+
+
+
+// Note that the given condition is about to be changed.
+void ConditionsStore::Touch(Id id)
+{
+	if(id >= changed.size())
+		changed.resize(id + 1);
+	changed[id] = ++revision;
+}
+
+
+
+template <class ValueType>
+ConditionsStore::Entry<ValueType> ConditionsStore::Iterator<ValueType>::operator*() const
+{
+	// A non-const iterator can only have come from a non-const store, and the
+	// value it refers to may be changed through it.
+	if(!is_const<ValueType>::value)
+		const_cast<ConditionsStore *>(store)->Touch(it->second);
+	const Cell &cell = store->cells[store->Slot(it->second)];
+	return Entry<ValueType>{it->first, const_cast<int64_t &>(cell.value)};
+}
+
+
+
+template <class ValueType>
+ConditionsStore::Iterator<ValueType> &ConditionsStore::Iterator<ValueType>::operator++()
+{
+	++it;
+	Skip();
+	return *this;
+}
+
+
+
+template <class ValueType>
+ConditionsStore::Iterator<ValueType>::Iterator(const ConditionsStore *store, map<string, Id>::const_iterator it)
+	: store(store), it(it)
+{
+	Skip();
+}
+
+
+
+// Move forward until reaching a condition that is in the store.
+template <class ValueType>
+void ConditionsStore::Iterator<ValueType>::Skip()
+{
+	const auto end = Table().ids.end();
+	while(it != end && !store->Has(it->second))
+		++it;
+}
+
+
+
+// The iterators are only ever used with these two types.
+template class ConditionsStore::Iterator<int64_t>;
+template class ConditionsStore::Iterator<const int64_t>;
@@ -0,0 +1,167 @@
+/* ConditionsStore.h
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef CONDITIONS_STORE_H_
+#define CONDITIONS_STORE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+
+// Class holding the values of a set of "conditions," the named integers that
+// missions, events, and conversations test and change. Each condition name is
+// given a small integer ID the first time it is used, which stays the same for
+// as long as the game is running, so anything that uses the same conditions
+// over and over (such as a ConditionSet) can look them up by ID instead of by
+// comparing strings. The values are stored in a flat hash table keyed by ID.
+// For everything else, this class can also be used like a map from the names
+// to the values, and iterating over it visits the conditions sorted by name.
+// The store also keeps track of when each condition was last changed, so that
+// anything computed from the conditions knows when it must be recomputed.
+class ConditionsStore {
+public:
+	using Id = uint32_t;
+	
+	// The name and value of one condition, as seen through an iterator.
+	template <class ValueType>
+	class Entry {
+	public:
+		const std::string &first;
+		ValueType &second;
+	};
+	
+	template <class ValueType>
+	class Iterator {
+	public:
+		// Allow "it->first" even though the entry is made on the fly.
+		class Arrow {
+		public:
+			const Entry<ValueType> *operator->() const { return &entry; }
+			
+			Entry<ValueType> entry;
+		};
+	
+	public:
+		Entry<ValueType> operator*() const;
+		Arrow operator->() const { return Arrow{**this}; }
+		Iterator &operator++();
+		bool operator==(const Iterator &other) const { return it == other.it; }
+		bool operator!=(const Iterator &other) const { return it != other.it; }
+	
+	
+	private:
+		friend class ConditionsStore;
+		Iterator(const ConditionsStore *store, std::map<std::string, Id>::const_iterator it);
+		// Move forward until reaching a condition that is in the store.
+		void Skip();
+	
+	
+	private:
+		const ConditionsStore *store;
+		std::map<std::string, Id>::const_iterator it;
+	};
+	using iterator = Iterator<int64_t>;
+	using const_iterator = Iterator<const int64_t>;
+
+
+public:
+	// Get the ID for the given condition name, giving it one if it does not
+	// have one yet. IDs are never taken away, so they may be kept forever.
+	static Id GetId(const std::string &name);
+	// Get the name that has the given ID.
+	static const std::string &Name(Id id);
+
+
+public:
+	ConditionsStore() = default;
+	ConditionsStore(std::initializer_list<std::pair<const std::string, int64_t>> values);
+	
+	// Access the conditions by ID. Getting the value of a condition that is
+	// not in the store returns 0, and Find() returns a null pointer.
+	int64_t Get(Id id) const;
+	const int64_t *Find(Id id) const;
+	bool Has(Id id) const;
+	// Get a reference to the value of the given condition, adding it with a
+	// value of 0 if it is not already in the store. The reference is only
+	// valid until another condition is added.
+	int64_t &operator[](Id id);
+	// Remove a condition. Returns false if it was not in the store.
+	bool Erase(Id id);
+	
+	// Access the conditions by name, as with a std::map.
+	int64_t &operator[](const std::string &name);
+	iterator find(const std::string &name);
+	const_iterator find(const std::string &name) const;
+	size_t count(const std::string &name) const;
+	std::pair<iterator, bool> emplace(const std::string &name, int64_t value);
+	size_t erase(const std::string &name);
+	iterator erase(iterator it);
+	iterator erase(iterator first, iterator last);
+	// Get the first condition whose name is not less than the given string.
+	// This is useful for finding all the conditions with a certain prefix.
+	iterator lower_bound(const std::string &name);
+	const_iterator lower_bound(const std::string &name) const;
+	
+	iterator begin();
+	const_iterator begin() const;
+	iterator end();
+	const_iterator end() const;
+	
+	size_t size() const;
+	bool empty() const;
+	void clear();
+	
+	// Get a number that increases whenever any condition may have changed.
+	uint64_t Revision() const;
+	// Check if the given condition may have changed since the given revision.
+	// A condition counts as changed whenever a non-const reference to it is
+	// handed out, even if nothing is actually written to it.
+	bool HasChanged(Id id, uint64_t since) const;
+
+
+private:
+	// Find the slot that holds the given ID, or the empty slot where it would
+	// go if it is not in the table.
+	size_t Slot(Id id) const;
+	// Make the table bigger, and put all the values into their new slots.
+	void Grow();
+	// Note that the given condition is about to be changed.
+	void Touch(Id id);
+
+
+private:
+	class Cell {
+	public:
+		Id id;
+		int64_t value;
+	};
+	// The hash table uses linear probing. Its size is always a power of two, and
+	// at least twice the number of conditions in it.
+	std::vector<Cell> cells;
+	size_t used = 0;
+	
+	// The revision when each condition (by ID) was last changed, and when
+	// all of them were cleared.
+	std::vector<uint64_t> changed;
+	uint64_t revision = 0;
+	uint64_t clearedAt = 0;
+};
+
+
+
+#endif
@@ -49,6 +49,7 @@ void DataFile::Load(const string &path)
 	// Note what file this node is in, so it will show up in error traces.
 	root.tokens.push_back("file");
 	root.tokens.push_back(path);
+	root.CacheValues();
 	
 	LoadData(data);
 }
@@ -224,5 +225,6 @@ void DataFile::LoadData(const string &data)
 		}
 		// Now that we've reached the end of the line, we know no more tokens will be added to the node.
 		node.tokens.shrink_to_fit();
+		node.CacheValues();
 	}
 }
@@ -36,7 +36,7 @@ DataNode::DataNode(const DataNode *parent) noexcept(false)
 
 // Copy constructor.
 DataNode::DataNode(const DataNode &other)
-	: children(other.children), tokens(other.tokens), lineNumber(other.lineNumber)
+	: children(other.children), tokens(other.tokens), isNumber(other.isNumber), values(other.values), lineNumber(other.lineNumber)
 {
 	Reparent();
 }
@@ -48,6 +48,8 @@ DataNode &DataNode::operator=(const DataNode &other)
 {
 	children = other.children;
 	tokens = other.tokens;
+	isNumber = other.isNumber;
+	values = other.values;
 	lineNumber = other.lineNumber;
 	Reparent();
 	return *this;
@@ -56,7 +58,8 @@ DataNode &DataNode::operator=(const DataNode &other)
 
 
 DataNode::DataNode(DataNode &&other) noexcept
-	: children(std::move(other.children)), tokens(std::move(other.tokens)), lineNumber(std::move(other.lineNumber))
+	: children(std::move(other.children)), tokens(std::move(other.tokens)), isNumber(std::move(other.isNumber)),
+	values(std::move(other.values)), lineNumber(std::move(other.lineNumber))
 {
 	Reparent();
 }
@@ -67,6 +70,8 @@ DataNode &DataNode::operator=(DataNode &&other) noexcept
 {
 	children.swap(other.children);
 	tokens.swap(other.tokens);
+	isNumber.swap(other.isNumber);
+	values.swap(other.values);
 	lineNumber = std::move(other.lineNumber);
 	Reparent();
 	return *this;
@@ -105,10 +110,10 @@ double DataNode::Value(int index) const
 	// Check for empty strings and out-of-bounds indices.
 	if(static_cast<size_t>(index) >= tokens.size() || tokens[index].empty())
 		PrintTrace("Requested token index (" + to_string(index) + ") is out of bounds:");
-	else if(!IsNumber(tokens[index]))
+	else if(!IsNumber(index))
 		PrintTrace("Cannot convert value \"" + tokens[index] + "\" to a number:");
 	else
-		return Value(tokens[index]);
+		return values[index];
 	
 	return 0.;
 }
@@ -124,6 +129,14 @@ double DataNode::Value(const string &token)
 		Files::LogError("Cannot convert value \"" + token + "\" to a number.");
 		return 0.;
 	}
+	return ToNumber(token);
+}
+
+
+
+// Convert a token that is known to be a number, without checking its format.
+double DataNode::ToNumber(const string &token)
+{
 	const char *it = token.c_str();
 	
 	// Check for leading sign.
@@ -171,11 +184,8 @@ double DataNode::Value(const string &token)
 // class is able to parse.
 bool DataNode::IsNumber(int index) const
 {
-	// Make sure this token exists and is not empty.
-	if(static_cast<size_t>(index) >= tokens.size() || tokens[index].empty())
-		return false;
-	
-	return IsNumber(tokens[index]);
+	// Nodes that have no numeric tokens at all do not store a classification.
+	return static_cast<size_t>(index) < isNumber.size() && isNumber[index];
 }
 
 
@@ -292,3 +302,27 @@ void DataNode::Reparent() noexcept
 		child.Reparent();
 	}
 }
+
+
+
+// Classify and convert every token once, after the node has been tokenized.
+// Nodes with no numeric tokens (e.g. descriptions) do not allocate any values.
+void DataNode::CacheValues()
+{
+	isNumber.clear();
+	values.clear();
+	for(size_t i = 0; i < tokens.size(); ++i)
+	{
+		const string &token = tokens[i];
+		if(token.empty() || !IsNumber(token))
+			continue;
+		
+		if(values.empty())
+		{
+			isNumber.assign(tokens.size(), false);
+			values.assign(tokens.size(), 0.);
+		}
+		isNumber[i] = true;
+		values[i] = ToNumber(token);
+	}
+}
@@ -45,6 +45,7 @@ public:
 	const std::string &Token(int index) const;
 	// Convert the token at the given index to a number. This returns 0 if the
 	// index is out of range or the token cannot be interpreted as a number.
+	// The conversion is done once, when the node is tokenized.
 	double Value(int index) const;
 	static double Value(const std::string &token);
 	// Check if the token at the given index is a number in a format that this
@@ -65,6 +66,11 @@ public:
 private:
 	// Adjust the parent pointers when a copy is made of a DataNode.
 	void Reparent() noexcept;
+	// Classify each token and convert the numeric ones, so that IsNumber()
+	// and Value() do not need to reparse the token text on each call.
+	void CacheValues();
+	// Convert a token that has already been checked with IsNumber().
+	static double ToNumber(const std::string &token);
 	
 	
 private:
@@ -72,6 +78,10 @@ private:
 	std::list<DataNode> children;
 	// These are the tokens found in this particular line of the data file.
 	std::vector<std::string> tokens;
+	// Whether each token is a number, and if so its numeric value. Both are
+	// left empty if none of the tokens are numbers.
+	std::vector<bool> isNumber;
+	std::vector<double> values;
 	// The parent pointer is used only for printing stack traces.
 	const DataNode *parent = nullptr;
 	// The line number in the given file that produced this node.
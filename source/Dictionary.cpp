@@ -12,14 +12,52 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "Dictionary.h"
 
+#include "Attribute.h"
+
 #include <cstring>
+#include <map>
 #include <mutex>
-#include <set>
 #include <string>
 
 using namespace std;
 
 namespace {
+	// Every key that has been given an ID. The keys have static storage
+	// duration, so a dictionary can store pointers to them.
+	class KeyTable {
+	public:
+		KeyTable();
+		
+		Dictionary::Id Add(const char *key);
+		
+		map<string, Dictionary::Id> ids;
+		vector<const char *> keys;
+		// Just in case this is accessed from multiple threads:
+		mutex m;
+	};
+	
+	KeyTable &Table()
+	{
+		static KeyTable table;
+		return table;
+	}
+	
+	// The attributes with compile-time IDs are always the first ones added.
+	KeyTable::KeyTable()
+	{
+		for(Dictionary::Id id = 0; id < Attribute::COUNT; ++id)
+			Add(Attribute::Name(id));
+	}
+	
+	// Get the ID of the given key, adding it if it is not in the table.
+	Dictionary::Id KeyTable::Add(const char *key)
+	{
+		auto it = ids.emplace(key, keys.size());
+		if(it.second)
+			keys.push_back(it.first->first.c_str());
+		return it.first->second;
+	}
+	
 	// Perform a binary search on a sorted vector. Return the key's location (or
 	// proper insertion spot) in the first element of the pair, and "true" in
 	// the second element if the key is already in the vector.
@@ -43,18 +81,34 @@ namespace {
 		}
 		return make_pair(low, false);
 	}
-	
-	// String interning: return a pointer to a character string that matches the
-	// given string but has static storage duration.
-	const char *Intern(const char *key)
-	{
-		static set<string> interned;
-		static mutex m;
-		
-		// Just in case this function is accessed from multiple threads:
-		lock_guard<mutex> lock(m);
-		return interned.insert(key).first->c_str();
-	}
+}
+
+
+
+// Get the ID for the given key, giving it one if it does not have one yet.
+// IDs are never taken away, so they may be kept forever.
+Dictionary::Id Dictionary::GetId(const char *key)
+{
+	KeyTable &table = Table();
+	lock_guard<mutex> lock(table.m);
+	return table.Add(key);
+}
+
+
+
+Dictionary::Id Dictionary::GetId(const string &key)
+{
+	return GetId(key.c_str());
+}
+
+
+
+// Get the key that has the given ID.
+const char *Dictionary::Name(Id id)
+{
+	KeyTable &table = Table();
+	lock_guard<mutex> lock(table.m);
+	return table.keys[id];
 }
 
 
@@ -65,7 +119,7 @@ double &Dictionary::operator[](const char *key)
 	if(pos.second)
 		return data()[pos.first].second;
 	
-	return insert(begin() + pos.first, make_pair(Intern(key), 0.))->second;
+	return Insert(pos.first, GetId(key));
 }
 
 
@@ -77,6 +131,16 @@ double &Dictionary::operator[](const string &key)
 
 
 
+double &Dictionary::operator[](Id id)
+{
+	if(id < index.size() && index[id])
+		return data()[index[id] - 1].second;
+	
+	return Insert(Search(Name(id), *this).first, id);
+}
+
+
+
 double Dictionary::Get(const char *key) const
 {
 	pair<size_t, bool> pos = Search(key, *this);
@@ -89,3 +153,20 @@ double Dictionary::Get(const string &key) const
 {
 	return Get(key.c_str());
 }
+
+
+
+// Insert the given key, which is not in this dictionary yet, at the given
+// position, keeping the index up to date.
+double &Dictionary::Insert(size_t pos, Id id)
+{
+	insert(begin() + pos, make_pair(Name(id), 0.));
+	ids.insert(ids.begin() + pos, id);
+	if(index.size() <= id)
+		index.resize(id + 1, 0);
+	// Every key after this one has moved over by one.
+	for(size_t i = pos; i < ids.size(); ++i)
+		index[ids[i]] = i + 1;
+	
+	return data()[pos].second;
+}
@@ -13,6 +13,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #ifndef DICTIONARY_H_
 #define DICTIONARY_H_
 
+#include <cstdint>
 #include <string>
 #include <utility>
 #include <vector>
@@ -22,22 +23,59 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 // This class stores a mapping from character string keys to values, in a way
 // that prioritizes fast lookup time at the expense of longer construction time
 // compared to an STL map. That makes it suitable for ship attributes, which are
-// changed much less frequently than they are queried.
+// changed much less frequently than they are queried. Each key is also given a
+// small integer ID, which is the same in every dictionary, and looking a value
+// up by its ID is just an array index.
 class Dictionary : private std::vector<std::pair<const char *, double>> {
+public:
+	using Id = uint32_t;
+	
+	// Get the ID for the given key, giving it one if it does not have one yet.
+	// IDs are never taken away, so they may be kept forever.
+	static Id GetId(const char *key);
+	static Id GetId(const std::string &key);
+	// Get the key that has the given ID.
+	static const char *Name(Id id);
+	
+	
 public:
 	// Access a key for modifying it:
 	double &operator[](const char *key);
 	double &operator[](const std::string &key);
+	double &operator[](Id id);
 	// Get the value of a key, or 0 if it does not exist:
 	double Get(const char *key) const;
 	double Get(const std::string &key) const;
+	double Get(Id id) const;
 	
 	// Expose certain functions from the underlying vector:
 	using std::vector<std::pair<const char *, double>>::empty;
 	using std::vector<std::pair<const char *, double>>::begin;
 	using std::vector<std::pair<const char *, double>>::end;
+	
+	
+private:
+	// Insert the given key, which is not in this dictionary yet, at the given
+	// position, keeping the index up to date.
+	double &Insert(size_t pos, Id id);
+	
+	
+private:
+	// The ID of each key, in the same order as the keys.
+	std::vector<Id> ids;
+	// For each ID, one more than the position of that key, or 0 if it is not
+	// in this dictionary. This only extends as far as the largest ID that is.
+	std::vector<uint32_t> index;
 };
 
 
 
+// This gets called a lot, so inline it for speed.
+inline double Dictionary::Get(Id id) const
+{
+	return (id < index.size() && index[id]) ? data()[index[id] - 1].second : 0.;
+}
+
+
+
 #endif
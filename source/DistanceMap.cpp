@@ -12,14 +12,30 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "DistanceMap.h"
 
+#include "GameData.h"
 #include "Planet.h"
 #include "PlayerInfo.h"
 #include "Ship.h"
 #include "StellarObject.h"
 #include "System.h"
 
+#include <cstdint>
+#include <mutex>
+
 using namespace std;
 
+namespace {
+	// Keep at most this many shared distance maps. Maps for several different
+	// centers are often needed one after another, e.g. when a mission has
+	// location filters that are "near" different systems, so keeping only the
+	// most recent one would mean recomputing them again and again.
+	const size_t MAX_CACHED = 32;
+	
+	mutex cacheMutex;
+	map<pair<const System *, int>, shared_ptr<const DistanceMap>> cache;
+	uint64_t cacheRevision = 0;
+}
+
 
 
 // Find paths to the given system. If the given maximum count is above zero,
@@ -73,6 +89,26 @@ DistanceMap::DistanceMap(const Ship &ship, const System *destination)
 
 
 
+// Get a map of paths to the given system, as made by the first constructor
+// with no limit on the number of systems. Maps are shared and kept for many
+// different centers at once, until the links between systems may have changed.
+shared_ptr<const DistanceMap> DistanceMap::Cached(const System *center, int maxDistance)
+{
+	lock_guard<mutex> lock(cacheMutex);
+	if(cacheRevision != GameData::Revision() || cache.size() >= MAX_CACHED)
+	{
+		cacheRevision = GameData::Revision();
+		cache.clear();
+	}
+	
+	shared_ptr<const DistanceMap> &cached = cache[make_pair(center, maxDistance)];
+	if(!cached)
+		cached = make_shared<DistanceMap>(center, -1, maxDistance);
+	return cached;
+}
+
+
+
 // Find out if the given system is reachable.
 bool DistanceMap::HasRoute(const System *system) const
 {
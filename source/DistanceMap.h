@@ -14,6 +14,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #define DISTANCE_MAP_H_
 
 #include <map>
+#include <memory>
 #include <queue>
 #include <set>
 #include <utility>
@@ -43,6 +44,11 @@ public:
 	// pathfinding will stop once a path to the destination is found.
 	DistanceMap(const Ship &ship, const System *destination);
 	
+	// Get a map of paths to the given system, as made by the first constructor
+	// with no limit on the number of systems. Maps are shared and kept for many
+	// different centers at once, until the links between systems may have changed.
+	static std::shared_ptr<const DistanceMap> Cached(const System *center, int maxDistance = -1);
+	
 	// Find out if the given system is reachable.
 	bool HasRoute(const System *system) const;
 	// Find out how many days away the given system is.
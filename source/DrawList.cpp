@@ -28,7 +28,7 @@ using namespace std;
 // Clear the list.
 void DrawList::Clear(int step, double zoom)
 {
-	items.clear();
+	batcher.Clear();
 	this->step = step;
 	this->zoom = zoom;
 	isHighDPI = (Screen::IsHighResolution() ? zoom > .5 : zoom > 1.);
@@ -103,8 +103,8 @@ void DrawList::Draw() const
 	SpriteShader::Bind();
 	
 	bool withBlur = Preferences::Has("Render motion blur");
-	for(const SpriteShader::Item &item : items)
-		SpriteShader::Add(item, withBlur);
+	for(const SpriteBatcher::Batch &batch : batcher)
+		SpriteShader::Add(batch.items, withBlur);
 	
 	SpriteShader::Unbind();
 }
@@ -138,9 +138,9 @@ void DrawList::Push(const Body &body, Point pos, Point blur, double cloak, doubl
 {
 	SpriteShader::Item item;
 	
-	item.texture = body.GetSprite()->Texture(isHighDPI);
-	item.frame = body.GetFrame(step);
-	item.frameCount = body.GetSprite()->Frames();
+	const Sprite *sprite = body.GetSprite();
+	item.texture = sprite->Texture(isHighDPI);
+	item.fade = sprite->GetRegions(body.GetFrame(step), isHighDPI, item.first, item.second);
 	
 	// Get unit vectors in the direction of the object's width and height.
 	double width = body.Width();
@@ -176,5 +176,5 @@ void DrawList::Push(const Body &body, Point pos, Point blur, double cloak, doubl
 	item.alpha = 1. - cloak;
 	item.swizzle = swizzle;
 	
-	items.push_back(item);
+	batcher.Add(item);
 }
@@ -14,10 +14,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #define DRAW_LIST_H_
 
 #include "Point.h"
-#include "SpriteShader.h"
-
-#include <cstdint>
-#include <vector>
+#include "SpriteBatcher.h"
 
 class Body;
 class Sprite;
@@ -28,7 +25,8 @@ class Sprite;
 // work of calculating the transformation matrices to be done in a separate
 // thread from the graphics thread. However, the SpriteShader class is also
 // available for drawing individual sprites in contexts where putting them into
-// a DrawList first does not make sense.
+// a DrawList first does not make sense. Items that use the same texture are
+// drawn together when that does not change which of them end up on top.
 class DrawList {
 public:
 	// Clear the list, also setting the global time step for animation.
@@ -59,7 +57,9 @@ private:
 	int step = 0;
 	double zoom = 1.;
 	bool isHighDPI = false;
-	std::vector<SpriteShader::Item> items;
+	// The items are grouped into batches as they are added, so that drawing
+	// them takes as few draw calls as possible.
+	SpriteBatcher batcher;
 	
 	Point center;
 	Point centerVelocity;
@@ -204,10 +204,13 @@ Engine::Engine(PlayerInfo &player)
 	if(!player.IsLoaded() || !player.GetSystem())
 		return;
 	
-	// Preload any landscapes for this system.
+	// Preload any landscapes and stellar objects for this system.
 	for(const StellarObject &object : player.GetSystem()->Objects())
+	{
+		GameData::Preload(object.GetSprite());
 		if(object.HasSprite() && object.HasValidPlanet())
 			GameData::Preload(object.GetPlanet()->Landscape());
+	}
 	
 	// Figure out what planet the player is landed on, if any.
 	const StellarObject *object = player.GetStellarObject();
@@ -1134,10 +1137,12 @@ void Engine::EnterSystem()
 		+ today.ToString() + (system->IsInhabited(flagship) ?
 			"." : ". No inhabited planets detected."));
 	
-	// Preload landscapes and determine if the player used a wormhole.
-	// (It is allowed for a wormhole's exit point to have no sprite.)
+	// Preload landscapes and stellar objects, and determine if the player used
+	// a wormhole. (It is allowed for a wormhole's exit point to have no sprite.)
 	const StellarObject *usedWormhole = nullptr;
 	for(const StellarObject &object : system->Objects())
+	{
+		GameData::Preload(object.GetSprite());
 		if(object.HasValidPlanet())
 		{
 			GameData::Preload(object.GetPlanet()->Landscape());
@@ -1145,6 +1150,7 @@ void Engine::EnterSystem()
 					&& flagship->Position().Distance(object.Position()) < 1.)
 				usedWormhole = &object;
 		}
+	}
 	
 	// Advance the positions of every StellarObject and update politics.
 	// Remove expired bribes, clearance, and grace periods from past fines.
@@ -1207,6 +1213,10 @@ void Engine::EnterSystem()
 			}
 	}
 	
+	// The ships that are already here will be drawn right away.
+	for(const shared_ptr<Ship> &ship : newShips)
+		GameData::Preload(ship->GetSprite());
+	
 	const Fleet *raidFleet = system->GetGovernment()->RaidFleet();
 	const Government *raidGovernment = raidFleet ? raidFleet->GetGovernment() : nullptr;
 	if(raidGovernment && raidGovernment->IsEnemy())
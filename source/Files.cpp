@@ -441,6 +441,22 @@ time_t Files::Timestamp(const string &filePath)
 
 
 
+size_t Files::Size(const string &filePath)
+{
+#if defined _WIN32
+	struct _stat buf;
+	if(_wstat(ToUTF16(filePath).c_str(), &buf))
+		return 0;
+#else
+	struct stat buf;
+	if(stat(filePath.c_str(), &buf))
+		return 0;
+#endif
+	return buf.st_size;
+}
+
+
+
 void Files::Copy(const string &from, const string &to)
 {
 #if defined _WIN32
@@ -474,6 +490,22 @@ void Files::Delete(const string &filePath)
 
 
 
+// Create the given directory, if it does not already exist. Its parent
+// directory must already exist.
+void Files::CreateFolder(const string &path)
+{
+	if(Exists(path))
+		return;
+	
+#if defined _WIN32
+	CreateDirectoryW(ToUTF16(path).c_str(), nullptr);
+#else
+	mkdir(path.c_str(), 0755);
+#endif
+}
+
+
+
 // Get the filename from a path.
 string Files::Name(const string &path)
 {
@@ -484,10 +516,10 @@ string Files::Name(const string &path)
 
 
 
-FILE *Files::Open(const string &path, bool write)
+FILE *Files::Open(const string &path, bool write, bool binary)
 {
 #if defined _WIN32
-	return _wfopen(ToUTF16(path).c_str(), write ? L"w" : L"rb");
+	return _wfopen(ToUTF16(path).c_str(), write ? (binary ? L"wb" : L"w") : L"rb");
 #else
 	return fopen(path.c_str(), write ? "wb" : "rb");
 #endif
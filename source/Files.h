@@ -50,15 +50,21 @@ public:
 	
 	static bool Exists(const std::string &filePath);
 	static std::time_t Timestamp(const std::string &filePath);
+	static std::size_t Size(const std::string &filePath);
 	static void Copy(const std::string &from, const std::string &to);
 	static void Move(const std::string &from, const std::string &to);
 	static void Delete(const std::string &filePath);
+	// Create the given directory, if it does not already exist. Its parent
+	// directory must already exist.
+	static void CreateFolder(const std::string &path);
 	
 	// Get the filename from a path.
 	static std::string Name(const std::string &path);
 	
 	// File IO.
-	static FILE *Open(const std::string &path, bool write = false);
+	// Files are always read in binary mode. On Windows, files are written in
+	// text mode unless a binary file is requested.
+	static FILE *Open(const std::string &path, bool write = false, bool binary = false);
 	static std::string Read(const std::string &path);
 	static std::string Read(FILE *file);
 	static void Write(const std::string &path, const std::string &data);
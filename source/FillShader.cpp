@@ -14,6 +14,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "Color.h"
 #include "Point.h"
+#include "RenderCommands.h"
 #include "Screen.h"
 #include "Shader.h"
 
@@ -65,11 +66,11 @@ void FillShader::Init()
 	colorI = shader.Uniform("color");
 	
 	// Generate the vertex data for drawing sprites.
-	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
+	vao = RenderCommands::GenVertexArray();
+	RenderCommands::BindVertexArray(vao);
 	
-	glGenBuffers(1, &vbo);
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	vbo = RenderCommands::GenBuffer();
+	RenderCommands::BindBuffer(GL_ARRAY_BUFFER, vbo);
 	
 	GLfloat vertexData[] = {
 		-.5f, -.5f,
@@ -77,14 +78,14 @@ void FillShader::Init()
 		-.5f,  .5f,
 		 .5f,  .5f
 	};
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertexData), vertexData, GL_STATIC_DRAW);
+	RenderCommands::BufferData(GL_ARRAY_BUFFER, sizeof(vertexData), vertexData, GL_STATIC_DRAW);
 	
-	glEnableVertexAttribArray(shader.Attrib("vert"));
-	glVertexAttribPointer(shader.Attrib("vert"), 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), nullptr);
+	RenderCommands::EnableVertexAttribArray(shader.Attrib("vert"));
+	RenderCommands::VertexAttribPointer(shader.Attrib("vert"), 2, GL_FLOAT, false, 2 * sizeof(GLfloat), 0);
 	
 	// unbind the VBO and VAO
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	RenderCommands::BindBuffer(GL_ARRAY_BUFFER, 0);
+	RenderCommands::BindVertexArray(0);
 }
 
 
@@ -94,22 +95,22 @@ void FillShader::Fill(const Point &center, const Point &size, const Color &color
 	if(!shader.Object())
 		throw runtime_error("FillShader: Draw() called before Init().");
 	
-	glUseProgram(shader.Object());
-	glBindVertexArray(vao);
+	RenderCommands::UseProgram(shader.Object());
+	RenderCommands::BindVertexArray(vao);
 	
 	GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
-	glUniform2fv(scaleI, 1, scale);
+	RenderCommands::Uniform2fv(scaleI, scale);
 	
 	GLfloat centerV[2] = {static_cast<float>(center.X()), static_cast<float>(center.Y())};
-	glUniform2fv(centerI, 1, centerV);
+	RenderCommands::Uniform2fv(centerI, centerV);
 	
 	GLfloat sizeV[2] = {static_cast<float>(size.X()), static_cast<float>(size.Y())};
-	glUniform2fv(sizeI, 1, sizeV);
+	RenderCommands::Uniform2fv(sizeI, sizeV);
 	
-	glUniform4fv(colorI, 1, color.Get());
+	RenderCommands::Uniform4fv(colorI, color.Get());
 	
-	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	RenderCommands::DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 	
-	glBindVertexArray(0);
-	glUseProgram(0);
+	RenderCommands::BindVertexArray(0);
+	RenderCommands::UseProgram(0);
 }
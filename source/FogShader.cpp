@@ -15,6 +15,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "GameData.h"
 #include "PlayerInfo.h"
 #include "Point.h"
+#include "RenderCommands.h"
 #include "Screen.h"
 #include "Shader.h"
 #include "System.h"
@@ -45,7 +46,7 @@ namespace {
 	GLuint dimensionsI;
 	GLuint vao;
 	GLuint vbo;
-	GLuint texture = 0;
+	GLuint texture;
 	
 	// Keep track of the previous frame's view so that if it is unchanged we can
 	// skip regenerating the mask.
@@ -90,16 +91,16 @@ void FogShader::Init()
 	cornerI = shader.Uniform("corner");
 	dimensionsI = shader.Uniform("dimensions");
 	
-	glUseProgram(shader.Object());
-	glUniform1i(shader.Uniform("tex"), 0);
-	glUseProgram(0);
+	RenderCommands::UseProgram(shader.Object());
+	RenderCommands::Uniform1i(shader.Uniform("tex"), 0);
+	RenderCommands::UseProgram(0);
 	
 	// Generate the vertex data for drawing sprites.
-	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
+	vao = RenderCommands::GenVertexArray();
+	RenderCommands::BindVertexArray(vao);
 	
-	glGenBuffers(1, &vbo);
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	vbo = RenderCommands::GenBuffer();
+	RenderCommands::BindBuffer(GL_ARRAY_BUFFER, vbo);
 	
 	// Corners of a rectangle to draw.
 	GLfloat vertexData[] = {
@@ -108,15 +109,25 @@ void FogShader::Init()
 		1.f, 0.f,
 		1.f, 1.f
 	};
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertexData), vertexData, GL_STATIC_DRAW);
+	RenderCommands::BufferData(GL_ARRAY_BUFFER, sizeof(vertexData), vertexData, GL_STATIC_DRAW);
 	
 	GLuint vertI = shader.Attrib("vert");
-	glEnableVertexAttribArray(vertI);
-	glVertexAttribPointer(vertI, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), nullptr);
+	RenderCommands::EnableVertexAttribArray(vertI);
+	RenderCommands::VertexAttribPointer(vertI, 2, GL_FLOAT, false, 2 * sizeof(GLfloat), 0);
 	
 	// Unbind the VBO and VAO.
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	RenderCommands::BindBuffer(GL_ARRAY_BUFFER, 0);
+	RenderCommands::BindVertexArray(0);
+	
+	// Set up the texture that the mask is drawn into. Its image is allocated
+	// once the size of the mask is known.
+	texture = RenderCommands::GenTexture();
+	RenderCommands::BindTexture(GL_TEXTURE_2D, texture);
+	RenderCommands::TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	RenderCommands::TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	RenderCommands::TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	RenderCommands::TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	RenderCommands::BindTexture(GL_TEXTURE_2D, 0);
 }
 
 
@@ -149,7 +160,7 @@ void FogShader::Draw(const Point &center, double zoom, const PlayerInfo &player)
 		left != previousLeft || top != previousTop || columns != previousColumns || rows != previousRows);
 	if(shouldRegenerate)
 	{
-		bool sizeChanged = (!texture || columns != previousColumns || rows != previousRows);
+		bool sizeChanged = (columns != previousColumns || rows != previousRows);
 		
 		// Remember the current viewport attributes.
 		previousZoom = zoom;
@@ -197,50 +208,35 @@ void FogShader::Draw(const Point &center, double zoom, const PlayerInfo &player)
 			value = max(0, min(LIMIT, (value - 60) * 4));
 		const void *data = &buffer.front();
 		
-		// Set up the OpenGL texture if it doesn't exist yet.
+		// Upload the new "image." If the texture size changed, it must be
+		// reallocated.
+		RenderCommands::BindTexture(GL_TEXTURE_2D, texture);
 		if(sizeChanged)
-		{
-			// If the texture size changed, it must be reallocated.
-			if(texture)
-				glDeleteTextures(1, &texture);
-			
-			glGenTextures(1, &texture);
-			glBindTexture(GL_TEXTURE_2D, texture);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-			
-			// Upload the new "image."
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, columns, rows, 0, GL_RED, GL_UNSIGNED_BYTE, data);
-		}
+			RenderCommands::TexImage2D(GL_TEXTURE_2D, GL_R8, columns, rows, GL_RED, GL_UNSIGNED_BYTE, data);
 		else
-		{
-			glBindTexture(GL_TEXTURE_2D, texture);
-			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, columns, rows, GL_RED, GL_UNSIGNED_BYTE, data);
-		}
+			RenderCommands::TexSubImage2D(GL_TEXTURE_2D, 0, 0, columns, rows, GL_RED, GL_UNSIGNED_BYTE, data);
 	}
 	else
-		glBindTexture(GL_TEXTURE_2D, texture);
+		RenderCommands::BindTexture(GL_TEXTURE_2D, texture);
 	
 	// Set up to draw the image.
-	glUseProgram(shader.Object());
-	glBindVertexArray(vao);
+	RenderCommands::UseProgram(shader.Object());
+	RenderCommands::BindVertexArray(vao);
 	
 	GLfloat corner[2] = {
 		static_cast<float>(left - .5 * GRID * zoom) / (.5f * Screen::Width()),
 		static_cast<float>(top - .5 * GRID * zoom) / (-.5f * Screen::Height())};
-	glUniform2fv(cornerI, 1, corner);
+	RenderCommands::Uniform2fv(cornerI, corner);
 	GLfloat dimensions[2] = {
 		GRID * static_cast<float>(zoom) * (columns + 1.f) / (.5f * Screen::Width()),
 		GRID * static_cast<float>(zoom) * (rows + 1.f) / (-.5f * Screen::Height())};
-	glUniform2fv(dimensionsI, 1, dimensions);
+	RenderCommands::Uniform2fv(dimensionsI, dimensions);
 	
 	// Call the shader program to draw the image.
-	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	RenderCommands::DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 	
 	// Clean up.
-	glBindVertexArray(0);
-	glUseProgram(0);
-	glBindTexture(GL_TEXTURE_2D, 0);
+	RenderCommands::BindVertexArray(0);
+	RenderCommands::UseProgram(0);
+	RenderCommands::BindTexture(GL_TEXTURE_2D, 0);
 }
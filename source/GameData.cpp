@@ -26,13 +26,17 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Fleet.h"
 #include "FogShader.h"
 #include "text/FontSet.h"
+#include "FrameTimer.h"
 #include "Galaxy.h"
 #include "GameEvent.h"
 #include "Government.h"
 #include "Hazard.h"
+#include "ImageCache.h"
 #include "ImageSet.h"
 #include "Interface.h"
 #include "LineShader.h"
+#include "MapShader.h"
+#include "MaskCache.h"
 #include "Minable.h"
 #include "Mission.h"
 #include "Music.h"
@@ -44,22 +48,28 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Planet.h"
 #include "PointerShader.h"
 #include "Politics.h"
+#include "Profiler.h"
 #include "Random.h"
 #include "RingShader.h"
 #include "Ship.h"
 #include "Sprite.h"
 #include "SpriteQueue.h"
+#include "SpriteResidency.h"
 #include "SpriteSet.h"
 #include "SpriteShader.h"
 #include "StarField.h"
 #include "StartConditions.h"
 #include "System.h"
+#include "SystemGrid.h"
 #include "Test.h"
 #include "TestData.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <cstdlib>
 #include <iostream>
 #include <map>
+#include <mutex>
 #include <set>
 #include <utility>
 #include <vector>
@@ -89,6 +99,10 @@ namespace {
 	Set<Test> tests;
 	Set<TestData> testDataSets;
 	set<double> neighborDistances;
+	// Systems that may have changed since they were last updated, with the
+	// position that each one had back then.
+	map<const System *, Point> changedSystems;
+	bool allSystemsChanged = true;
 	
 	Set<Sale<Ship>> shipSales;
 	Set<Sale<Outfit>> outfitSales;
@@ -119,18 +133,181 @@ namespace {
 	
 	map<string, string> tooltips;
 	map<string, string> helpMessages;
+	
+	// This is incremented whenever the universe is changed or reverted, so
+	// that anything derived from it knows when to be recomputed.
+	uint64_t revision = 0;
+	
+	// The trade goods of every system that trades, laid out so that exports can
+	// be sent to the neighboring systems without looking anything up by name.
+	// Each row is one system, and each column is one of the commodities.
+	class EconomyTable {
+	public:
+		// A system that some other system receives a share of the exports of.
+		class Source {
+		public:
+			size_t row;
+			// The number of systems it shares its exports among.
+			double scale;
+		};
+		
+	public:
+		// The game data revision this was laid out for, plus one.
+		uint64_t revision = 0;
+		size_t columns = 0;
+		// Each system's price of each commodity, or null if it does not trade in it.
+		vector<System::Price *> prices;
+		// For each row, the range of sources it receives exports from, in the
+		// same order as its links. Systems without links receive nothing.
+		vector<size_t> firstSource;
+		vector<Source> sources;
+	};
+	EconomyTable economy;
 	map<string, string> plugins;
 	
 	SpriteQueue spriteQueue;
 	// Whether sprites and audio have finished loading at game startup.
 	bool initiallyLoaded = false;
+	// Measure how long it takes until everything is loaded.
+	FrameTimer startupTimer;
 	
 	vector<string> sources;
-	map<const Sprite *, shared_ptr<ImageSet>> deferred;
-	map<const Sprite *, int> preloaded;
+	
+	// Landscapes are only loaded when needed, and only a limited amount of them
+	// are kept loaded. The same can be done for all other sprites if a texture
+	// budget is specified on the command line.
+	const size_t DEFAULT_TEXTURE_BUDGET = 100 << 20;
+	// The image sets for all sprites that may be unloaded, so they can be
+	// loaded again if needed.
+	map<const Sprite *, shared_ptr<ImageSet>> unloadableSprites;
+	
+	class QueueBackend : public SpriteResidency::Backend {
+	public:
+		virtual void Load(const Sprite *sprite) override
+		{
+			// A sprite that is requested is likely needed soon, so load it
+			// before any sprites that are still waiting from startup.
+			auto it = unloadableSprites.find(sprite);
+			if(it != unloadableSprites.end())
+				spriteQueue.Add(it->second, SpriteQueue::Priority::HIGH);
+		}
+		virtual void Unload(const Sprite *sprite) override
+		{
+			spriteQueue.Unload(sprite->Name());
+		}
+		virtual size_t Bytes(const Sprite *sprite) const override
+		{
+			return sprite->Bytes();
+		}
+		virtual bool WasDrawn(const Sprite *sprite) override
+		{
+			return sprite->WasDrawn();
+		}
+	};
+	QueueBackend queueBackend;
+	SpriteResidency residency(queueBackend);
+	// Sprites may be requested by the engine's calculation thread.
+	mutex residencyMutex;
 	
 	const Government *playerGovernment = nullptr;
 	
+	// In debug mode, the data files are watched for changes. Remember when each
+	// file was last modified and which objects it defines, so that a change only
+	// requires re-reading the files that define the affected objects.
+	class WatchedFile {
+	public:
+		string path;
+		time_t timestamp;
+		set<pair<string, string>> definitions;
+	};
+	bool watchDataFiles = false;
+	vector<WatchedFile> watchedFiles;
+	
+	// Get the type and name of the object a root node defines. Ship variants are
+	// stored under the variant name rather than the model name.
+	pair<string, string> Definition(const DataNode &node)
+	{
+		if(node.Size() < 2)
+			return make_pair(node.Token(0), string());
+		bool isVariant = (node.Token(0) == "ship" && node.Size() > 2);
+		return make_pair(node.Token(0), node.Token(isVariant ? 2 : 1));
+	}
+	set<pair<string, string>> Definitions(const DataFile &data)
+	{
+		set<pair<string, string>> definitions;
+		for(const DataNode &node : data)
+			definitions.insert(Definition(node));
+		return definitions;
+	}
+	// Reset an object to its default state, so that loading its definitions
+	// again does not append to what was loaded before.
+	template <class Type>
+	void Reset(Set<Type> &set, const string &name)
+	{
+		*set.Get(name) = Type();
+	}
+	// Objects that are modified in place must also be updated in the copy of
+	// the universe that is restored when the game is reverted.
+	void LoadDefault(const DataNode &node)
+	{
+		const string &key = node.Token(0);
+		if(node.Size() < 2)
+			return;
+		if(key == "galaxy")
+			defaultGalaxies.Get(node.Token(1))->Load(node);
+		else if(key == "government")
+			defaultGovernments.Get(node.Token(1))->Load(node);
+		else if(key == "planet")
+			defaultPlanets.Get(node.Token(1))->Load(node);
+		else if(key == "system")
+			defaultSystems.Get(node.Token(1))->Load(node, planets);
+	}
+	// Reset the given object if its Load() function appends to an existing
+	// object instead of replacing it. Systems, planets, governments and galaxies
+	// are meant to be modified in place (e.g. by events), and objects such as
+	// colors and tooltips are simply overwritten, so those are not reset.
+	bool ResetDefinition(const pair<string, string> &definition)
+	{
+		const string &key = definition.first;
+		const string &name = definition.second;
+		if(key == "conversation")
+			Reset(conversations, name);
+		else if(key == "effect")
+			Reset(effects, name);
+		else if(key == "event")
+			Reset(events, name);
+		else if(key == "fleet")
+			Reset(fleets, name);
+		else if(key == "hazard")
+			Reset(hazards, name);
+		else if(key == "minable")
+			Reset(minables, name);
+		else if(key == "mission")
+			Reset(missions, name);
+		else if(key == "news")
+			Reset(news, name);
+		else if(key == "outfit")
+			Reset(outfits, name);
+		else if(key == "outfitter")
+			Reset(outfitSales, name);
+		else if(key == "person")
+			Reset(persons, name);
+		else if(key == "phrase")
+			Reset(phrases, name);
+		else if(key == "ship")
+			Reset(ships, name);
+		else if(key == "shipyard")
+			Reset(shipSales, name);
+		else if(key == "test")
+			Reset(tests, name);
+		else if(key == "test-data")
+			Reset(testDataSets, name);
+		else
+			return false;
+		
+		return true;
+	}
+	
 	// TODO (C++14): make these 3 methods generic lambdas visible only to the CheckReferences method.
 	// Log a warning for an "undefined" class object that was never loaded from disk.
 	void Warn(const string &noun, const string &name)
@@ -155,6 +332,56 @@ namespace {
 		it.second.SetName(it.first);
 		Warn(noun, it.first);
 	}
+	
+	// Lay out the economy table again if the systems may have changed.
+	void UpdateEconomyTable()
+	{
+		if(economy.revision == revision + 1)
+			return;
+		
+		economy.revision = revision + 1;
+		economy.prices.clear();
+		economy.firstSource.clear();
+		economy.sources.clear();
+		
+		// Each commodity gets one column, even if it is listed more than once.
+		vector<string> names;
+		for(const Trade::Commodity &commodity : trade.Commodities())
+			if(find(names.begin(), names.end(), commodity.name) == names.end())
+				names.push_back(commodity.name);
+		economy.columns = names.size();
+		
+		map<const System *, size_t> rows;
+		for(auto &it : systems)
+		{
+			System &system = it.second;
+			if(!system.HasTrade())
+				continue;
+			
+			rows[&system] = economy.firstSource.size();
+			economy.firstSource.push_back(0);
+			for(const string &name : names)
+				economy.prices.push_back(system.GetPrice(name));
+		}
+		
+		// Systems that do not trade have no exports to share.
+		size_t row = 0;
+		for(const auto &it : systems)
+		{
+			if(!it.second.HasTrade())
+				continue;
+			
+			economy.firstSource[row++] = economy.sources.size();
+			for(const System *neighbor : it.second.Links())
+			{
+				auto rit = rows.find(neighbor);
+				double scale = neighbor->Links().size();
+				if(rit != rows.end() && scale)
+					economy.sources.push_back(EconomyTable::Source{rit->second, scale});
+			}
+		}
+		economy.firstSource.push_back(economy.sources.size());
+	}
 }
 
 
@@ -164,6 +391,11 @@ bool GameData::BeginLoad(const char * const *argv)
 	bool printShips = false;
 	bool printTests = false;
 	bool printWeapons = false;
+	bool printLoadTimes = false;
+	bool useImageCache = false;
+	bool pruneImageCache = false;
+	bool clearImageCache = false;
+	size_t textureBudget = 0;
 	bool debugMode = false;
 	for(const char * const *it = argv + 1; *it; ++it)
 	{
@@ -176,20 +408,50 @@ bool GameData::BeginLoad(const char * const *argv)
 				printWeapons = true;
 			if(arg == "--tests")
 				printTests = true;
+			if(arg == "--load-times")
+				printLoadTimes = true;
+			if(arg == "--image-cache")
+				useImageCache = true;
+			if(arg == "--prune-image-cache")
+				useImageCache = pruneImageCache = true;
+			if(arg == "--clear-image-cache")
+				useImageCache = clearImageCache = true;
+			if(arg == "--texture-budget" && *(it + 1))
+				textureBudget = static_cast<size_t>(max(0, atoi(*(it + 1)))) << 20;
 			if(arg == "-d" || arg == "--debug")
 				debugMode = true;
 			continue;
 		}
 	}
+	if(printLoadTimes)
+		Profiler::Enable();
+	watchDataFiles = debugMode;
 	Files::Init(argv);
 	
+	// Optionally, keep a copy of each image after it is decoded, so that the
+	// next launch of the game does not need to decode it again.
+	if(useImageCache)
+	{
+		ImageCache::Init(Files::Config() + "image cache/");
+		if(clearImageCache)
+			ImageCache::Clear();
+		else if(pruneImageCache)
+			cout << "Removed " << ImageCache::Prune() << " outdated images from the image cache." << endl;
+	}
+	// Collision masks take up little space, so they are always cached.
+	MaskCache::Init(Files::Config() + "masks.dat");
+	
 	// Initialize the list of "source" folders based on any active plugins.
+	FrameTimer timer;
 	LoadSources();
+	Profiler::Add("find plugins", timer.Time());
 	
 	// Now, read all the images in all the path directories. For each unique
 	// name, only remember one instance, letting things on the higher priority
 	// paths override the default images.
+	timer = FrameTimer();
 	map<string, shared_ptr<ImageSet>> images = FindImages();
+	Profiler::Add("find images", timer.Time());
 	
 	// From the name, strip out any frame number, plus the extension.
 	for(const auto &it : images)
@@ -201,14 +463,32 @@ bool GameData::BeginLoad(const char * const *argv)
 		// Check that the image set is complete.
 		it.second->Check();
 		// For landscapes, remember all the source files but don't load them yet.
+		// The sprites for the main menu and the user interface are loaded first,
+		// and are never unloaded.
+		const Sprite *sprite = SpriteSet::Get(it.first);
 		if(ImageSet::IsDeferred(it.first))
-			deferred[SpriteSet::Get(it.first)] = it.second;
+		{
+			unloadableSprites[sprite] = it.second;
+			residency.Manage(sprite, false);
+		}
+		else if(!it.first.compare(0, 6, "_menu/") || !it.first.compare(0, 3, "ui/"))
+			spriteQueue.Add(it.second, SpriteQueue::Priority::HIGH);
 		else
+		{
 			spriteQueue.Add(it.second);
+			if(textureBudget)
+			{
+				unloadableSprites[sprite] = it.second;
+				residency.Manage(sprite, true);
+			}
+		}
 	}
+	residency.SetBudget(textureBudget ? textureBudget : DEFAULT_TEXTURE_BUDGET);
 	
 	// Generate a catalog of music files.
+	timer = FrameTimer();
 	Music::Init(sources);
+	Profiler::Add("find music", timer.Time());
 	
 	for(const string &source : sources)
 	{
@@ -224,13 +504,17 @@ bool GameData::BeginLoad(const char * const *argv)
 	// system information. Make sure that the default jump range is among the
 	// neighbor distances to be updated.
 	AddJumpRange(System::DEFAULT_NEIGHBOR_DISTANCE);
+	timer = FrameTimer();
 	UpdateSystems();
+	Profiler::Add("update systems", timer.Time());
 	
 	// And, update the ships with the outfits we've now finished loading.
+	timer = FrameTimer();
 	for(auto &&it : ships)
 		it.second.FinishLoading(true);
 	for(auto &&it : persons)
 		it.second.FinishLoading();
+	Profiler::Add("finish loading ships", timer.Time());
 	
 	for(auto &&it : startConditions)
 		it.FinishLoading();
@@ -251,6 +535,7 @@ bool GameData::BeginLoad(const char * const *argv)
 	playerGovernment = governments.Get("Escort");
 	
 	politics.Reset();
+	Profiler::Add("game data (total)", startupTimer.Time());
 	
 	if(printShips)
 		PrintShipTable();
@@ -258,7 +543,12 @@ bool GameData::BeginLoad(const char * const *argv)
 		PrintTestsTable();
 	if(printWeapons)
 		PrintWeaponTable();
-	return !(printShips || printWeapons || printTests);
+	bool exitEarly = (printShips || printWeapons || printTests);
+	// If the game is not going to start, the sprites will never finish loading,
+	// so report only the time spent on the game data.
+	if(printLoadTimes && exitEarly)
+		Profiler::Print(cout);
+	return !exitEarly;
 }
 
 
@@ -355,7 +645,51 @@ void GameData::CheckReferences()
 
 
 
-void GameData::LoadShaders(bool useShaderSwizzle)
+int GameData::CheckShipStats()
+{
+	int mismatches = 0;
+	auto check = [&mismatches](const Ship &ship, const string &context) -> void
+	{
+		if(ship.HasCurrentDerivedStats())
+			return;
+		++mismatches;
+		Files::LogError("Ship \"" + ship.ModelName() + "\": cached stats are out of date " + context + ".");
+	};
+	
+	for(const auto &it : persons)
+		for(const shared_ptr<Ship> &ship : it.second.Ships())
+			check(*ship, "in person \"" + it.first + "\"");
+	
+	// Remove and replace each of every model's outfits, then give each outfit in
+	// turn to the next model, so every model and every outfit is exercised.
+	auto outfit = outfits.begin();
+	for(const auto &it : ships)
+	{
+		check(it.second, "after loading");
+		Ship ship = it.second;
+		for(const auto &oit : it.second.Outfits())
+		{
+			ship.AddOutfit(oit.first, -1);
+			check(ship, "after removing \"" + oit.first->Name() + "\"");
+			ship.AddOutfit(oit.first, 1);
+			check(ship, "after installing \"" + oit.first->Name() + "\"");
+		}
+		for(size_t i = 0; i < outfits.size() / max<size_t>(1, ships.size()) + 1 && outfit != outfits.end(); ++i, ++outfit)
+		{
+			// Skip submunitions and other weapons that cannot be installed.
+			const Outfit &added = outfit->second;
+			if(added.IsWeapon() && !added.Get("gun ports") && !added.Get("turret mounts"))
+				continue;
+			ship.AddOutfit(&added, 1);
+			check(ship, "after installing \"" + outfit->first + "\"");
+		}
+	}
+	return mismatches;
+}
+
+
+
+void GameData::LoadShaders(bool useShaderSwizzle, bool useInstancing)
 {
 	FontSet::Add(Files::Images() + "font/ubuntu14r.png", 14);
 	FontSet::Add(Files::Images() + "font/ubuntu18r.png", 18);
@@ -367,10 +701,11 @@ void GameData::LoadShaders(bool useShaderSwizzle)
 	FillShader::Init();
 	FogShader::Init();
 	LineShader::Init();
+	MapShader::Init();
 	OutlineShader::Init();
 	PointerShader::Init();
 	RingShader::Init();
-	SpriteShader::Init(useShaderSwizzle);
+	SpriteShader::Init(useShaderSwizzle, useInstancing);
 	BatchShader::Init();
 	
 	background.Init(16384, 4096);
@@ -392,6 +727,13 @@ double GameData::Progress()
 				if(path.compare(0, 5, "land/") != 0)
 					Files::LogError("Warning: image \"" + path + "\" is referred to, but has no pixels.");
 			initiallyLoaded = true;
+			MaskCache::Save();
+			
+			if(Profiler::IsEnabled())
+			{
+				Profiler::Add("startup (total)", startupTimer.Time());
+				Profiler::Print(cout);
+			}
 		}
 	}
 	return progress;
@@ -406,49 +748,58 @@ bool GameData::IsLoaded()
 
 
 
-// Begin loading a sprite that was previously deferred. Currently this is
-// done with all landscapes to speed up the program's startup.
-void GameData::Preload(const Sprite *sprite)
+// Whether the sprites needed to use the main menu (the menu, the user interface,
+// and anything passed to Prioritize()) have been loaded. The remaining sprites
+// continue loading in the background.
+bool GameData::IsReady()
+{
+	return initiallyLoaded || spriteQueue.IsPriorityDone();
+}
+
+
+
+// Load the given sprite before any sprites of normal priority. This is used for
+// the sprites that the game will need to draw first.
+void GameData::Prioritize(const Sprite *sprite)
 {
-	// Make sure this sprite actually is one that uses deferred loading.
-	auto dit = deferred.find(sprite);
-	if(!sprite || dit == deferred.end())
+	if(!sprite)
 		return;
 	
-	// If this sprite is one of the currently loaded ones, there is no need to
-	// load it again. But, make note of the fact that it is the most recently
-	// asked-for sprite.
-	map<const Sprite *, int>::iterator pit = preloaded.find(sprite);
-	if(pit != preloaded.end())
+	unique_lock<mutex> lock(residencyMutex);
+	if(residency.IsManaged(sprite) && !residency.IsResident(sprite))
+		residency.Request(sprite);
+	else
 	{
-		for(pair<const Sprite * const, int> &it : preloaded)
-			if(it.second < pit->second)
-				++it.second;
-		
-		pit->second = 0;
-		return;
+		lock.unlock();
+		spriteQueue.Prioritize(sprite->Name());
 	}
+}
+
+
+
+// Make sure that the given sprite is loaded if it is one that may have been
+// unloaded, or that is only loaded when needed (e.g. landscapes).
+void GameData::Preload(const Sprite *sprite)
+{
+	lock_guard<mutex> lock(residencyMutex);
+	residency.Request(sprite);
+}
+
+
+
+// Upload any sprites that have been read since the last frame, load any that
+// were drawn after being unloaded, and unload the least recently drawn ones
+// if they take up more than the texture budget.
+void GameData::UpdateSprites()
+{
+	if(!initiallyLoaded)
+		return;
 	
-	// This sprite is not currently preloaded. Check to see whether we already
-	// have the maximum number of sprites loaded, in which case the oldest one
-	// must be unloaded to make room for this one.
-	const string &name = sprite->Name();
-	pit = preloaded.begin();
-	while(pit != preloaded.end())
 	{
-		++pit->second;
-		if(pit->second >= 20)
-		{
-			spriteQueue.Unload(name);
-			pit = preloaded.erase(pit);
-		}
-		else
-			++pit;
+		lock_guard<mutex> lock(residencyMutex);
+		residency.Step();
 	}
-	
-	// Now, load all the files for this sprite.
-	preloaded[sprite] = 0;
-	spriteQueue.Add(dit->second);
+	spriteQueue.Progress();
 }
 
 
@@ -483,6 +834,17 @@ void GameData::Revert()
 	
 	politics.Reset();
 	purchases.clear();
+	changedSystems.clear();
+	allSystemsChanged = true;
+	++revision;
+}
+
+
+
+// Get a number that changes whenever the universe is changed or reverted.
+uint64_t GameData::Revision()
+{
+	return revision;
 }
 
 
@@ -592,21 +954,38 @@ void GameData::StepEconomy()
 	
 	// Finally, send out the trade goods. This has to be done in a separate step
 	// because otherwise whichever systems trade last would already have gotten
-	// supplied by the other systems.
-	for(auto &it : systems)
+	// supplied by the other systems. Each system's new supply of every commodity
+	// is its own supply plus a share of each of its neighbors' exports.
+	UpdateEconomyTable();
+	const size_t columns = economy.columns;
+	vector<double> exports(economy.prices.size(), 0.);
+	for(size_t i = 0; i < exports.size(); ++i)
+		if(economy.prices[i])
+			exports[i] = economy.prices[i]->exports;
+	
+	vector<double> supply(columns);
+	for(size_t row = 0; row + 1 < economy.firstSource.size(); ++row)
 	{
-		System &system = it.second;
-		if(!system.Links().empty())
-			for(const Trade::Commodity &commodity : trade.Commodities())
+		size_t first = economy.firstSource[row];
+		size_t last = economy.firstSource[row + 1];
+		if(first == last)
+			continue;
+		
+		System::Price * const *prices = economy.prices.data() + row * columns;
+		for(size_t i = 0; i < columns; ++i)
+			supply[i] = prices[i] ? prices[i]->supply : 0.;
+		for(size_t s = first; s < last; ++s)
+		{
+			const double *neighborExports = exports.data() + economy.sources[s].row * columns;
+			const double scale = economy.sources[s].scale;
+			for(size_t i = 0; i < columns; ++i)
+				supply[i] += neighborExports[i] / scale;
+		}
+		for(size_t i = 0; i < columns; ++i)
+			if(prices[i])
 			{
-				double supply = system.Supply(commodity.name);
-				for(const System *neighbor : system.Links())
-				{
-					double scale = neighbor->Links().size();
-					if(scale)
-						supply += neighbor->Exports(commodity.name) / scale;
-				}
-				system.SetSupply(commodity.name, supply);
+				prices[i]->supply = supply[i];
+				prices[i]->Update();
 			}
 	}
 }
@@ -629,45 +1008,229 @@ void GameData::Change(const DataNode &node)
 	else if(node.Token(0) == "galaxy" && node.Size() >= 2)
 		galaxies.Get(node.Token(1))->Load(node);
 	else if(node.Token(0) == "government" && node.Size() >= 2)
+	{
 		governments.Get(node.Token(1))->Load(node);
+		politics.UpdateAttitudes();
+	}
 	else if(node.Token(0) == "outfitter" && node.Size() >= 2)
 		outfitSales.Get(node.Token(1))->Load(node, outfits);
 	else if(node.Token(0) == "planet" && node.Size() >= 2)
-		planets.Get(node.Token(1))->Load(node);
+	{
+		// A planet's systems may become inhabited or uninhabited.
+		Planet *planet = planets.Get(node.Token(1));
+		for(const System *system : planet->WormholeSystems())
+			changedSystems.emplace(system, system->Position());
+		planet->Load(node);
+	}
 	else if(node.Token(0) == "shipyard" && node.Size() >= 2)
 		shipSales.Get(node.Token(1))->Load(node, ships);
 	else if(node.Token(0) == "system" && node.Size() >= 2)
-		systems.Get(node.Token(1))->Load(node, planets);
+	{
+		System *system = systems.Get(node.Token(1));
+		changedSystems.emplace(system, system->Position());
+		system->Load(node, planets);
+	}
 	else if(node.Token(0) == "news" && node.Size() >= 2)
 		news.Get(node.Token(1))->Load(node);
-	else if(node.Token(0) == "link" && node.Size() >= 3)
-		systems.Get(node.Token(1))->Link(systems.Get(node.Token(2)));
-	else if(node.Token(0) == "unlink" && node.Size() >= 3)
-		systems.Get(node.Token(1))->Unlink(systems.Get(node.Token(2)));
+	else if((node.Token(0) == "link" || node.Token(0) == "unlink") && node.Size() >= 3)
+	{
+		System *first = systems.Get(node.Token(1));
+		System *second = systems.Get(node.Token(2));
+		changedSystems.emplace(first, first->Position());
+		changedSystems.emplace(second, second->Position());
+		if(node.Token(0) == "link")
+			first->Link(second);
+		else
+			first->Unlink(second);
+	}
 	else
+	{
 		node.PrintTrace("Invalid \"event\" data:");
+		return;
+	}
+	++revision;
+}
+
+
+
+// In debug mode, check whether any data files have been modified since they
+// were loaded, and if so, load them again. Only the objects defined in those
+// files are reset and re-read (along with ships that depend on them), rather
+// than reloading all the game data. Images are not reloaded. Returns true if
+// any files were reloaded.
+bool GameData::ReloadChangedFiles()
+{
+	// Parse each modified file, and remember every object that it used to
+	// define or now defines.
+	map<size_t, DataFile> changed;
+	set<pair<string, string>> affected;
+	for(size_t i = 0; i < watchedFiles.size(); ++i)
+	{
+		WatchedFile &file = watchedFiles[i];
+		time_t timestamp = Files::Timestamp(file.path);
+		if(timestamp == file.timestamp)
+			continue;
+		
+		file.timestamp = timestamp;
+		Files::LogError("Reloading: " + file.path);
+		const DataFile &data = changed.emplace(i, file.path).first->second;
+		affected.insert(file.definitions.begin(), file.definitions.end());
+		file.definitions = Definitions(data);
+		affected.insert(file.definitions.begin(), file.definitions.end());
+	}
+	if(changed.empty())
+		return false;
+	++revision;
+	
+	// A ship's attributes are built from its base model and its outfits, so any
+	// ship or person whose ships use a changed model or outfit must be loaded
+	// again, too.
+	set<const Outfit *> changedOutfits;
+	set<string> changedModels;
+	for(const auto &it : affected)
+	{
+		if(it.first == "outfit")
+			changedOutfits.insert(outfits.Get(it.second));
+		else if(it.first == "ship")
+			changedModels.insert(it.second);
+	}
+	auto usesChanges = [&changedOutfits, &changedModels](const Ship &ship) -> bool
+	{
+		if(changedModels.count(ship.ModelName()))
+			return true;
+		for(const auto &it : ship.Outfits())
+			if(changedOutfits.count(it.first))
+				return true;
+		return false;
+	};
+	if(!changedOutfits.empty() || !changedModels.empty())
+	{
+		for(const auto &it : ships)
+			if(usesChanges(it.second))
+				affected.emplace("ship", it.first);
+		for(const auto &it : persons)
+			for(const shared_ptr<Ship> &ship : it.second.Ships())
+				if(usesChanges(*ship))
+				{
+					affected.emplace("person", it.first);
+					break;
+				}
+	}
+	
+	// Objects that are not modified in place must be cleared, and then every
+	// definition of them must be loaded again, in the original load order.
+	set<pair<string, string>> reset;
+	for(const auto &it : affected)
+		if(ResetDefinition(it))
+			reset.insert(it);
+	
+	for(size_t i = 0; i < watchedFiles.size(); ++i)
+	{
+		const WatchedFile &file = watchedFiles[i];
+		auto cit = changed.find(i);
+		if(cit != changed.end())
+		{
+			for(const DataNode &node : cit->second)
+			{
+				// Trade data and start conditions are appended to on every
+				// load, so they cannot be reloaded without a restart.
+				if(node.Token(0) == "trade" || node.Token(0) == "start")
+					node.PrintTrace("Skipping reload (restart the game to apply this change):");
+				else
+				{
+					LoadNode(node, file.path);
+					LoadDefault(node);
+				}
+			}
+			continue;
+		}
+		
+		bool definesReset = false;
+		for(const auto &it : file.definitions)
+			definesReset |= reset.count(it);
+		if(!definesReset)
+			continue;
+		
+		DataFile data(file.path);
+		for(const DataNode &node : data)
+			if(reset.count(Definition(node)))
+				LoadNode(node, file.path);
+	}
+	
+	// Redo any processing that normally happens once everything is loaded.
+	bool systemsChanged = false;
+	bool governmentsChanged = false;
+	for(const auto &it : affected)
+	{
+		const string &key = it.first;
+		const string &name = it.second;
+		if(key == "ship")
+			ships.Get(name)->FinishLoading(true);
+		else if(key == "person")
+			persons.Get(name)->FinishLoading();
+		else if(key == "fleet")
+			*defaultFleets.Get(name) = *fleets.Get(name);
+		else if(key == "outfitter")
+			*defaultOutfitSales.Get(name) = *outfitSales.Get(name);
+		else if(key == "shipyard")
+			*defaultShipSales.Get(name) = *shipSales.Get(name);
+		else if(key == "system" || key == "planet")
+			systemsChanged = true;
+		else if(key == "government")
+			governmentsChanged = true;
+	}
+	if(systemsChanged)
+	{
+		allSystemsChanged = true;
+		UpdateSystems();
+	}
+	if(governmentsChanged)
+		politics.UpdateAttitudes();
+	
+	return true;
 }
 
 
 
 // Update the neighbor lists and other information for all the systems.
-// This must be done any time that a change creates or moves a system.
+// This must be done any time that a change creates or moves a system. If
+// only a few systems have changed since the last update, only the systems
+// near enough to them to have gained or lost them as neighbors are updated.
 void GameData::UpdateSystems()
 {
+	double maxDistance = neighborDistances.empty() ? 0. : *neighborDistances.rbegin();
+	for(const auto &it : systems)
+		maxDistance = max(maxDistance, it.second.JumpRange());
+	const SystemGrid grid(systems, maxDistance);
+	
+	set<const System *> affected;
+	if(!allSystemsChanged)
+		for(const auto &it : changedSystems)
+		{
+			affected.insert(it.first);
+			for(const Point &position : {it.second, it.first->Position()})
+				for(const System *system : grid.Near(position, maxDistance))
+					affected.insert(system);
+		}
+	
 	for(auto &it : systems)
 	{
 		// Skip systems that have no name.
 		if(it.first.empty() || it.second.Name().empty())
 			continue;
-		it.second.UpdateSystem(systems, neighborDistances);
+		if(allSystemsChanged || affected.count(&it.second))
+			it.second.UpdateSystem(grid, neighborDistances);
 	}
+	changedSystems.clear();
+	allSystemsChanged = false;
 }
 
 
 
 void GameData::AddJumpRange(double neighborDistance)
 {
-	neighborDistances.insert(neighborDistance);
+	if(neighborDistances.insert(neighborDistance).second)
+		allSystemsChanged = true;
 }
 
 
@@ -1046,149 +1609,162 @@ void GameData::LoadFile(const string &path, bool debugMode)
 	if(path.length() < 4 || path.compare(path.length() - 4, 4, ".txt"))
 		return;
 	
+	FrameTimer timer;
 	DataFile data(path);
 	if(debugMode)
 		Files::LogError("Parsing: " + path);
+	Profiler::Add("parse data files", path, timer.Time());
+	if(watchDataFiles)
+		watchedFiles.push_back(WatchedFile{path, Files::Timestamp(path), Definitions(data)});
+	
+	timer = FrameTimer();
 	
 	for(const DataNode &node : data)
+		LoadNode(node, path);
+	Profiler::Add("interpret data files", path, timer.Time());
+}
+
+
+
+// Load one root node of a data file.
+void GameData::LoadNode(const DataNode &node, const string &path)
+{
+	const string &key = node.Token(0);
+	if(key == "color" && node.Size() >= 6)
+		colors.Get(node.Token(1))->Load(
+			node.Value(2), node.Value(3), node.Value(4), node.Value(5));
+	else if(key == "conversation" && node.Size() >= 2)
+		conversations.Get(node.Token(1))->Load(node);
+	else if(key == "effect" && node.Size() >= 2)
+		effects.Get(node.Token(1))->Load(node);
+	else if(key == "event" && node.Size() >= 2)
+		events.Get(node.Token(1))->Load(node);
+	else if(key == "fleet" && node.Size() >= 2)
+		fleets.Get(node.Token(1))->Load(node);
+	else if(key == "galaxy" && node.Size() >= 2)
+		galaxies.Get(node.Token(1))->Load(node);
+	else if(key == "government" && node.Size() >= 2)
+		governments.Get(node.Token(1))->Load(node);
+	else if(key == "hazard" && node.Size() >= 2)
+		hazards.Get(node.Token(1))->Load(node);
+	else if(key == "interface" && node.Size() >= 2)
+		interfaces.Get(node.Token(1))->Load(node);
+	else if(key == "minable" && node.Size() >= 2)
+		minables.Get(node.Token(1))->Load(node);
+	else if(key == "mission" && node.Size() >= 2)
+		missions.Get(node.Token(1))->Load(node);
+	else if(key == "outfit" && node.Size() >= 2)
+		outfits.Get(node.Token(1))->Load(node);
+	else if(key == "outfitter" && node.Size() >= 2)
+		outfitSales.Get(node.Token(1))->Load(node, outfits);
+	else if(key == "person" && node.Size() >= 2)
+		persons.Get(node.Token(1))->Load(node);
+	else if(key == "phrase" && node.Size() >= 2)
+		phrases.Get(node.Token(1))->Load(node);
+	else if(key == "planet" && node.Size() >= 2)
+		planets.Get(node.Token(1))->Load(node);
+	else if(key == "ship" && node.Size() >= 2)
 	{
-		const string &key = node.Token(0);
-		if(key == "color" && node.Size() >= 6)
-			colors.Get(node.Token(1))->Load(
-				node.Value(2), node.Value(3), node.Value(4), node.Value(5));
-		else if(key == "conversation" && node.Size() >= 2)
-			conversations.Get(node.Token(1))->Load(node);
-		else if(key == "effect" && node.Size() >= 2)
-			effects.Get(node.Token(1))->Load(node);
-		else if(key == "event" && node.Size() >= 2)
-			events.Get(node.Token(1))->Load(node);
-		else if(key == "fleet" && node.Size() >= 2)
-			fleets.Get(node.Token(1))->Load(node);
-		else if(key == "galaxy" && node.Size() >= 2)
-			galaxies.Get(node.Token(1))->Load(node);
-		else if(key == "government" && node.Size() >= 2)
-			governments.Get(node.Token(1))->Load(node);
-		else if(key == "hazard" && node.Size() >= 2)
-			hazards.Get(node.Token(1))->Load(node);
-		else if(key == "interface" && node.Size() >= 2)
-			interfaces.Get(node.Token(1))->Load(node);
-		else if(key == "minable" && node.Size() >= 2)
-			minables.Get(node.Token(1))->Load(node);
-		else if(key == "mission" && node.Size() >= 2)
-			missions.Get(node.Token(1))->Load(node);
-		else if(key == "outfit" && node.Size() >= 2)
-			outfits.Get(node.Token(1))->Load(node);
-		else if(key == "outfitter" && node.Size() >= 2)
-			outfitSales.Get(node.Token(1))->Load(node, outfits);
-		else if(key == "person" && node.Size() >= 2)
-			persons.Get(node.Token(1))->Load(node);
-		else if(key == "phrase" && node.Size() >= 2)
-			phrases.Get(node.Token(1))->Load(node);
-		else if(key == "planet" && node.Size() >= 2)
-			planets.Get(node.Token(1))->Load(node);
-		else if(key == "ship" && node.Size() >= 2)
-		{
-			// Allow multiple named variants of the same ship model.
-			const string &name = node.Token((node.Size() > 2) ? 2 : 1);
-			ships.Get(name)->Load(node);
-		}
-		else if(key == "shipyard" && node.Size() >= 2)
-			shipSales.Get(node.Token(1))->Load(node, ships);
-		else if(key == "start" && node.HasChildren())
+		// Allow multiple named variants of the same ship model.
+		const string &name = node.Token((node.Size() > 2) ? 2 : 1);
+		ships.Get(name)->Load(node);
+	}
+	else if(key == "shipyard" && node.Size() >= 2)
+		shipSales.Get(node.Token(1))->Load(node, ships);
+	else if(key == "start" && node.HasChildren())
+	{
+		// This node may either declare an immutable starting scenario, or one that is open to extension
+		// by other nodes (e.g. plugins may customize the basic start, rather than provide a unique start).
+		if(node.Size() == 1)
+			startConditions.emplace_back(node);
+		else
 		{
-			// This node may either declare an immutable starting scenario, or one that is open to extension
-			// by other nodes (e.g. plugins may customize the basic start, rather than provide a unique start).
-			if(node.Size() == 1)
-				startConditions.emplace_back(node);
+			const string &identifier = node.Token(1);
+			auto existingStart = find_if(startConditions.begin(), startConditions.end(),
+				[&identifier](const StartConditions &it) noexcept -> bool { return it.Identifier() == identifier; });
+			if(existingStart != startConditions.end())
+				existingStart->Load(node);
 			else
-			{
-				const string &identifier = node.Token(1);
-				auto existingStart = find_if(startConditions.begin(), startConditions.end(),
-					[&identifier](const StartConditions &it) noexcept -> bool { return it.Identifier() == identifier; });
-				if(existingStart != startConditions.end())
-					existingStart->Load(node);
-				else
-					startConditions.emplace_back(node);
-			}
-		}
-		else if(key == "system" && node.Size() >= 2)
-			systems.Get(node.Token(1))->Load(node, planets);
-		else if((key == "test") && node.Size() >= 2)
-			tests.Get(node.Token(1))->Load(node);
-		else if((key == "test-data") && node.Size() >= 2)
-			testDataSets.Get(node.Token(1))->Load(node, path);
-		else if(key == "trade")
-			trade.Load(node);
-		else if(key == "landing message" && node.Size() >= 2)
-		{
-			for(const DataNode &child : node)
-				landingMessages[SpriteSet::Get(child.Token(0))] = node.Token(1);
+				startConditions.emplace_back(node);
 		}
-		else if(key == "star" && node.Size() >= 2)
+	}
+	else if(key == "system" && node.Size() >= 2)
+		systems.Get(node.Token(1))->Load(node, planets);
+	else if((key == "test") && node.Size() >= 2)
+		tests.Get(node.Token(1))->Load(node);
+	else if((key == "test-data") && node.Size() >= 2)
+		testDataSets.Get(node.Token(1))->Load(node, path);
+	else if(key == "trade")
+		trade.Load(node);
+	else if(key == "landing message" && node.Size() >= 2)
+	{
+		for(const DataNode &child : node)
+			landingMessages[SpriteSet::Get(child.Token(0))] = node.Token(1);
+	}
+	else if(key == "star" && node.Size() >= 2)
+	{
+		const Sprite *sprite = SpriteSet::Get(node.Token(1));
+		for(const DataNode &child : node)
 		{
-			const Sprite *sprite = SpriteSet::Get(node.Token(1));
-			for(const DataNode &child : node)
-			{
-				if(child.Token(0) == "power" && child.Size() >= 2)
-					solarPower[sprite] = child.Value(1);
-				else if(child.Token(0) == "wind" && child.Size() >= 2)
-					solarWind[sprite] = child.Value(1);
-				else
-					child.PrintTrace("Unrecognized star attribute:");
-			}
+			if(child.Token(0) == "power" && child.Size() >= 2)
+				solarPower[sprite] = child.Value(1);
+			else if(child.Token(0) == "wind" && child.Size() >= 2)
+				solarWind[sprite] = child.Value(1);
+			else
+				child.PrintTrace("Unrecognized star attribute:");
 		}
-		else if(key == "news" && node.Size() >= 2)
-			news.Get(node.Token(1))->Load(node);
-		else if(key == "rating" && node.Size() >= 2)
+	}
+	else if(key == "news" && node.Size() >= 2)
+		news.Get(node.Token(1))->Load(node);
+	else if(key == "rating" && node.Size() >= 2)
+	{
+		vector<string> &list = ratings[node.Token(1)];
+		list.clear();
+		for(const DataNode &child : node)
+			list.push_back(child.Token(0));
+	}
+	else if(key == "category" && node.Size() >= 2)
+	{
+		static const map<string, CategoryType> category = {
+			{"ship", CategoryType::SHIP},
+			{"bay type", CategoryType::BAY},
+			{"outfit", CategoryType::OUTFIT}
+		};
+		auto it = category.find(node.Token(1));
+		if(it == category.end())
 		{
-			vector<string> &list = ratings[node.Token(1)];
-			list.clear();
-			for(const DataNode &child : node)
-				list.push_back(child.Token(0));
+			node.PrintTrace("Skipping unrecognized category:");
+			return;
 		}
-		else if(key == "category" && node.Size() >= 2)
+		
+		vector<string> &categoryList = categories[it->second];
+		for(const DataNode &child : node)
 		{
-			static const map<string, CategoryType> category = {
-				{"ship", CategoryType::SHIP},
-				{"bay type", CategoryType::BAY},
-				{"outfit", CategoryType::OUTFIT}
-			};
-			auto it = category.find(node.Token(1));
-			if(it == category.end())
-			{
-				node.PrintTrace("Skipping unrecognized category:");
-				continue;
-			}
-			
-			vector<string> &categoryList = categories[it->second];
-			for(const DataNode &child : node)
-			{
-				// If a given category already exists, it will be
-				// moved to the back of the list.
-				const auto it = find(categoryList.begin(), categoryList.end(), child.Token(0));
-				if(it != categoryList.end())
-					categoryList.erase(it);
-				categoryList.push_back(child.Token(0));
-			}
+			// If a given category already exists, it will be
+			// moved to the back of the list.
+			const auto it = find(categoryList.begin(), categoryList.end(), child.Token(0));
+			if(it != categoryList.end())
+				categoryList.erase(it);
+			categoryList.push_back(child.Token(0));
 		}
-		else if((key == "tip" || key == "help") && node.Size() >= 2)
+	}
+	else if((key == "tip" || key == "help") && node.Size() >= 2)
+	{
+		string &text = (key == "tip" ? tooltips : helpMessages)[node.Token(1)];
+		text.clear();
+		for(const DataNode &child : node)
 		{
-			string &text = (key == "tip" ? tooltips : helpMessages)[node.Token(1)];
-			text.clear();
-			for(const DataNode &child : node)
+			if(!text.empty())
 			{
-				if(!text.empty())
-				{
-					text += '\n';
-					if(child.Token(0)[0] != '\t')
-						text += '\t';
-				}
-				text += child.Token(0);
+				text += '\n';
+				if(child.Token(0)[0] != '\t')
+					text += '\t';
 			}
+			text += child.Token(0);
 		}
-		else
-			node.PrintTrace("Skipping unrecognized root object:");
 	}
+	else
+		node.PrintTrace("Skipping unrecognized root object:");
 }
 
 
@@ -18,6 +18,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Set.h"
 #include "Trade.h"
 
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
@@ -65,21 +66,38 @@ public:
 	static bool BeginLoad(const char * const *argv);
 	// Check for objects that are referred to but never defined.
 	static void CheckReferences();
-	static void LoadShaders(bool useShaderSwizzle);
+	// Check that every ship's cached stats match its attributes, including
+	// after outfits are added and removed. Returns the number of mismatches.
+	static int CheckShipStats();
+	static void LoadShaders(bool useShaderSwizzle, bool useInstancing);
 	// TODO: make Progress() a simple accessor.
 	static double Progress();
 	// Whether initial game loading is complete (sprites and audio are loaded).
 	static bool IsLoaded();
-	// Begin loading a sprite that was previously deferred. Currently this is
-	// done with all landscapes to speed up the program's startup.
+	// Whether enough sprites are loaded to use the main menu. The others continue
+	// loading in the background, and the game cannot be entered until they are.
+	static bool IsReady();
+	// Load the given sprite ahead of all the sprites of normal priority.
+	static void Prioritize(const Sprite *sprite);
+	// Make sure that the given sprite is loaded if it is one that may have been
+	// unloaded, or that is only loaded when needed (e.g. landscapes).
 	static void Preload(const Sprite *sprite);
+	// Upload any sprites that have been read since the last frame, load any that
+	// were drawn after being unloaded, and unload the least recently drawn ones
+	// if they take up more than the texture budget.
+	static void UpdateSprites();
 	static void FinishLoading();
+	// In debug mode, load any data files that have changed since they were
+	// last loaded. Returns true if anything was reloaded.
+	static bool ReloadChangedFiles();
 	
 	// Get the list of resource sources (i.e. plugin folders).
 	static const std::vector<std::string> &Sources();
 	
 	// Revert any changes that have been made to the universe.
 	static void Revert();
+	// Get a number that changes whenever the universe is changed or reverted.
+	static uint64_t Revision();
 	static void SetDate(const Date &date);
 	// Functions for the dynamic economy.
 	static void ReadEconomy(const DataNode &node);
@@ -154,6 +172,7 @@ public:
 private:
 	static void LoadSources();
 	static void LoadFile(const std::string &path, bool debugMode);
+	static void LoadNode(const DataNode &node, const std::string &path);
 	static std::map<std::string, std::shared_ptr<ImageSet>> FindImages();
 	
 	static void PrintShipTable();
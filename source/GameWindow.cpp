@@ -14,6 +14,8 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "Files.h"
 #include "ImageBuffer.h"
+#include "OpenGLBackend.h"
+#include "RenderCommands.h"
 #include "Screen.h"
 
 #include "gl_header.h"
@@ -31,7 +33,10 @@ namespace {
 	int width = 0;
 	int height = 0;
 	bool hasSwizzle = false;
+	bool hasInstancing = false;
 	bool supportsAdaptiveVSync = false;
+	// All drawing is recorded, and then carried out by this backend.
+	OpenGLBackend openGL;
 	
 	// Logs SDL errors and returns true if found
 	bool checkSDLerror()
@@ -193,6 +198,9 @@ bool GameWindow::Init()
 		return false;
 	}
 	
+	// Now that there is a context, carry out all drawing with OpenGL.
+	RenderCommands::SetBackend(&openGL);
+	
 	// OpenGL settings
 	glClearColor(0.f, 0.f, 0.0f, 1.f);
 	glEnable(GL_BLEND);
@@ -202,6 +210,12 @@ bool GameWindow::Init()
 	// Check for support of various graphical features.
 	hasSwizzle = HasOpenGLExtension("_texture_swizzle");
 	supportsAdaptiveVSync = HasOpenGLExtension("_swap_control_tear");
+	// Instanced vertex attributes are a core feature as of OpenGL 3.3.
+	GLint majorVersion = 0;
+	GLint minorVersion = 0;
+	glGetIntegerv(GL_MAJOR_VERSION, &majorVersion);
+	glGetIntegerv(GL_MINOR_VERSION, &minorVersion);
+	hasInstancing = (majorVersion > 3 || (majorVersion == 3 && minorVersion >= 3));
 	
 	// Enable the user's preferred VSync state, otherwise update to an available
 	// value (e.g. if an external program is forcing a particular VSync state).
@@ -233,7 +247,11 @@ void GameWindow::Quit()
 //#ifndef _WIN32
 	// Under windows, this cleanup code causes intermittent crashes.
 	if(context)
+	{
+		// Stop drawing with OpenGL before its context is gone.
+		RenderCommands::SetBackend(nullptr);
 		SDL_GL_DeleteContext(context);
+	}
 //#endif
 
 	if(mainWindow)
@@ -246,6 +264,8 @@ void GameWindow::Quit()
 
 void GameWindow::Step()
 {
+	// Carry out everything that was drawn this frame before showing it.
+	RenderCommands::Execute();
 	SDL_GL_SwapWindow(mainWindow);
 }
 
@@ -403,6 +423,13 @@ bool GameWindow::HasSwizzle()
 
 
 
+bool GameWindow::HasInstancing()
+{
+	return hasInstancing;
+}
+
+
+
 void GameWindow::ExitWithError(const string& message, bool doPopUp)
 {
 	// Print the error message in the terminal and the error file.
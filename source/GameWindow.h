@@ -46,6 +46,9 @@ public:
 	
 	// Check if the initialized window system supports OpenGL texture_swizzle.
 	static bool HasSwizzle();
+	// Check if it supports drawing many copies of a sprite in one draw call,
+	// with attributes that vary per copy rather than per vertex.
+	static bool HasInstancing();
 	
 	// Print the error message in the terminal, error file, and message box.
 	// Checks for video system errors and records those as well.
@@ -163,6 +163,15 @@ const string &Government::GetTrueName() const
 
 
 
+// Get the number that identifies this government. The numbers are small
+// enough to be used as indices into a table of all the governments.
+unsigned Government::GetId() const
+{
+	return id;
+}
+
+
+
 // Get the color swizzle to use for ships of this government.
 int Government::GetSwizzle() const
 {
@@ -50,6 +50,9 @@ public:
 	// Set / Get the name used for this government in the data files.
 	void SetName(const std::string &trueName);
 	const std::string &GetTrueName() const;
+	// Get the number that identifies this government. The numbers are small
+	// enough to be used as indices into a table of all the governments.
+	unsigned GetId() const;
 	// Get the color swizzle to use for ships of this government.
 	int GetSwizzle() const;
 	// Get the color to use for displaying this government on the map.
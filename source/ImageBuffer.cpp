@@ -22,12 +22,17 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include <stdexcept>
 #include <vector>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 using namespace std;
 
 namespace {
 	bool ReadPNG(const string &path, ImageBuffer &buffer, int frame);
 	bool ReadJPG(const string &path, ImageBuffer &buffer, int frame);
-	void Premultiply(ImageBuffer &buffer, int frame, int additive);
+	void PremultiplyRow(uint32_t *it, uint32_t *end, int additive);
+	void ShrinkRow(const uint32_t *aIt, const uint32_t *bIt, uint32_t *out, uint32_t *end);
 }
 
 
@@ -126,20 +131,11 @@ void ImageBuffer::ShrinkToHalfSize()
 	ImageBuffer result(frames);
 	result.Allocate(width / 2, height / 2);
 	
-	unsigned char *begin = reinterpret_cast<unsigned char *>(pixels);
-	unsigned char *out = reinterpret_cast<unsigned char *>(result.pixels);
 	// Loop through every line of every frame of the buffer.
 	for(int y = 0; y < result.height * frames; ++y)
 	{
-		unsigned char *aIt = begin + (4 * width) * (2 * y);
-		unsigned char *aEnd = aIt + 4 * 2 * result.width;
-		unsigned char *bIt = begin + (4 * width) * (2 * y + 1);
-		for( ; aIt != aEnd; aIt += 4, bIt += 4)
-		{
-			for(int channel = 0; channel < 4; ++channel, ++aIt, ++bIt, ++out)
-				*out = (static_cast<unsigned>(aIt[0]) + static_cast<unsigned>(bIt[0])
-					+ static_cast<unsigned>(aIt[4]) + static_cast<unsigned>(bIt[4]) + 2) / 4;
-		}
+		uint32_t *out = result.pixels + result.width * y;
+		ShrinkRow(pixels + width * (2 * y), pixels + width * (2 * y + 1), out, out + result.width);
 	}
 	swap(width, result.width);
 	swap(height, result.height);
@@ -179,13 +175,27 @@ bool ImageBuffer::Read(const string &path, int frame)
 	{
 		int additive = (path[pos] == '+') ? 2 : (path[pos] == '~') ? 1 : 0;
 		if(isPNG || (isJPG && additive == 2))
-			Premultiply(*this, frame, additive);
+			Premultiply(frame, additive);
 	}
 	return true;
 }
 
 
 
+// Convert the given frame to premultiplied alpha. If additive is 1, the
+// alpha channel is also reduced to one quarter (half-additive blending); if
+// it is 2, the alpha channel is cleared (additive blending).
+void ImageBuffer::Premultiply(int frame, int additive)
+{
+	for(int y = 0; y < height; ++y)
+	{
+		uint32_t *it = Begin(y, frame);
+		PremultiplyRow(it, it + width, additive);
+	}
+}
+
+
+
 namespace {
 	bool ReadPNG(const string &path, ImageBuffer &buffer, int frame)
 	{
@@ -324,29 +334,111 @@ namespace {
 	
 	
 	
-	void Premultiply(ImageBuffer &buffer, int frame, int additive)
+#ifdef __SSE2__
+	// Get a copy of the given pixels, with each channel expanded to 16 bits
+	// and replaced by that pixel's alpha value.
+	inline __m128i Alpha(__m128i channels)
+	{
+		return _mm_shufflehi_epi16(_mm_shufflelo_epi16(channels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+	}
+	
+	
+	
+	// Divide each 16-bit value by 255, rounding down. This is exact for any
+	// product of two 8-bit values.
+	inline __m128i DivideBy255(__m128i value)
+	{
+		__m128i sum = _mm_add_epi16(_mm_add_epi16(value, _mm_set1_epi16(1)), _mm_srli_epi16(value, 8));
+		return _mm_srli_epi16(sum, 8);
+	}
+	
+	
+	
+	// Add together each channel of four pixels from each of two rows, giving
+	// the 16-bit sums for two 2x2 blocks.
+	inline __m128i SumBlocks(__m128i a, __m128i b)
 	{
-		for(int y = 0; y < buffer.Height(); ++y)
+		const __m128i zero = _mm_setzero_si128();
+		__m128i left = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+		__m128i right = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+		return _mm_add_epi16(_mm_unpacklo_epi64(left, right), _mm_unpackhi_epi64(left, right));
+	}
+#endif
+	
+	
+	
+	void PremultiplyRow(uint32_t *it, uint32_t *end, int additive)
+	{
+#ifdef __SSE2__
+		// Convert four pixels at a time. Each color channel is multiplied by
+		// alpha using 16-bit arithmetic, which gives exactly the same results
+		// as the code for single pixels below.
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i colorMask = _mm_set1_epi32(0x00FFFFFF);
+		for( ; end - it >= 4; it += 4)
 		{
-			uint32_t *it = buffer.Begin(y, frame);
+			__m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i *>(it));
+			__m128i low = _mm_unpacklo_epi8(value, zero);
+			__m128i high = _mm_unpackhi_epi8(value, zero);
+			low = DivideBy255(_mm_mullo_epi16(low, Alpha(low)));
+			high = DivideBy255(_mm_mullo_epi16(high, Alpha(high)));
+			__m128i result = _mm_and_si128(_mm_packus_epi16(low, high), colorMask);
+			
+			if(additive == 1)
+				result = _mm_or_si128(result, _mm_slli_epi32(_mm_srli_epi32(value, 26), 24));
+			else if(additive != 2)
+				result = _mm_or_si128(result, _mm_andnot_si128(colorMask, value));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(it), result);
+		}
+#endif
+		for( ; it != end; ++it)
+		{
+			uint64_t value = *it;
+			uint64_t alpha = (value & 0xFF000000) >> 24;
+			
+			uint64_t red = (((value & 0xFF0000) * alpha) / 255) & 0xFF0000;
+			uint64_t green = (((value & 0xFF00) * alpha) / 255) & 0xFF00;
+			uint64_t blue = (((value & 0xFF) * alpha) / 255) & 0xFF;
+			
+			value = red | green | blue;
+			if(additive == 1)
+				alpha >>= 2;
+			if(additive != 2)
+				value |= (alpha << 24);
 			
-			for(uint32_t *end = it + buffer.Width(); it != end; ++it)
-			{
-				uint64_t value = *it;
-				uint64_t alpha = (value & 0xFF000000) >> 24;
-				
-				uint64_t red = (((value & 0xFF0000) * alpha) / 255) & 0xFF0000;
-				uint64_t green = (((value & 0xFF00) * alpha) / 255) & 0xFF00;
-				uint64_t blue = (((value & 0xFF) * alpha) / 255) & 0xFF;
-				
-				value = red | green | blue;
-				if(additive == 1)
-					alpha >>= 2;
-				if(additive != 2)
-					value |= (alpha << 24);
-				
-				*it = static_cast<uint32_t>(value);
-			}
+			*it = static_cast<uint32_t>(value);
+		}
+	}
+	
+	
+	
+	// Average each 2x2 block of pixels in the given pair of rows, filling the
+	// given output row.
+	void ShrinkRow(const uint32_t *aIt, const uint32_t *bIt, uint32_t *out, uint32_t *end)
+	{
+#ifdef __SSE2__
+		// Produce four pixels at a time.
+		const __m128i two = _mm_set1_epi16(2);
+		for( ; end - out >= 4; aIt += 8, bIt += 8, out += 4)
+		{
+			__m128i first = SumBlocks(_mm_loadu_si128(reinterpret_cast<const __m128i *>(aIt)),
+				_mm_loadu_si128(reinterpret_cast<const __m128i *>(bIt)));
+			__m128i second = SumBlocks(_mm_loadu_si128(reinterpret_cast<const __m128i *>(aIt + 4)),
+				_mm_loadu_si128(reinterpret_cast<const __m128i *>(bIt + 4)));
+			first = _mm_srli_epi16(_mm_add_epi16(first, two), 2);
+			second = _mm_srli_epi16(_mm_add_epi16(second, two), 2);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_packus_epi16(first, second));
+		}
+#endif
+		const unsigned char *a = reinterpret_cast<const unsigned char *>(aIt);
+		const unsigned char *b = reinterpret_cast<const unsigned char *>(bIt);
+		unsigned char *it = reinterpret_cast<unsigned char *>(out);
+		unsigned char *itEnd = reinterpret_cast<unsigned char *>(end);
+		for( ; it != itEnd; a += 4, b += 4)
+		{
+			for(int channel = 0; channel < 4; ++channel, ++a, ++b, ++it)
+				*it = (static_cast<unsigned>(a[0]) + static_cast<unsigned>(b[0])
+					+ static_cast<unsigned>(a[4]) + static_cast<unsigned>(b[4]) + 2) / 4;
 		}
 	}
 }
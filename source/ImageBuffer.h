@@ -50,6 +50,10 @@ public:
 	uint32_t *Begin(int y, int frame = 0);
 	
 	void ShrinkToHalfSize();
+	// Convert the given frame to premultiplied alpha. If additive is 1, the
+	// alpha channel is also reduced to one quarter (half-additive blending); if
+	// it is 2, the alpha channel is cleared (additive blending).
+	void Premultiply(int frame, int additive = 0);
 	
 	// Read a single frame. Return false if an error is encountered - either the
 	// image is the wrong size, or it is not a supported image format.
@@ -0,0 +1,270 @@
+/* ImageCache.cpp
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "ImageCache.h"
+
+#include "File.h"
+#include "Files.h"
+#include "ImageBuffer.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace std;
+
+namespace {
+	// Change this whenever the format of the cached files or the way that the
+	// images are converted changes, so that older cached files are ignored.
+	const uint32_t VERSION = 1;
+	const char MAGIC[4] = {'E', 'S', 'I', 'C'};
+	
+	bool enabled = false;
+	string directory;
+	
+	// Each cached file begins with this header, followed by the path to the
+	// source image and then the compressed pixels.
+	class Header {
+	public:
+		char magic[4];
+		uint32_t version;
+		uint64_t sourceSize;
+		int64_t timestamp;
+		uint32_t width;
+		uint32_t height;
+		uint32_t pathLength;
+	};
+	
+	
+	// Get the path of the cached copy of the given source image. The name is a
+	// hash of the source path; the full path is stored in the file, too, in
+	// case two paths have the same hash.
+	string CachePath(const string &path)
+	{
+		// 64-bit FNV-1a hash.
+		uint64_t hash = 14695981039346656037ull;
+		for(char c : path)
+		{
+			hash ^= static_cast<unsigned char>(c);
+			hash *= 1099511628211ull;
+		}
+		char name[17];
+		snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(hash));
+		return directory + name;
+	}
+	
+	
+	// Check if the given cached data begins with a valid header for the current
+	// version of the given source image. If so, return the header.
+	bool CheckHeader(const string &data, const string &path, Header &header)
+	{
+		if(data.size() < sizeof(Header))
+			return false;
+		memcpy(&header, data.data(), sizeof(Header));
+		if(memcmp(header.magic, MAGIC, sizeof(MAGIC)) || header.version != VERSION)
+			return false;
+		if(data.size() < sizeof(Header) + header.pathLength)
+			return false;
+		
+		// If no path is given (e.g. when pruning the cache), any source image
+		// is accepted as long as it has not changed.
+		string source = data.substr(sizeof(Header), header.pathLength);
+		if(source.empty() || (!path.empty() && source != path))
+			return false;
+		return (header.sourceSize == Files::Size(source)
+			&& header.timestamp == static_cast<int64_t>(Files::Timestamp(source)));
+	}
+	
+	
+	// Compress the given pixels as a series of runs, each of which consists of
+	// a number of transparent pixels, a number of other pixels, and the values
+	// of those other pixels. Single transparent pixels are included in the
+	// other pixels, rather than starting a new run.
+	void Compress(const uint32_t *it, const uint32_t *end, vector<uint32_t> &out)
+	{
+		while(it != end)
+		{
+			const uint32_t *start = it;
+			while(it != end && !*it)
+				++it;
+			out.push_back(it - start);
+			
+			start = it;
+			while(it != end && (*it || (it + 1 != end && it[1])))
+				++it;
+			out.push_back(it - start);
+			out.insert(out.end(), start, it);
+		}
+	}
+	
+	
+	// Expand the compressed pixels into the given buffer. Returns false if the
+	// data does not exactly fill the buffer.
+	bool Decompress(const uint32_t *in, const uint32_t *inEnd, uint32_t *out, uint32_t *outEnd)
+	{
+		while(in != inEnd)
+		{
+			if(inEnd - in < 2)
+				return false;
+			uint32_t transparent = *in++;
+			uint32_t count = *in++;
+			if(static_cast<size_t>(outEnd - out) < static_cast<size_t>(transparent) + count
+					|| static_cast<size_t>(inEnd - in) < count)
+				return false;
+			
+			memset(out, 0, transparent * sizeof(uint32_t));
+			out += transparent;
+			memcpy(out, in, count * sizeof(uint32_t));
+			out += count;
+			in += count;
+		}
+		return (out == outEnd);
+	}
+}
+
+
+
+// Begin caching images in the given directory, creating it if necessary.
+void ImageCache::Init(const string &directory)
+{
+	::directory = directory;
+	if(::directory.back() != '/')
+		::directory += '/';
+	Files::CreateFolder(::directory);
+	enabled = Files::Exists(::directory);
+	if(!enabled)
+		Files::LogError("Unable to create the image cache directory \"" + ::directory + "\".");
+}
+
+
+
+bool ImageCache::IsEnabled()
+{
+	return enabled;
+}
+
+
+
+// Read the given frame from the cached copy of the given image. Returns
+// false if there is no valid cached copy of it.
+bool ImageCache::Read(const string &path, ImageBuffer &buffer, int frame)
+{
+	if(!enabled)
+		return false;
+	
+	string cachePath = CachePath(path);
+	if(!Files::Exists(cachePath))
+		return false;
+	
+	string data = Files::Read(cachePath);
+	Header header;
+	if(!CheckHeader(data, path, header) || !header.width || !header.height)
+		return false;
+	
+	// Allocate the buffer if this is the first frame to be read, and make sure
+	// that this frame has the same dimensions as any others.
+	buffer.Allocate(header.width, header.height);
+	if(static_cast<int>(header.width) != buffer.Width() || static_cast<int>(header.height) != buffer.Height())
+		return false;
+	
+	// Copy the compressed pixels, to make sure they are correctly aligned.
+	size_t start = sizeof(Header) + header.pathLength;
+	vector<uint32_t> pixels((data.size() - start) / sizeof(uint32_t));
+	memcpy(pixels.data(), data.data() + start, pixels.size() * sizeof(uint32_t));
+	
+	uint32_t *out = buffer.Begin(0, frame);
+	return Decompress(pixels.data(), pixels.data() + pixels.size(), out, out + buffer.Width() * buffer.Height());
+}
+
+
+
+// Store the given frame (which must already have been converted) as the
+// cached copy of the given image.
+void ImageCache::Write(const string &path, const ImageBuffer &buffer, int frame)
+{
+	if(!enabled || !buffer.Pixels())
+		return;
+	
+	Header header;
+	memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version = VERSION;
+	header.sourceSize = Files::Size(path);
+	header.timestamp = Files::Timestamp(path);
+	header.width = buffer.Width();
+	header.height = buffer.Height();
+	header.pathLength = path.size();
+	
+	vector<uint32_t> pixels;
+	const uint32_t *begin = buffer.Begin(0, frame);
+	Compress(begin, begin + buffer.Width() * buffer.Height(), pixels);
+	
+	// Write to a temporary file first, so that a partially written file is
+	// never mistaken for a valid one.
+	string cachePath = CachePath(path);
+	string partPath = cachePath + ".part";
+	FILE *out = Files::Open(partPath, true, true);
+	if(!out)
+		return;
+	bool success = (fwrite(&header, sizeof(Header), 1, out) == 1);
+	success &= (fwrite(path.data(), 1, path.size(), out) == path.size());
+	success &= (fwrite(pixels.data(), sizeof(uint32_t), pixels.size(), out) == pixels.size());
+	success &= !fclose(out);
+	if(success)
+		Files::Move(partPath, cachePath);
+	else
+		Files::Delete(partPath);
+}
+
+
+
+// Remove any cached images whose source image has changed or no longer
+// exists. Returns the number of files that were removed.
+int ImageCache::Prune()
+{
+	if(!enabled)
+		return 0;
+	
+	int removed = 0;
+	for(const string &cachePath : Files::List(directory))
+	{
+		// Only the header and the source path are needed to check the file.
+		string data;
+		{
+			File file(cachePath);
+			if(file)
+			{
+				data.resize(sizeof(Header) + 4096);
+				data.resize(fread(&data[0], 1, data.size(), file));
+			}
+		}
+		Header header;
+		if(!CheckHeader(data, string(), header))
+		{
+			Files::Delete(cachePath);
+			++removed;
+		}
+	}
+	return removed;
+}
+
+
+
+// Remove all the cached images.
+void ImageCache::Clear()
+{
+	if(!enabled)
+		return;
+	
+	for(const string &cachePath : Files::List(directory))
+		Files::Delete(cachePath);
+}
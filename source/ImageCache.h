@@ -0,0 +1,50 @@
+/* ImageCache.h
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef IMAGE_CACHE_H_
+#define IMAGE_CACHE_H_
+
+#include <string>
+
+class ImageBuffer;
+
+
+
+// Class for storing the pixels of each image after it has been decoded and
+// converted to premultiplied alpha, so that the next time the game starts the
+// PNG and JPEG files do not need to be decoded again. Each source image is
+// cached in its own file, which is only used if the source image still has the
+// same size and modification time. Runs of transparent pixels are compressed.
+// Once Init() has been called, this class can be used from multiple threads.
+class ImageCache {
+public:
+	// Begin caching images in the given directory, creating it if necessary.
+	static void Init(const std::string &directory);
+	static bool IsEnabled();
+	
+	// Read the given frame from the cached copy of the given image. Returns
+	// false if there is no valid cached copy of it.
+	static bool Read(const std::string &path, ImageBuffer &buffer, int frame);
+	// Store the given frame (which must already have been converted) as the
+	// cached copy of the given image.
+	static void Write(const std::string &path, const ImageBuffer &buffer, int frame);
+	
+	// Remove any cached images whose source image has changed or no longer
+	// exists. Returns the number of files that were removed.
+	static int Prune();
+	// Remove all the cached images.
+	static void Clear();
+};
+
+
+
+#endif
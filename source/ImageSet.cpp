@@ -13,7 +13,12 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "ImageSet.h"
 
 #include "Files.h"
+#include "FrameTimer.h"
+#include "ImageBuffer.h"
+#include "ImageCache.h"
 #include "Mask.h"
+#include "MaskCache.h"
+#include "Profiler.h"
 #include "Sprite.h"
 
 #include <algorithm>
@@ -63,6 +68,18 @@ namespace {
 		Files::LogError(prefix + "missing " + (is2x ? "@2x " : "") + "frame " + to_string(firstMissingIndex) +
 				" (" + to_string(totalMissing) + " missing in total).");
 	}
+	
+	// Read a single frame, using the cached copy of it if there is one.
+	bool ReadFrame(ImageBuffer &buffer, const string &path, int frame, bool useCache)
+	{
+		if(useCache && ImageCache::Read(path, buffer, frame))
+			return true;
+		if(!buffer.Read(path, frame))
+			return false;
+		if(useCache)
+			ImageCache::Write(path, buffer, frame);
+		return true;
+	}
 }
 
 
@@ -192,7 +209,7 @@ void ImageSet::Check() const
 	if(paths[1].size() > paths[0].size())
 		Files::LogError(prefix + to_string(paths[1].size() - paths[0].size())
 				+ " extra frames for the @2x sprite will be ignored.");
-
+	
 	LogIfMissingFrames(paths[0], paths[0].size(), prefix, false);
 	if(!paths[1].empty())
 		LogIfMissingFrames(paths[1], paths[0].size(), prefix, true);
@@ -216,15 +233,31 @@ void ImageSet::Load() noexcept(false)
 	if(makeMasks)
 		masks.resize(frames);
 	
+	// Landscapes are only loaded when they are needed, and take up far more
+	// space than all other images, so they are never cached.
+	bool useCache = !IsDeferred(name);
+	
 	// Load the 1x sprites first, then the 2x sprites, because they are likely
 	// to be in separate locations on the disk. Create masks if needed.
+	FrameTimer maskTimer;
+	double maskTime = 0.;
 	for(size_t i = 0; i < frames; ++i)
-		if(buffer[0].Read(paths[0][i], i) && makeMasks)
-			masks[i].Create(buffer[0], i);
+		if(ReadFrame(buffer[0], paths[0][i], i, useCache) && makeMasks)
+		{
+			maskTimer = FrameTimer();
+			if(!MaskCache::Get(paths[0][i], masks[i]))
+			{
+				masks[i].Create(buffer[0], i);
+				MaskCache::Set(paths[0][i], masks[i]);
+			}
+			maskTime += maskTimer.Time();
+		}
+	if(makeMasks)
+		Profiler::Add("generate masks", name, maskTime);
 	// Now, load the 2x sprites, if they exist. Because the number of 1x frames
 	// is definitive, don't load any frames beyond the size of the 1x list.
 	for(size_t i = 0; i < frames && i < paths[1].size(); ++i)
-		if(!buffer[1].Read(paths[1][i], i))
+		if(!ReadFrame(buffer[1], paths[1][i], i, useCache))
 		{
 			Files::LogError("Removing @2x frames for \"" + name + "\" due to read error");
 			buffer[1].Clear();
@@ -14,6 +14,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "Color.h"
 #include "Point.h"
+#include "RenderCommands.h"
 #include "Screen.h"
 #include "Shader.h"
 
@@ -75,11 +76,11 @@ void LineShader::Init()
 	colorI = shader.Uniform("color");
 	
 	// Generate the vertex data for drawing sprites.
-	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
+	vao = RenderCommands::GenVertexArray();
+	RenderCommands::BindVertexArray(vao);
 	
-	glGenBuffers(1, &vbo);
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	vbo = RenderCommands::GenBuffer();
+	RenderCommands::BindBuffer(GL_ARRAY_BUFFER, vbo);
 	
 	GLfloat vertexData[] = {
 		0.f, -1.f,
@@ -87,14 +88,14 @@ void LineShader::Init()
 		0.f,  1.f,
 		1.f,  1.f
 	};
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertexData), vertexData, GL_STATIC_DRAW);
+	RenderCommands::BufferData(GL_ARRAY_BUFFER, sizeof(vertexData), vertexData, GL_STATIC_DRAW);
 	
-	glEnableVertexAttribArray(shader.Attrib("vert"));
-	glVertexAttribPointer(shader.Attrib("vert"), 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), nullptr);
+	RenderCommands::EnableVertexAttribArray(shader.Attrib("vert"));
+	RenderCommands::VertexAttribPointer(shader.Attrib("vert"), 2, GL_FLOAT, false, 2 * sizeof(GLfloat), 0);
 	
 	// unbind the VBO and VAO
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	RenderCommands::BindBuffer(GL_ARRAY_BUFFER, 0);
+	RenderCommands::BindVertexArray(0);
 }
 
 
@@ -104,27 +105,27 @@ void LineShader::Draw(const Point &from, const Point &to, float width, const Col
 	if(!shader.Object())
 		throw runtime_error("LineShader: Draw() called before Init().");
 	
-	glUseProgram(shader.Object());
-	glBindVertexArray(vao);
+	RenderCommands::UseProgram(shader.Object());
+	RenderCommands::BindVertexArray(vao);
 	
 	GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
-	glUniform2fv(scaleI, 1, scale);
+	RenderCommands::Uniform2fv(scaleI, scale);
 	
 	GLfloat start[2] = {static_cast<float>(from.X()), static_cast<float>(from.Y())};
-	glUniform2fv(startI, 1, start);
+	RenderCommands::Uniform2fv(startI, start);
 	
 	Point v = to - from;
 	Point u = v.Unit() * width;
 	GLfloat length[2] = {static_cast<float>(v.X()), static_cast<float>(v.Y())};
-	glUniform2fv(lengthI, 1, length);
+	RenderCommands::Uniform2fv(lengthI, length);
 	
 	GLfloat w[2] = {static_cast<float>(u.Y()), static_cast<float>(-u.X())};
-	glUniform2fv(widthI, 1, w);
+	RenderCommands::Uniform2fv(widthI, w);
 	
-	glUniform4fv(colorI, 1, color.Get());
+	RenderCommands::Uniform4fv(colorI, color.Get());
 	
-	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	RenderCommands::DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 	
-	glBindVertexArray(0);
-	glUseProgram(0);
+	RenderCommands::BindVertexArray(0);
+	RenderCommands::UseProgram(0);
 }
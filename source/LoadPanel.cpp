@@ -32,6 +32,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "PlayerInfo.h"
 #include "Preferences.h"
 #include "Rectangle.h"
+#include "RenderCommands.h"
 #include "ShipyardPanel.h"
 #include "StarField.h"
 #include "StartConditionsPanel.h"
@@ -110,7 +111,7 @@ LoadPanel::LoadPanel(PlayerInfo &player, UI &gamePanels)
 
 void LoadPanel::Draw()
 {
-	glClear(GL_COLOR_BUFFER_BIT);
+	RenderCommands::Clear(GL_COLOR_BUFFER_BIT);
 	GameData::Background().Draw(Point(), Point());
 	const Font &font = FontSet::Get(14);
 	
@@ -497,7 +498,10 @@ void LoadPanel::LoadCallback()
 	player.Load(loadedInfo.Path());
 	
 	GetUI()->Pop(this);
-	GetUI()->Pop(GetUI()->Root().get());
+	// If the game is still loading, go back to the main menu, which lets the
+	// player enter the game once all the sprites have been loaded.
+	if(GameData::IsLoaded())
+		GetUI()->Pop(GetUI()->Root().get());
 	gamePanels.Push(new MainPanel(player));
 	// It takes one step to figure out the planet panel should be created, and
 	// another step to actually place it. So, take two steps to avoid a flicker.
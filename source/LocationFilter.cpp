@@ -25,7 +25,6 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "System.h"
 
 #include <algorithm>
-#include <mutex>
 
 using namespace std;
 
@@ -69,23 +68,8 @@ namespace {
 	// Check if the given system is within the given distance of the center.
 	int Distance(const System *center, const System *system, int maximum)
 	{
-		// This function should only ever be called from the main thread, but
-		// just to be sure, use mutex protection on the static locals.
-		static mutex distanceMutex;
-		lock_guard<mutex> lock(distanceMutex);
-		
-		static const System *previousCenter = center;
-		static DistanceMap distance(center, -1, maximum);
-		static int previousMaximum = maximum;
-		
-		if(center != previousCenter || maximum > previousMaximum)
-		{
-			previousCenter = center;
-			previousMaximum = maximum;
-			distance = DistanceMap(center, -1, maximum);
-		}
 		// If the distance is greater than the maximum, this is not a match.
-		int d = distance.Days(system);
+		int d = DistanceMap::Cached(center, maximum)->Days(system);
 		return (d > maximum) ? -1 : d;
 	}
 	
@@ -152,6 +136,10 @@ LocationFilter::LocationFilter(const DataNode &node)
 
 void LocationFilter::Load(const DataNode &node)
 {
+	// Anything that was compiled from this filter no longer applies.
+	systemsRevision = 0;
+	planetsRevision = 0;
+	
 	for(const DataNode &child : node)
 	{
 		// Handle filters that must not match, or must apply to a
@@ -433,6 +421,9 @@ LocationFilter LocationFilter::SetOrigin(const System *origin) const
 	// Revert "distance" parameters to their default.
 	result.originMinDistance = 0;
 	result.originMaxDistance = -1;
+	// The center has changed, so anything compiled for the original no longer applies.
+	result.systemsRevision = 0;
+	result.planetsRevision = 0;
 	
 	return result;
 }
@@ -442,15 +433,26 @@ LocationFilter LocationFilter::SetOrigin(const System *origin) const
 // Pick a random system that matches this filter, based on the given origin.
 const System *LocationFilter::PickSystem(const System *origin) const
 {
-	// Find a planet that satisfies the filter.
+	// Find a system that satisfies the filter.
 	vector<const System *> options;
-	for(const auto &it : GameData::Systems())
+	if(NestedFiltersUseOrigin())
 	{
-		// Skip entries with incomplete data.
-		if(!it.second.IsValid())
-			continue;
-		if(Matches(&it.second, origin))
-			options.push_back(&it.second);
+		for(const auto &it : GameData::Systems())
+		{
+			// Skip entries with incomplete data.
+			if(!it.second.IsValid())
+				continue;
+			if(Matches(&it.second, origin))
+				options.push_back(&it.second);
+		}
+	}
+	else
+	{
+		// Only the distance from the origin needs to be checked for the
+		// systems that match everything else.
+		for(const System *system : CompiledSystems())
+			if(MatchesOrigin(system, origin))
+				options.push_back(system);
 	}
 	return options.empty() ? nullptr : options[Random::Int(options.size())];
 }
@@ -460,20 +462,35 @@ const System *LocationFilter::PickSystem(const System *origin) const
 // Pick a random planet that matches this filter, based on the given origin.
 const Planet *LocationFilter::PickPlanet(const System *origin, bool hasClearance, bool requireSpaceport) const
 {
+	// Skip planets that do not offer special jobs or missions, unless they were explicitly listed as options.
+	auto isSkipped = [this, hasClearance, requireSpaceport](const Planet &planet) -> bool
+	{
+		if(planet.IsWormhole() || (requireSpaceport && !planet.HasSpaceport()) || (!hasClearance && !planet.CanLand()))
+			return planets.empty() || !planets.count(&planet);
+		return false;
+	};
+	
 	// Find a planet that satisfies the filter.
 	vector<const Planet *> options;
-	for(const auto &it : GameData::Planets())
+	if(NestedFiltersUseOrigin())
 	{
-		const Planet &planet = it.second;
-		// Skip entries with incomplete data.
-		if(!planet.IsValid())
-			continue;
-		// Skip planets that do not offer special jobs or missions, unless they were explicitly listed as options.
-		if(planet.IsWormhole() || (requireSpaceport && !planet.HasSpaceport()) || (!hasClearance && !planet.CanLand()))
-			if(planets.empty() || !planets.count(&planet))
+		for(const auto &it : GameData::Planets())
+		{
+			const Planet &planet = it.second;
+			// Skip entries with incomplete data.
+			if(!planet.IsValid() || isSkipped(planet))
 				continue;
-		if(Matches(&planet, origin))
-			options.push_back(&planet);
+			if(Matches(&planet, origin))
+				options.push_back(&planet);
+		}
+	}
+	else
+	{
+		// Only the distance from the origin needs to be checked for the
+		// planets that match everything else.
+		for(const Planet *planet : CompiledPlanets())
+			if(!isSkipped(*planet) && MatchesOrigin(planet->GetSystem(), origin))
+				options.push_back(planet);
 	}
 	return options.empty() ? nullptr : options[Random::Int(options.size())];
 }
@@ -613,9 +630,63 @@ bool LocationFilter::Matches(const System *system, const System *origin, bool di
 	// Check this system's distance from the desired reference system.
 	if(center && Distance(center, system, centerMaxDistance) < centerMinDistance)
 		return false;
-	if(origin && originMaxDistance >= 0
-			&& Distance(origin, system, originMaxDistance) < originMinDistance)
-		return false;
 	
-	return true;
+	return MatchesOrigin(system, origin);
+}
+
+
+
+// Check if the given system is within this filter's "distance" of the origin.
+bool LocationFilter::MatchesOrigin(const System *system, const System *origin) const
+{
+	return !origin || originMaxDistance < 0 || Distance(origin, system, originMaxDistance) >= originMinDistance;
+}
+
+
+
+// Check if any of the "not" or "neighbor" filters has a "distance" filter. If
+// so, whether they match depends on the origin, and so does whether this does.
+bool LocationFilter::NestedFiltersUseOrigin() const
+{
+	for(const LocationFilter &filter : notFilters)
+		if(filter.originMaxDistance >= 0 || filter.NestedFiltersUseOrigin())
+			return true;
+	for(const LocationFilter &filter : neighborFilters)
+		if(filter.originMaxDistance >= 0 || filter.NestedFiltersUseOrigin())
+			return true;
+	return false;
+}
+
+
+
+// Get the valid systems that match every part of this filter except for its
+// own "distance" from the origin, in the same order as in GameData.
+const vector<const System *> &LocationFilter::CompiledSystems() const
+{
+	if(systemsRevision != GameData::Revision() + 1)
+	{
+		systemsRevision = GameData::Revision() + 1;
+		compiledSystems.clear();
+		for(const auto &it : GameData::Systems())
+			if(it.second.IsValid() && Matches(&it.second))
+				compiledSystems.push_back(&it.second);
+	}
+	return compiledSystems;
+}
+
+
+
+// Get the valid planets that match every part of this filter except for its
+// own "distance" from the origin, in the same order as in GameData.
+const vector<const Planet *> &LocationFilter::CompiledPlanets() const
+{
+	if(planetsRevision != GameData::Revision() + 1)
+	{
+		planetsRevision = GameData::Revision() + 1;
+		compiledPlanets.clear();
+		for(const auto &it : GameData::Planets())
+			if(it.second.IsValid() && Matches(&it.second))
+				compiledPlanets.push_back(&it.second);
+	}
+	return compiledPlanets;
 }
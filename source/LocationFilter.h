@@ -13,9 +13,11 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #ifndef LOCATION_FILTER_H_
 #define LOCATION_FILTER_H_
 
+#include <cstdint>
 #include <list>
 #include <set>
 #include <string>
+#include <vector>
 
 class DataNode;
 class DataWriter;
@@ -70,6 +72,16 @@ private:
 	// only if the filter wasn't looking for planet characteristics or if the
 	// didPlanet argument is set (meaning we already checked those).
 	bool Matches(const System *system, const System *origin, bool didPlanet) const;
+	// Check if the given system is within this filter's "distance" of the origin.
+	bool MatchesOrigin(const System *system, const System *origin) const;
+	// Check if any of the "not" or "neighbor" filters has a "distance" filter.
+	bool NestedFiltersUseOrigin() const;
+	// Get the valid systems or planets that match every part of this filter
+	// except for its own "distance" from the origin, in the same order as in
+	// GameData. These are only worked out once for each version of the game
+	// data, and then reused every time a system or planet is picked.
+	const std::vector<const System *> &CompiledSystems() const;
+	const std::vector<const Planet *> &CompiledPlanets() const;
 	
 	
 private:
@@ -99,6 +111,14 @@ private:
 	std::list<LocationFilter> notFilters;
 	// These filters store all the things the planet or system must border.
 	std::list<LocationFilter> neighborFilters;
+	
+	// The systems and planets that match the parts of this filter that do not
+	// depend on the origin, and the game data revision they were found for
+	// (plus one, so that zero means they have not been found yet).
+	mutable std::vector<const System *> compiledSystems;
+	mutable std::vector<const Planet *> compiledPlanets;
+	mutable uint64_t systemsRevision = 0;
+	mutable uint64_t planetsRevision = 0;
 };
 
 
@@ -33,6 +33,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "PlayerInfoPanel.h"
 #include "Preferences.h"
 #include "Random.h"
+#include "RenderCommands.h"
 #include "Screen.h"
 #include "Ship.h"
 #include "ShipEvent.h"
@@ -146,7 +147,7 @@ void MainPanel::Step()
 void MainPanel::Draw()
 {
 	FrameTimer loadTimer;
-	glClear(GL_COLOR_BUFFER_BIT);
+	RenderCommands::Clear(GL_COLOR_BUFFER_BIT);
 	
 	engine.Draw();
 	
@@ -236,6 +237,13 @@ void MainPanel::GiveCommand(const Command &command)
 
 
 
+void MainPanel::WaitForEngine()
+{
+	engine.Wait();
+}
+
+
+
 bool MainPanel::Click(int x, int y, int clicks)
 {
 	// Don't respond to clicks if another panel is active.
@@ -41,6 +41,9 @@ public:
 	
 	// Send a command to the engine (on behalf of the player).
 	void GiveCommand(const Command &command);
+	// Wait for the engine's calculation thread to finish its current step, so
+	// that the game data can safely be changed.
+	void WaitForEngine();
 
 	// The main panel allows fast-forward.
 	virtual bool AllowFastForward() const override;
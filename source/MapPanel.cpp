@@ -29,6 +29,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "LineShader.h"
 #include "MapDetailPanel.h"
 #include "MapOutfitterPanel.h"
+#include "MapShader.h"
 #include "MapShipyardPanel.h"
 #include "Mission.h"
 #include "MissionPanel.h"
@@ -37,6 +38,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "PointerShader.h"
 #include "Politics.h"
 #include "Preferences.h"
+#include "RenderCommands.h"
 #include "RingShader.h"
 #include "Screen.h"
 #include "Ship.h"
@@ -51,6 +53,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include <algorithm>
 #include <cctype>
 #include <cmath>
+#include <cstdint>
 #include <limits>
 
 using namespace std;
@@ -102,6 +105,53 @@ namespace {
 	const int HOVER_TIME = 60;
 	// Length in frames of the recentering animation.
 	const int RECENTER_TIME = 20;
+	
+	// What the map needs to know about a system's planets in order to color it.
+	// Finding out means going through every stellar object in the system and
+	// merging together the sale lists of each planet's shipyards and outfitters,
+	// so this is only done again once the game data has changed.
+	class SystemInfo {
+	public:
+		// The system that this information is for.
+		const System *system = nullptr;
+		// The game data revision this was found for, plus one.
+		uint64_t revision = 0;
+		
+		double shipyardSize = 0.;
+		double outfitterSize = 0.;
+		bool hasSpaceport = false;
+		// The planets (not including wormholes) that can be landed on. Anything
+		// that depends on the player, such as whether they have visited a planet,
+		// may land on it, or have dominated it, is checked using this list each
+		// time the map colors are found.
+		vector<const Planet *> planets;
+	};
+	
+	// The information about each system, in the same order that the systems are
+	// stored in GameData::Systems().
+	vector<SystemInfo> systemInfo;
+	
+	void UpdateSystemInfo(SystemInfo &info, const System &system)
+	{
+		info.system = &system;
+		info.revision = GameData::Revision() + 1;
+		info.shipyardSize = 0.;
+		info.outfitterSize = 0.;
+		info.hasSpaceport = false;
+		info.planets.clear();
+		for(const StellarObject &object : system.Objects())
+			if(object.HasSprite() && object.HasValidPlanet())
+			{
+				const Planet *planet = object.GetPlanet();
+				info.shipyardSize += planet->Shipyard().size();
+				info.outfitterSize += planet->Outfitter().size();
+				if(planet->IsWormhole())
+					continue;
+				
+				info.hasSpaceport |= planet->HasSpaceport();
+				info.planets.push_back(planet);
+			}
+	}
 }
 
 const float MapPanel::OUTER = 6.f;
@@ -165,7 +215,7 @@ void MapPanel::Step()
 
 void MapPanel::Draw()
 {
-	glClear(GL_COLOR_BUFFER_BIT);
+	RenderCommands::Clear(GL_COLOR_BUFFER_BIT);
 	
 	for(const auto &it : GameData::Galaxies())
 		SpriteShader::Draw(it.second.GetSprite(), Zoom() * (center + it.second.Position()), Zoom());
@@ -195,7 +245,6 @@ void MapPanel::Draw()
 	DrawWormholes();
 	DrawTravelPlan();
 	DrawEscorts();
-	DrawLinks();
 	DrawSystems();
 	DrawNames();
 	DrawMissions();
@@ -722,9 +771,13 @@ void MapPanel::UpdateCache()
 	// which may be government, services, or commodity prices.
 	const Color &closeNameColor = *GameData::Colors().Get("map name");
 	const Color &farNameColor = closeNameColor.Transparent(.5);
+	const Ship *flagship = player.Flagship();
+	systemInfo.resize(GameData::Systems().size());
+	auto info = systemInfo.begin();
 	for(const auto &it : GameData::Systems())
 	{
 		const System &system = it.second;
+		SystemInfo &cached = *info++;
 		// Ignore systems which have been referred to, but not actually defined.
 		if(!system.IsValid())
 			continue;
@@ -732,10 +785,19 @@ void MapPanel::UpdateCache()
 		if(!player.HasSeen(system) && &system != specialSystem)
 			continue;
 		
+		// Only look through this system's planets again if the game data has
+		// changed, or if systems have been added since it was last looked at.
+		if(cached.revision != GameData::Revision() + 1 || cached.system != &system)
+			UpdateSystemInfo(cached, system);
+		
+		bool hasInhabited = false;
+		for(const Planet *planet : cached.planets)
+			hasInhabited |= planet->IsInhabited() && planet->IsAccessible(flagship);
+		
 		Color color = UninhabitedColor();
 		if(!player.HasVisited(system))
 			color = UnexploredColor();
-		else if(system.IsInhabited(player.Flagship()) || commodity == SHOW_SPECIAL || commodity == SHOW_VISITED)
+		else if(hasInhabited || commodity == SHOW_SPECIAL || commodity == SHOW_VISITED)
 		{
 			if(commodity >= SHOW_SPECIAL)
 			{
@@ -752,18 +814,12 @@ void MapPanel::UpdateCache()
 				}
 				else if(commodity == SHOW_SHIPYARD)
 				{
-					double size = 0;
-					for(const StellarObject &object : system.Objects())
-						if(object.HasSprite() && object.HasValidPlanet())
-							size += object.GetPlanet()->Shipyard().size();
+					double size = cached.shipyardSize;
 					value = size ? min(10., size) / 10. : -1.;
 				}
 				else if(commodity == SHOW_OUTFITTER)
 				{
-					double size = 0;
-					for(const StellarObject &object : system.Objects())
-						if(object.HasSprite() && object.HasValidPlanet())
-							size += object.GetPlanet()->Outfitter().size();
+					double size = cached.outfitterSize;
 					value = size ? min(60., size) / 60. : -1.;
 				}
 				else if(commodity == SHOW_VISITED)
@@ -771,11 +827,10 @@ void MapPanel::UpdateCache()
 					bool all = true;
 					bool some = false;
 					colorSystem = false;
-					for(const StellarObject &object : system.Objects())
-						if(object.HasSprite() && object.HasValidPlanet() && !object.GetPlanet()->IsWormhole()
-							&& object.GetPlanet()->IsAccessible(player.Flagship()))
+					for(const Planet *planet : cached.planets)
+						if(planet->IsAccessible(flagship))
 						{
-							bool visited = player.HasVisited(*object.GetPlanet());
+							bool visited = player.HasVisited(*planet);
 							all &= visited;
 							some |= visited;
 							colorSystem = true;
@@ -804,24 +859,20 @@ void MapPanel::UpdateCache()
 				bool hasDominated = true;
 				bool isInhabited = false;
 				bool canLand = false;
-				bool hasSpaceport = false;
-				for(const StellarObject &object : system.Objects())
-					if(object.HasSprite() && object.HasValidPlanet())
-					{
-						const Planet *planet = object.GetPlanet();
-						hasSpaceport |= !planet->IsWormhole() && planet->HasSpaceport();
-						if(planet->IsWormhole() || !planet->IsAccessible(player.Flagship()))
-							continue;
-						canLand |= planet->CanLand() && planet->HasSpaceport();
-						isInhabited |= planet->IsInhabited();
-						hasDominated &= (!planet->IsInhabited()
-							|| GameData::GetPolitics().HasDominated(planet));
-					}
+				for(const Planet *planet : cached.planets)
+				{
+					if(!planet->IsAccessible(flagship))
+						continue;
+					canLand |= planet->CanLand() && planet->HasSpaceport();
+					isInhabited |= planet->IsInhabited();
+					hasDominated &= (!planet->IsInhabited()
+						|| GameData::GetPolitics().HasDominated(planet));
+				}
 				hasDominated &= (isInhabited && canLand);
 				// Some systems may count as "inhabited" but not contain any
 				// planets with spaceports. Color those as if they're
 				// uninhabited to make it clear that no fuel is available there.
-				if(hasSpaceport || hasDominated)
+				if(cached.hasSpaceport || hasDominated)
 					color = ReputationColor(reputation, canLand, hasDominated);
 			}
 		}
@@ -832,8 +883,9 @@ void MapPanel::UpdateCache()
 			player.HasVisited(system) ? system.GetGovernment() : nullptr);
 	}
 	
-	// Now, update the cache of the links.
-	links.clear();
+	// Now, update the cache of the links. They are drawn first, so that the
+	// system rings are drawn on top of them.
+	systemLayer.Clear();
 	
 	// The link color depends on whether it's connected to the current system or not.
 	const Color &closeColor = *GameData::Colors().Get("map link");
@@ -854,9 +906,16 @@ void MapPanel::UpdateCache()
 					continue;
 				
 				bool isClose = (system == &playerSystem || link == &playerSystem);
-				links.emplace_back(system->Position(), link->Position(), isClose ? closeColor : farColor);
+				systemLayer.AddLine(system->Position(), link->Position(), LINK_OFFSET, LINK_WIDTH,
+					isClose ? closeColor : farColor);
 			}
 	}
+	
+	for(const Node &node : nodes)
+		systemLayer.AddRing(node.position, OUTER, INNER, node.color);
+	
+	// The names must be laid out again too.
+	nameFontSize = 0;
 }
 
 
@@ -1046,54 +1105,35 @@ void MapPanel::DrawWormholes()
 
 
 
-void MapPanel::DrawLinks()
-{
-	double zoom = Zoom();
-	for(const Link &link : links)
-	{
-		Point from = zoom * (link.start + center);
-		Point to = zoom * (link.end + center);
-		Point unit = (from - to).Unit() * LINK_OFFSET;
-		from -= unit;
-		to += unit;
-		
-		LineShader::Draw(from, to, LINK_WIDTH, link.color);
-	}
-}
-
-
-
 void MapPanel::DrawSystems()
 {
 	if(commodity != cachedCommodity)
 		UpdateCache();
 	
+	// Draw the links and the circles for the systems.
+	double zoom = Zoom();
+	MapShader::Draw(systemLayer, center, zoom);
+	
 	// If coloring by government, we need to keep track of which ones are the
 	// closest to the center of the window because those will be the ones that
 	// are shown in the map key.
-	if(commodity == SHOW_GOVERNMENT)
-		closeGovernments.clear();
+	if(commodity != SHOW_GOVERNMENT)
+		return;
 	
-	// Draw the circles for the systems.
-	double zoom = Zoom();
+	closeGovernments.clear();
 	for(const Node &node : nodes)
-	{
-		Point pos = zoom * (node.position + center);
-		RingShader::Draw(pos, OUTER, INNER, node.color);
-		
-		if(commodity == SHOW_GOVERNMENT && node.government && node.government->GetName() != "Uninhabited")
+		if(node.government && node.government->GetName() != "Uninhabited")
 		{
 			// For every government that is drawn, keep track of how close it
 			// is to the center of the view. The four closest governments
 			// will be displayed in the key.
-			double distance = pos.Length();
+			double distance = (zoom * (node.position + center)).Length();
 			auto it = closeGovernments.find(node.government);
 			if(it == closeGovernments.end())
 				closeGovernments[node.government] = distance;
 			else
 				it->second = min(it->second, distance);
 		}
-	}
 }
 
 
@@ -1107,10 +1147,17 @@ void MapPanel::DrawNames()
 	
 	// Draw names for all systems you have visited.
 	bool useBigFont = (zoom > 2.);
-	const Font &font = FontSet::Get(useBigFont ? 18 : 14);
-	Point offset(useBigFont ? 8. : 6., -.5 * font.Height());
-	for(const Node &node : nodes)
-		font.Draw(node.name, zoom * (node.position + center) + offset, node.nameColor);
+	int fontSize = useBigFont ? 18 : 14;
+	if(fontSize != nameFontSize)
+	{
+		nameFontSize = fontSize;
+		nameLayer.Clear();
+		const Font &font = FontSet::Get(fontSize);
+		Point offset(useBigFont ? 8. : 6., -.5 * font.Height());
+		for(const Node &node : nodes)
+			nameLayer.AddText(font, node.name, node.position, offset, node.nameColor);
+	}
+	MapShader::Draw(nameLayer, center, zoom);
 }
 
 
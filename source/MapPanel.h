@@ -17,6 +17,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "Color.h"
 #include "DistanceMap.h"
+#include "MapShader.h"
 #include "Point.h"
 #include "text/WrappedText.h"
 
@@ -131,7 +132,8 @@ protected:
 	void CenterOnSystem(const System *system, bool immediate = false);
 	
 	// Cache the map layout, so it doesn't have to be re-calculated every frame.
-	// The cache must be updated when the coloring mode changes.
+	// The cache must be updated when the coloring mode changes, or when the
+	// value that the systems are colored by changes.
 	void UpdateCache();
 	
 	// For tooltips:
@@ -146,8 +148,8 @@ private:
 	// Indicate which other systems have player escorts.
 	void DrawEscorts();
 	void DrawWormholes();
-	void DrawLinks();
-	// Draw systems in accordance to the set commodity color scheme.
+	// Draw the links and the systems, colored in accordance to the set
+	// commodity color scheme.
 	void DrawSystems();
 	void DrawNames();
 	void DrawMissions();
@@ -173,16 +175,12 @@ private:
 	};
 	std::vector<Node> nodes;
 	
-	class Link {
-	public:
-		Link(const Point &start, const Point &end, const Color &color)
-			: start(start), end(end), color(color) {}
-		
-		Point start;
-		Point end;
-		Color color;
-	};
-	std::vector<Link> links;
+	// The links and system rings, and the system names, ready to be drawn.
+	// The names depend on which font is used for them, which depends on the
+	// zoom, so they are only laid out when they are drawn.
+	MapShader::Layer systemLayer;
+	MapShader::Layer nameLayer;
+	int nameFontSize = 0;
 };
 
 
@@ -0,0 +1,286 @@
+/* MapShader.cpp
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "MapShader.h"
+
+#include "Color.h"
+#include "text/Font.h"
+#include "Point.h"
+#include "RenderCommands.h"
+#include "Screen.h"
+#include "Shader.h"
+
+#include "gl_header.h"
+
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+	// The kinds of shapes that a layer can hold.
+	const float RING = 0.f;
+	const float LINE = 1.f;
+	const float GLYPH = 2.f;
+	
+	// Each vertex has a position in map coordinates, an offset from it in
+	// pixels, the coordinates within its shape, the size of its shape, its
+	// color, and which kind of shape it is part of.
+	const int ATTRIBUTE_COUNT = 6;
+	const int ATTRIBUTE_SIZES[ATTRIBUTE_COUNT] = {2, 2, 2, 2, 4, 1};
+	const char *const ATTRIBUTE_NAMES[ATTRIBUTE_COUNT] = {"position", "offset", "coord", "size", "color", "kind"};
+	const int VERTEX_SIZE = 13;
+	
+	Shader shader;
+	GLint scaleI;
+	GLint centerI;
+	GLint zoomI;
+	GLint attributeI[ATTRIBUTE_COUNT];
+	
+	GLuint vao;
+}
+
+
+
+MapShader::Layer::Layer(const Layer &other)
+	: vertices(other.vertices), texture(other.texture)
+{
+}
+
+
+
+MapShader::Layer &MapShader::Layer::operator=(const Layer &other)
+{
+	vertices = other.vertices;
+	texture = other.texture;
+	isUploaded = false;
+	return *this;
+}
+
+
+
+MapShader::Layer::~Layer()
+{
+	if(buffer)
+		RenderCommands::DeleteBuffer(buffer);
+}
+
+
+
+void MapShader::Layer::Clear()
+{
+	vertices.clear();
+	texture = 0;
+	isUploaded = false;
+}
+
+
+
+bool MapShader::Layer::IsEmpty() const
+{
+	return vertices.empty();
+}
+
+
+
+// Add a ring with the given outer and inner radius, in pixels.
+void MapShader::Layer::AddRing(const Point &center, float outer, float inner, const Color &color)
+{
+	// Use the same radius and falloff as RingShader::Draw().
+	float width = .5f * (1.f + outer - inner);
+	float radius = outer - width;
+	float size = radius + width;
+	const float corners[6][2] = {{-1.f, -1.f}, {-1.f, 1.f}, {1.f, -1.f}, {-1.f, 1.f}, {1.f, -1.f}, {1.f, 1.f}};
+	for(const float *corner : corners)
+		Add(center, size * corner[0], size * corner[1], size * corner[0], size * corner[1],
+			radius, width, color, RING);
+	isUploaded = false;
+}
+
+
+
+// Add a line of the given width, starting and ending the given number of
+// pixels away from the given points.
+void MapShader::Layer::AddLine(const Point &from, const Point &to, float offset, float width, const Color &color)
+{
+	// The line is drawn the same way as by LineShader::Draw(), once the ends
+	// have been moved toward each other by the offset.
+	Point unit = (to - from).Unit();
+	Point along = unit * offset;
+	Point across = Point(unit.Y(), -unit.X()) * width;
+	float length = from.Distance(to);
+	const float corners[6][2] = {{0.f, -1.f}, {1.f, -1.f}, {0.f, 1.f}, {1.f, -1.f}, {0.f, 1.f}, {1.f, 1.f}};
+	for(const float *corner : corners)
+	{
+		const Point &end = corner[0] ? to : from;
+		Point pixels = (corner[0] ? -along : along) + corner[1] * across;
+		Add(end, pixels.X(), pixels.Y(), corner[0], corner[1], length, offset, color, LINE);
+	}
+	isUploaded = false;
+}
+
+
+
+// Add text, with its top left corner the given number of pixels away from the
+// given point. All the text in a layer must use the same font.
+void MapShader::Layer::AddText(const Font &font, const string &str, const Point &position, const Point &offset, const Color &color)
+{
+	texture = font.Texture();
+	quads.clear();
+	font.Quads(str, offset.X(), offset.Y(), quads);
+	// Each quad is four corners of x, y, s, t, which are drawn as two triangles.
+	const int ORDER[6] = {0, 1, 2, 1, 2, 3};
+	for(size_t i = 0; i < quads.size(); i += 16)
+		for(int corner : ORDER)
+		{
+			const float *it = &quads[i + 4 * corner];
+			Add(position, it[0], it[1], it[2], it[3], 0.f, 0.f, color, GLYPH);
+		}
+	isUploaded = false;
+}
+
+
+
+void MapShader::Layer::Add(const Point &position, float offsetX, float offsetY, float coordX, float coordY,
+	float sizeX, float sizeY, const Color &color, float kind)
+{
+	const float *rgba = color.Get();
+	vertices.insert(vertices.end(), {
+		static_cast<float>(position.X()), static_cast<float>(position.Y()),
+		offsetX, offsetY, coordX, coordY, sizeX, sizeY,
+		rgba[0], rgba[1], rgba[2], rgba[3], kind});
+}
+
+
+
+void MapShader::Init()
+{
+	static const char *vertexCode =
+		"// vertex map shader\n"
+		"uniform vec2 scale;\n"
+		"uniform vec2 center;\n"
+		"uniform float zoom;\n"
+		
+		"in vec2 position;\n"
+		"in vec2 offset;\n"
+		"in vec2 coord;\n"
+		"in vec2 size;\n"
+		"in vec4 color;\n"
+		"in float kind;\n"
+		
+		"out vec2 fragCoord;\n"
+		"out vec2 fragSize;\n"
+		"out vec4 fragColor;\n"
+		"flat out int fragKind;\n"
+		
+		"void main() {\n"
+		"  fragCoord = coord;\n"
+		"  fragSize = size;\n"
+		"  fragColor = color;\n"
+		"  fragKind = int(kind);\n"
+		"  vec2 point = (position + center) * zoom;\n"
+		// A line's size is its length in map coordinates and the offset at
+		// each end, which give its drawn length in pixels.
+		"  if(fragKind == 1)\n"
+		"    fragSize = vec2(abs(size.x * zoom - 2 * size.y), 0);\n"
+		// Text is drawn at whole pixels, so that it stays sharp.
+		"  else if(fragKind == 2)\n"
+		"    point = floor(point + .5);\n"
+		"  gl_Position = vec4((point + offset) * scale, 0, 1);\n"
+		"}\n";
+	
+	static const char *fragmentCode =
+		"// fragment map shader\n"
+		"uniform sampler2D tex;\n"
+		
+		"in vec2 fragCoord;\n"
+		"in vec2 fragSize;\n"
+		"in vec4 fragColor;\n"
+		"flat in int fragKind;\n"
+		
+		"out vec4 finalColor;\n"
+		
+		"void main() {\n"
+		"  float alpha;\n"
+		"  if(fragKind == 0)\n"
+		"    alpha = fragSize.y - abs(length(fragCoord) - fragSize.x);\n"
+		"  else if(fragKind == 1)\n"
+		"    alpha = min(fragSize.x - abs(fragCoord.x * (2 * fragSize.x) - fragSize.x), 1 - abs(fragCoord.y));\n"
+		"  else\n"
+		"    alpha = texture(tex, fragCoord).a;\n"
+		"  finalColor = fragColor * clamp(alpha, 0, 1);\n"
+		"}\n";
+	
+	shader = Shader(vertexCode, fragmentCode);
+	scaleI = shader.Uniform("scale");
+	centerI = shader.Uniform("center");
+	zoomI = shader.Uniform("zoom");
+	for(int i = 0; i < ATTRIBUTE_COUNT; ++i)
+		attributeI[i] = shader.Attrib(ATTRIBUTE_NAMES[i]);
+	
+	RenderCommands::UseProgram(shader.Object());
+	RenderCommands::Uniform1i(shader.Uniform("tex"), 0);
+	RenderCommands::UseProgram(0);
+	
+	// The vertex data comes from each layer's own buffer, which is connected
+	// to this VAO when that layer is drawn.
+	vao = RenderCommands::GenVertexArray();
+	RenderCommands::BindVertexArray(vao);
+	for(int i = 0; i < ATTRIBUTE_COUNT; ++i)
+		RenderCommands::EnableVertexAttribArray(attributeI[i]);
+	RenderCommands::BindVertexArray(0);
+}
+
+
+
+// Draw the given layer, with the given map position at the center of the
+// screen and the given zoom.
+void MapShader::Draw(Layer &layer, const Point &center, double zoom)
+{
+	if(!shader.Object())
+		throw runtime_error("MapShader: Draw() called before Init().");
+	if(layer.vertices.empty())
+		return;
+	
+	RenderCommands::UseProgram(shader.Object());
+	RenderCommands::BindVertexArray(vao);
+	if(!layer.buffer)
+		layer.buffer = RenderCommands::GenBuffer();
+	RenderCommands::BindBuffer(GL_ARRAY_BUFFER, layer.buffer);
+	if(!layer.isUploaded)
+	{
+		RenderCommands::BufferData(GL_ARRAY_BUFFER, sizeof(float) * layer.vertices.size(),
+			layer.vertices.data(), GL_STATIC_DRAW);
+		layer.isUploaded = true;
+	}
+	
+	constexpr auto stride = VERTEX_SIZE * sizeof(float);
+	size_t offset = 0;
+	for(int i = 0; i < ATTRIBUTE_COUNT; ++i)
+	{
+		RenderCommands::VertexAttribPointer(attributeI[i], ATTRIBUTE_SIZES[i], GL_FLOAT, false, stride,
+			offset * sizeof(float));
+		offset += ATTRIBUTE_SIZES[i];
+	}
+	if(layer.texture)
+		RenderCommands::BindTexture(GL_TEXTURE_2D, layer.texture);
+	
+	GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
+	RenderCommands::Uniform2fv(scaleI, scale);
+	RenderCommands::Uniform2f(centerI, center.X(), center.Y());
+	RenderCommands::Uniform1f(zoomI, zoom);
+	
+	RenderCommands::DrawArrays(GL_TRIANGLES, 0, layer.vertices.size() / VERTEX_SIZE);
+	
+	RenderCommands::BindBuffer(GL_ARRAY_BUFFER, 0);
+	RenderCommands::BindVertexArray(0);
+	RenderCommands::UseProgram(0);
+}
@@ -0,0 +1,79 @@
+/* MapShader.h
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef MAP_SHADER_H_
+#define MAP_SHADER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Color;
+class Font;
+class Point;
+
+
+
+// Class for drawing the parts of the map that do not change from one frame to
+// the next: the system rings, the links between them, and their names. These
+// are collected into a "layer" whose positions are in map coordinates, with
+// sizes and offsets in pixels, so that the same layer can be drawn with a
+// single draw call at any zoom level or position. The layer is only uploaded
+// to the graphics card again when it changes.
+class MapShader {
+public:
+	class Layer {
+	public:
+		Layer() = default;
+		// A copy of a layer has the same contents, but uploads them into its
+		// own buffer.
+		Layer(const Layer &other);
+		Layer &operator=(const Layer &other);
+		~Layer();
+		
+		void Clear();
+		bool IsEmpty() const;
+		// Add a ring with the given outer and inner radius, in pixels.
+		void AddRing(const Point &center, float outer, float inner, const Color &color);
+		// Add a line of the given width, starting and ending the given number
+		// of pixels away from the given points.
+		void AddLine(const Point &from, const Point &to, float offset, float width, const Color &color);
+		// Add text, with its top left corner the given number of pixels away
+		// from the given point. All the text in a layer must use the same font.
+		void AddText(const Font &font, const std::string &str, const Point &position, const Point &offset, const Color &color);
+	
+	private:
+		void Add(const Point &position, float offsetX, float offsetY, float coordX, float coordY,
+			float sizeX, float sizeY, const Color &color, float kind);
+	
+	private:
+		std::vector<float> vertices;
+		std::vector<float> quads;
+		uint32_t texture = 0;
+		uint32_t buffer = 0;
+		bool isUploaded = false;
+		
+		friend class MapShader;
+	};
+
+
+public:
+	static void Init();
+	
+	// Draw the given layer, with the given map position at the center of the
+	// screen and the given zoom.
+	static void Draw(Layer &layer, const Point &center, double zoom);
+};
+
+
+
+#endif
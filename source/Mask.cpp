@@ -234,6 +234,15 @@ void Mask::Create(const ImageBuffer &image, int frame)
 
 
 
+// Construct a mask from an outline that was previously generated.
+void Mask::Create(vector<Point> outline)
+{
+	this->outline.swap(outline);
+	radius = ComputeRadius(this->outline);
+}
+
+
+
 // Check whether a mask was successfully loaded.
 bool Mask::IsLoaded() const
 {
@@ -34,6 +34,8 @@ public:
 	
 	// Construct a mask from the alpha channel of an image.
 	void Create(const ImageBuffer &image, int frame = 0);
+	// Construct a mask from an outline that was previously generated.
+	void Create(std::vector<Point> outline);
 	
 	// Check whether a mask was successfully loaded.
 	bool IsLoaded() const;
@@ -0,0 +1,241 @@
+/* MaskCache.cpp
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "MaskCache.h"
+
+#include "Files.h"
+#include "Mask.h"
+#include "Point.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+namespace {
+	// Change this whenever the format of the cache or the way that masks are
+	// generated changes, so that older outlines are ignored.
+	const uint32_t VERSION = 1;
+	const char MAGIC[4] = {'E', 'S', 'M', 'C'};
+	
+	class Entry {
+	public:
+		uint64_t sourceSize = 0;
+		int64_t timestamp = 0;
+		// The outline, stored as pairs of x and y coordinates. Every point in
+		// a generated outline is a multiple of 1/4, so a float holds it exactly.
+		vector<float> points;
+		bool used = false;
+	};
+	
+	mutex cacheMutex;
+	string cachePath;
+	map<string, Entry> entries;
+	bool changed = false;
+	
+	
+	// Helper class for reading values out of the cache file.
+	class Reader {
+	public:
+		explicit Reader(const string &data) : it(data.data()), end(data.data() + data.size()) {}
+		
+		template <class Type>
+		bool Read(Type &value)
+		{
+			return Read(&value, sizeof(Type));
+		}
+		bool Read(void *out, size_t size)
+		{
+			if(static_cast<size_t>(end - it) < size)
+				return false;
+			memcpy(out, it, size);
+			it += size;
+			return true;
+		}
+		// Get the number of bytes that have not been read yet.
+		size_t Remaining() const
+		{
+			return end - it;
+		}
+	
+	private:
+		const char *it;
+		const char *end;
+	};
+	
+	
+	template <class Type>
+	void Append(string &data, const Type &value)
+	{
+		data.append(reinterpret_cast<const char *>(&value), sizeof(Type));
+	}
+}
+
+
+
+// Read the cached outlines from the given file, if it exists.
+void MaskCache::Init(const string &path)
+{
+	lock_guard<mutex> lock(cacheMutex);
+	cachePath = path;
+	entries.clear();
+	changed = false;
+	if(!Files::Exists(path))
+		return;
+	
+	string data = Files::Read(path);
+	Reader reader(data);
+	char magic[4];
+	uint32_t version = 0;
+	uint32_t count = 0;
+	if(!reader.Read(magic, sizeof(magic)) || memcmp(magic, MAGIC, sizeof(MAGIC))
+			|| !reader.Read(version) || version != VERSION || !reader.Read(count))
+	{
+		// The whole file will be replaced the next time the cache is saved.
+		changed = true;
+		return;
+	}
+	
+	for(uint32_t i = 0; i < count; ++i)
+	{
+		uint32_t pathLength = 0;
+		uint32_t pointCount = 0;
+		string source;
+		Entry entry;
+		// Check each size against what is left of the file before allocating
+		// anything, so a corrupted size is treated like a truncated file.
+		bool valid = reader.Read(pathLength) && pathLength <= reader.Remaining();
+		if(valid)
+		{
+			source.resize(pathLength);
+			valid = reader.Read(&source[0], pathLength);
+		}
+		valid = valid && reader.Read(entry.sourceSize) && reader.Read(entry.timestamp)
+			&& reader.Read(pointCount) && pointCount <= reader.Remaining() / (2 * sizeof(float));
+		if(valid)
+		{
+			entry.points.resize(2 * static_cast<size_t>(pointCount));
+			valid = reader.Read(entry.points.data(), entry.points.size() * sizeof(float));
+		}
+		// If the file was truncated or corrupted, keep whatever outlines were
+		// read in full.
+		if(!valid)
+		{
+			changed = true;
+			break;
+		}
+		entries[source] = move(entry);
+	}
+}
+
+
+
+// Get the cached mask for the given image. Returns false if there is no
+// valid cached mask for it.
+bool MaskCache::Get(const string &path, Mask &mask)
+{
+	uint64_t sourceSize = Files::Size(path);
+	int64_t timestamp = Files::Timestamp(path);
+	
+	vector<Point> outline;
+	{
+		lock_guard<mutex> lock(cacheMutex);
+		auto it = entries.find(path);
+		if(it == entries.end() || it->second.sourceSize != sourceSize || it->second.timestamp != timestamp)
+			return false;
+		
+		it->second.used = true;
+		const vector<float> &points = it->second.points;
+		outline.reserve(points.size() / 2);
+		for(size_t i = 0; i + 1 < points.size(); i += 2)
+			outline.emplace_back(points[i], points[i + 1]);
+	}
+	mask.Create(move(outline));
+	return true;
+}
+
+
+
+// Store the mask that was generated from the given image.
+void MaskCache::Set(const string &path, const Mask &mask)
+{
+	Entry entry;
+	entry.sourceSize = Files::Size(path);
+	entry.timestamp = Files::Timestamp(path);
+	entry.used = true;
+	for(const Point &point : mask.Points())
+	{
+		entry.points.push_back(point.X());
+		entry.points.push_back(point.Y());
+	}
+	
+	lock_guard<mutex> lock(cacheMutex);
+	entries[path] = move(entry);
+	changed = true;
+}
+
+
+
+// Write the cache back to disk if it has changed. Any outlines that were
+// not used since the cache was read are discarded.
+void MaskCache::Save()
+{
+	lock_guard<mutex> lock(cacheMutex);
+	if(cachePath.empty())
+		return;
+	
+	for(auto it = entries.begin(); it != entries.end(); )
+	{
+		if(it->second.used)
+			++it;
+		else
+		{
+			it = entries.erase(it);
+			changed = true;
+		}
+	}
+	if(!changed)
+		return;
+	
+	string data(MAGIC, sizeof(MAGIC));
+	Append(data, VERSION);
+	Append(data, static_cast<uint32_t>(entries.size()));
+	for(const auto &it : entries)
+	{
+		Append(data, static_cast<uint32_t>(it.first.size()));
+		data += it.first;
+		Append(data, it.second.sourceSize);
+		Append(data, it.second.timestamp);
+		Append(data, static_cast<uint32_t>(it.second.points.size() / 2));
+		data.append(reinterpret_cast<const char *>(it.second.points.data()), it.second.points.size() * sizeof(float));
+	}
+	
+	// Write to a temporary file first, so that a partially written file never
+	// replaces the existing cache.
+	string partPath = cachePath + ".part";
+	FILE *out = Files::Open(partPath, true, true);
+	if(!out)
+		return;
+	bool success = (fwrite(data.data(), 1, data.size(), out) == data.size());
+	success &= !fclose(out);
+	if(success)
+	{
+		Files::Move(partPath, cachePath);
+		changed = false;
+	}
+	else
+		Files::Delete(partPath);
+}
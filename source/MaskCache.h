@@ -0,0 +1,45 @@
+/* MaskCache.h
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef MASK_CACHE_H_
+#define MASK_CACHE_H_
+
+#include <string>
+
+class Mask;
+
+
+
+// Class for storing the collision mask outlines generated from each image, so
+// that they do not have to be traced again the next time the game starts. All
+// the outlines are kept in a single file, and an outline is only used if its
+// source image still has the same size and modification time. Once Init() has
+// been called, Get() and Set() can be used from multiple threads.
+class MaskCache {
+public:
+	// Read the cached outlines from the given file, if it exists.
+	static void Init(const std::string &path);
+	
+	// Get the cached mask for the given image. Returns false if there is no
+	// valid cached mask for it.
+	static bool Get(const std::string &path, Mask &mask);
+	// Store the mask that was generated from the given image.
+	static void Set(const std::string &path, const Mask &mask);
+	
+	// Write the cache back to disk if it has changed. Any outlines that were
+	// not used since the cache was read are discarded.
+	static void Save();
+};
+
+
+
+#endif
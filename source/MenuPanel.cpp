@@ -28,6 +28,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Point.h"
 #include "PointerShader.h"
 #include "PreferencesPanel.h"
+#include "RenderCommands.h"
 #include "Ship.h"
 #include "ShipyardPanel.h"
 #include "Sprite.h"
@@ -84,7 +85,7 @@ void MenuPanel::Step()
 
 void MenuPanel::Draw()
 {
-	glClear(GL_COLOR_BUFFER_BIT);
+	RenderCommands::Clear(GL_COLOR_BUFFER_BIT);
 	GameData::Background().Draw(Point(), Point());
 	const Font &font = FontSet::Get(14);
 	
@@ -158,10 +159,12 @@ void MenuPanel::Draw()
 
 bool MenuPanel::KeyDown(SDL_Keycode key, Uint16 mod, const Command &command, bool isNewPress)
 {
-	if(!GameData::IsLoaded())
+	// The menu can be used once its own sprites are loaded, but the player can
+	// only enter the game once every sprite (and collision mask) is loaded.
+	if(!GameData::IsReady())
 		return false;
 	
-	if(player.IsLoaded() && (key == 'e' || command.Has(Command::MENU)))
+	if(player.IsLoaded() && GameData::IsLoaded() && (key == 'e' || command.Has(Command::MENU)))
 	{
 		gamePanels.CanSave(true);
 		GetUI()->Pop(this);
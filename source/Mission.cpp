@@ -131,7 +131,7 @@ void Mission::Load(const DataNode &node)
 		node.PrintTrace("Duplicate definition of mission:");
 		return;
 	}
-	name = node.Token(1);
+	SetName(node.Token(1));
 	
 	for(const DataNode &child : node)
 	{
@@ -648,28 +648,50 @@ bool Mission::CanOffer(const PlayerInfo &player, const shared_ptr<Ship> &boardin
 		if(!sourceFilter.Matches(*boardingShip))
 			return false;
 	}
-	else
-	{
-		if(source && source != player.GetPlanet())
-			return false;
+	else if(!CanOfferOn(player.GetPlanet()))
+		return false;
 	
-		if(!sourceFilter.Matches(player.GetPlanet()))
-			return false;
-	}
+	return ConditionsAllowOffer(player.Conditions()) && ActionsAllowOffer(player, boardingShip);
+}
+
+
+
+// Check if this mission may be offered on the given planet. This only
+// depends on the game data, not on anything the player has done.
+bool Mission::CanOfferOn(const Planet *planet) const
+{
+	if(source && source != planet)
+		return false;
 	
-	if(!toOffer.Test(player.Conditions()))
+	return sourceFilter.Matches(planet);
+}
+
+
+
+// Check if the player's conditions allow this mission to be offered.
+bool Mission::ConditionsAllowOffer(const ConditionsStore &conditions) const
+{
+	if(!toOffer.Test(conditions))
 		return false;
 	
-	if(!toFail.IsEmpty() && toFail.Test(player.Conditions()))
+	if(!toFail.IsEmpty() && toFail.Test(conditions))
 		return false;
 	
 	if(repeat)
 	{
-		auto cit = player.Conditions().find(name + ": offered");
-		if(cit != player.Conditions().end() && cit->second >= repeat)
+		const int64_t *offered = conditions.Find(offeredCondition);
+		if(offered && *offered >= repeat)
 			return false;
 	}
-	
+	return true;
+}
+
+
+
+// Check if the actions that are done when this mission is offered, accepted,
+// declined, or deferred can be done.
+bool Mission::ActionsAllowOffer(const PlayerInfo &player, const shared_ptr<Ship> &boardingShip) const
+{
 	auto it = actions.find(OFFER);
 	if(it != actions.end() && !it->second.CanBeDone(player, boardingShip))
 		return false;
@@ -691,6 +713,20 @@ bool Mission::CanOffer(const PlayerInfo &player, const shared_ptr<Ship> &boardin
 
 
 
+// Add the IDs of the conditions that ConditionsAllowOffer() reads to the
+// given list. Returns false if its result also depends on chance.
+bool Mission::AddOfferDependencies(vector<ConditionsStore::Id> &ids) const
+{
+	bool isDeterministic = toOffer.AddDependencies(ids);
+	if(!toFail.IsEmpty())
+		isDeterministic &= toFail.AddDependencies(ids);
+	if(repeat)
+		ids.push_back(offeredCondition);
+	return isDeterministic;
+}
+
+
+
 bool Mission::HasSpace(const PlayerInfo &player) const
 {
 	int extraCrew = 0;
@@ -907,16 +943,16 @@ bool Mission::Do(Trigger trigger, PlayerInfo &player, UI *ui, const shared_ptr<S
 	// not prevent a mission from being failed or aborted.
 	if(trigger == FAIL)
 	{
-		--player.Conditions()[name + ": active"];
-		++player.Conditions()[name + ": failed"];
+		--player.Conditions()[activeCondition];
+		++player.Conditions()[failedCondition];
 	}
 	else if(trigger == ABORT)
 	{
-		--player.Conditions()[name + ": active"];
-		++player.Conditions()[name + ": aborted"];
+		--player.Conditions()[activeCondition];
+		++player.Conditions()[abortedCondition];
 		// Set the failed mission condition here as well for
 		// backwards compatibility.
-		++player.Conditions()[name + ": failed"];
+		++player.Conditions()[failedCondition];
 	}
 	
 	// Don't update any further conditions if this action exists and can't be completed.
@@ -925,21 +961,21 @@ bool Mission::Do(Trigger trigger, PlayerInfo &player, UI *ui, const shared_ptr<S
 	
 	if(trigger == ACCEPT)
 	{
-		++player.Conditions()[name + ": offered"];
-		++player.Conditions()[name + ": active"];
+		++player.Conditions()[offeredCondition];
+		++player.Conditions()[activeCondition];
 		// Any potential on offer conversation has been finished, so update
 		// the active NPCs for the first time.
 		UpdateNPCs(player);
 	}
 	else if(trigger == DECLINE)
 	{
-		++player.Conditions()[name + ": offered"];
-		++player.Conditions()[name + ": declined"];
+		++player.Conditions()[offeredCondition];
+		++player.Conditions()[declinedCondition];
 	}
 	else if(trigger == COMPLETE)
 	{
-		--player.Conditions()[name + ": active"];
-		++player.Conditions()[name + ": done"];
+		--player.Conditions()[activeCondition];
+		++player.Conditions()[doneCondition];
 	}
 	
 	// "Jobs" should never show dialogs when offered, nor should they call the
@@ -1085,7 +1121,7 @@ Mission Mission::Instantiate(const PlayerInfo &player, const shared_ptr<Ship> &b
 	result.autosave = autosave;
 	result.location = location;
 	result.repeat = repeat;
-	result.name = name;
+	result.SetName(name);
 	result.waypoints = waypoints;
 	// Handle waypoint systems that are chosen randomly.
 	const System * const source = player.GetSystem();
@@ -1205,19 +1241,18 @@ Mission Mission::Instantiate(const PlayerInfo &player, const shared_ptr<Ship> &b
 	while(!destinations.empty())
 	{
 		// Find the closest destination to this location.
-		DistanceMap distance(path);
+		shared_ptr<const DistanceMap> distance = DistanceMap::Cached(path);
 		auto it = destinations.begin();
 		auto bestIt = it;
 		for(++it; it != destinations.end(); ++it)
-			if(distance.Days(*it) < distance.Days(*bestIt))
+			if(distance->Days(*it) < distance->Days(*bestIt))
 				bestIt = it;
 		
 		path = *bestIt;
-		jumps += distance.Days(*bestIt);
+		jumps += distance->Days(*bestIt);
 		destinations.erase(bestIt);
 	}
-	DistanceMap distance(path);
-	jumps += distance.Days(result.destination->GetSystem());
+	jumps += DistanceMap::Cached(path)->Days(result.destination->GetSystem());
 	int64_t payload = static_cast<int64_t>(result.cargoSize) + 10 * static_cast<int64_t>(result.passengers);
 	
 	// Set the deadline, if requested.
@@ -1400,3 +1435,17 @@ bool Mission::ParseContraband(const DataNode &node)
 	
 	return true;
 }
+
+
+
+// Set this mission's name, and look up the conditions that go with it.
+void Mission::SetName(const string &newName)
+{
+	name = newName;
+	offeredCondition = ConditionsStore::GetId(name + ": offered");
+	activeCondition = ConditionsStore::GetId(name + ": active");
+	failedCondition = ConditionsStore::GetId(name + ": failed");
+	abortedCondition = ConditionsStore::GetId(name + ": aborted");
+	declinedCondition = ConditionsStore::GetId(name + ": declined");
+	doneCondition = ConditionsStore::GetId(name + ": done");
+}
@@ -24,6 +24,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 class DataNode;
 class DataWriter;
@@ -112,6 +113,16 @@ public:
 	// into account, so before actually offering a mission you should also check
 	// if the player has enough space.
 	bool CanOffer(const PlayerInfo &player, const std::shared_ptr<Ship> &boardingShip = nullptr) const;
+	// The separate parts of CanOffer() for missions that are offered on planets:
+	// whether this mission may be offered on the given planet (which only
+	// depends on the game data), whether the player's conditions allow it,
+	// and whether the actions that offering it may lead to can be done.
+	bool CanOfferOn(const Planet *planet) const;
+	bool ConditionsAllowOffer(const ConditionsStore &conditions) const;
+	bool ActionsAllowOffer(const PlayerInfo &player, const std::shared_ptr<Ship> &boardingShip = nullptr) const;
+	// Add the IDs of the conditions that ConditionsAllowOffer() reads to the
+	// given list. Returns false if its result also depends on chance.
+	bool AddOfferDependencies(std::vector<ConditionsStore::Id> &ids) const;
 	bool HasSpace(const PlayerInfo &player) const;
 	bool HasSpace(const Ship &ship) const;
 	bool CanComplete(const PlayerInfo &player) const;
@@ -170,10 +181,20 @@ private:
 	// For legacy code, contraband definitions can be placed in two different
 	// locations, so move that parsing out to a helper function.
 	bool ParseContraband(const DataNode &node);
+	// Set this mission's name, and look up the conditions that go with it.
+	void SetName(const std::string &newName);
 	
 	
 private:
 	std::string name;
+	// The IDs of the "<name>: offered" (and active, failed, etc.) conditions,
+	// so that they do not have to be looked up by name each time they change.
+	ConditionsStore::Id offeredCondition = 0;
+	ConditionsStore::Id activeCondition = 0;
+	ConditionsStore::Id failedCondition = 0;
+	ConditionsStore::Id abortedCondition = 0;
+	ConditionsStore::Id declinedCondition = 0;
+	ConditionsStore::Id doneCondition = 0;
 	std::string displayName;
 	std::string description;
 	std::string blocked;
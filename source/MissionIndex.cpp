@@ -0,0 +1,103 @@
+/* MissionIndex.cpp
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "MissionIndex.h"
+
+#include "GameData.h"
+#include "Mission.h"
+#include "Planet.h"
+
+using namespace std;
+
+
+
+// Get the missions that might be offered on the given planet (other than
+// ones offered when boarding or assisting a ship), in the order they are
+// defined in.
+const vector<size_t> &MissionIndex::Candidates(const Planet *planet)
+{
+	Update();
+	auto it = candidates.find(planet);
+	if(it != candidates.end())
+		return it->second;
+	
+	// Jobs are never offered on uninhabited planets.
+	bool skipJobs = planet && !planet->IsInhabited();
+	vector<size_t> &list = candidates[planet];
+	for(size_t i = 0; i < entries.size(); ++i)
+	{
+		const Mission &mission = *entries[i].mission;
+		if(skipJobs && mission.IsAtLocation(Mission::JOB))
+			continue;
+		if(mission.CanOfferOn(planet))
+			list.push_back(i);
+	}
+	return list;
+}
+
+
+
+const Mission &MissionIndex::GetMission(size_t index) const
+{
+	return *entries[index].mission;
+}
+
+
+
+// Check if the given mission is known not to be offered with the given
+// conditions, because it was blocked by them and they have not changed since.
+bool MissionIndex::IsBlocked(size_t index, const ConditionsStore &conditions) const
+{
+	const Entry &entry = entries[index];
+	if(!entry.isBlocked)
+		return false;
+	
+	for(ConditionsStore::Id id : entry.dependencies)
+		if(conditions.HasChanged(id, entry.blockedAt))
+			return false;
+	return true;
+}
+
+
+
+// Remember that the given conditions do not allow this mission to be offered.
+void MissionIndex::SetBlocked(size_t index, const ConditionsStore &conditions)
+{
+	Entry &entry = entries[index];
+	entry.isBlocked = entry.isDeterministic;
+	entry.blockedAt = conditions.Revision();
+}
+
+
+
+// Make sure the index matches the current game data.
+void MissionIndex::Update()
+{
+	if(isValid && dataRevision == GameData::Revision())
+		return;
+	
+	isValid = true;
+	dataRevision = GameData::Revision();
+	entries.clear();
+	candidates.clear();
+	for(const auto &it : GameData::Missions())
+	{
+		const Mission &mission = it.second;
+		if(mission.IsAtLocation(Mission::BOARDING) || mission.IsAtLocation(Mission::ASSISTING))
+			continue;
+		
+		entries.emplace_back();
+		Entry &entry = entries.back();
+		entry.mission = &mission;
+		entry.isDeterministic = mission.AddOfferDependencies(entry.dependencies);
+	}
+}
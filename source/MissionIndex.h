@@ -0,0 +1,74 @@
+/* MissionIndex.h
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef MISSION_INDEX_H_
+#define MISSION_INDEX_H_
+
+#include "ConditionsStore.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+class Mission;
+class Planet;
+
+
+
+// Class that remembers which missions might be offered on each planet, so that
+// the player's missions can be created on landing without checking every
+// mission's source filter. It also remembers which missions were not offered
+// because of the player's conditions, and which conditions that depended on,
+// so they are not tested again until one of those conditions changes. All of
+// this is recomputed whenever the game data changes.
+class MissionIndex {
+public:
+	// Get the missions that might be offered on the given planet (other than
+	// ones offered when boarding or assisting a ship), in the order they are
+	// defined in. These are given as indices for the functions below.
+	const std::vector<size_t> &Candidates(const Planet *planet);
+	const Mission &GetMission(size_t index) const;
+	
+	// Check if the given mission is known not to be offered with the given
+	// conditions, because it was blocked by them and they have not changed since.
+	bool IsBlocked(size_t index, const ConditionsStore &conditions) const;
+	// Remember that the given conditions do not allow this mission to be offered.
+	void SetBlocked(size_t index, const ConditionsStore &conditions);
+
+
+private:
+	// Make sure the index matches the current game data.
+	void Update();
+
+
+private:
+	class Entry {
+	public:
+		const Mission *mission;
+		// The conditions that decide whether this mission may be offered.
+		std::vector<ConditionsStore::Id> dependencies;
+		// Only missions that do not depend on chance can be remembered as blocked.
+		bool isDeterministic;
+		bool isBlocked = false;
+		uint64_t blockedAt = 0;
+	};
+	
+	bool isValid = false;
+	uint64_t dataRevision = 0;
+	std::vector<Entry> entries;
+	std::map<const Planet *, std::vector<size_t>> candidates;
+};
+
+
+
+#endif
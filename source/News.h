@@ -35,7 +35,7 @@ public:
 	// Check whether this news item has anything to say.
 	bool IsEmpty() const;
 	// Check if this news item is available given the player's planet and conditions.
-	bool Matches(const Planet *planet, const std::map<std::string, std::int64_t> &conditions) const;
+	bool Matches(const Planet *planet, const ConditionsStore &conditions) const;
 	
 	// Get the speaker's name.
 	std::string Name() const;
@@ -0,0 +1,234 @@
+/* OpenGLBackend.cpp
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "OpenGLBackend.h"
+
+#include "Files.h"
+
+#include "gl_header.h"
+
+#include <cctype>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+using Type = RenderCommands::Type;
+
+namespace {
+	GLuint Compile(const char *str, GLenum type)
+	{
+		GLuint object = glCreateShader(type);
+		if(!object)
+			throw runtime_error("Shader creation failed.");
+		
+		static string version;
+		if(version.empty())
+		{
+			version = "#version ";
+			string glsl = reinterpret_cast<const char *>(glGetString(GL_SHADING_LANGUAGE_VERSION));
+			for(char c : glsl)
+			{
+				if(isspace(c))
+					break;
+				if(isdigit(c))
+					version += c;
+			}
+			version += '\n';
+		}
+		size_t length = strlen(str);
+		vector<GLchar> text(version.length() + length + 1);
+		memcpy(&text.front(), version.data(), version.length());
+		memcpy(&text.front() + version.length(), str, length);
+		text[version.length() + length] = '\0';
+		
+		const GLchar *cText = &text.front();
+		glShaderSource(object, 1, &cText, nullptr);
+		glCompileShader(object);
+		
+		GLint status;
+		glGetShaderiv(object, GL_COMPILE_STATUS, &status);
+		if(status == GL_FALSE)
+		{
+			string error = version;
+			error += string(str, length);
+			
+			static const int SIZE = 4096;
+			GLchar message[SIZE];
+			GLsizei length;
+			
+			glGetShaderInfoLog(object, SIZE, &length, message);
+			error += string(message, length);
+			Files::LogError(error);
+			throw runtime_error("Shader compilation failed.");
+		}
+		
+		return object;
+	}
+}
+
+
+
+void OpenGLBackend::Execute(const RenderCommands::Command &command, const void *data)
+{
+	const uint32_t *args = command.args;
+	const GLfloat *floats = reinterpret_cast<const GLfloat *>(data);
+	const GLint *ints = reinterpret_cast<const GLint *>(data);
+	switch(command.type)
+	{
+		case Type::USE_PROGRAM:
+			glUseProgram(args[0]);
+			break;
+		case Type::BIND_VERTEX_ARRAY:
+			glBindVertexArray(args[0]);
+			break;
+		case Type::BIND_BUFFER:
+			glBindBuffer(args[0], args[1]);
+			break;
+		case Type::BIND_TEXTURE:
+			glBindTexture(args[0], args[1]);
+			break;
+		case Type::TEXTURE_PARAMETERS:
+			glTexParameteriv(args[0], args[1], ints);
+			break;
+		case Type::DELETE_TEXTURE:
+			glDeleteTextures(1, &args[0]);
+			break;
+		case Type::DELETE_BUFFER:
+			glDeleteBuffers(1, &args[0]);
+			break;
+		case Type::BUFFER_DATA:
+			glBufferData(args[0], command.size, data, args[1]);
+			break;
+		case Type::TEXTURE_IMAGE:
+			// A depth of zero means that this is a 2D texture.
+			if(args[6])
+				glTexImage3D(args[0], 0, args[1], args[4], args[5], args[6], 0, args[7], args[8], data);
+			else
+				glTexImage2D(args[0], 0, args[1], args[4], args[5], 0, args[7], args[8], data);
+			break;
+		case Type::TEXTURE_SUBIMAGE:
+			if(args[6])
+				glTexSubImage3D(args[0], 0, args[1], args[2], args[3], args[4], args[5], args[6], args[7], args[8], data);
+			else
+				glTexSubImage2D(args[0], 0, args[1], args[2], args[4], args[5], args[7], args[8], data);
+			break;
+		case Type::ENABLE_ATTRIBUTE_ARRAY:
+			glEnableVertexAttribArray(args[0]);
+			break;
+		case Type::ATTRIBUTE_POINTER:
+			glVertexAttribPointer(args[0], args[1], args[2], args[3], args[4],
+				reinterpret_cast<const GLvoid *>(static_cast<size_t>(args[5])));
+			break;
+		case Type::ATTRIBUTE_DIVISOR:
+			glVertexAttribDivisor(args[0], args[1]);
+			break;
+		case Type::ATTRIBUTE:
+			if(command.size == sizeof(GLfloat))
+				glVertexAttrib1fv(args[0], floats);
+			else if(command.size == 2 * sizeof(GLfloat))
+				glVertexAttrib2fv(args[0], floats);
+			else
+				glVertexAttrib4fv(args[0], floats);
+			break;
+		case Type::UNIFORM_INT:
+			glUniform1i(args[0], static_cast<GLint>(args[1]));
+			break;
+		case Type::UNIFORM_FLOATS:
+			if(command.size == sizeof(GLfloat))
+				glUniform1fv(args[0], 1, floats);
+			else if(command.size == 2 * sizeof(GLfloat))
+				glUniform2fv(args[0], 1, floats);
+			else
+				glUniform4fv(args[0], 1, floats);
+			break;
+		case Type::UNIFORM_MATRIX:
+			glUniformMatrix2fv(args[0], 1, false, floats);
+			break;
+		case Type::DRAW_ARRAYS:
+			glDrawArrays(args[0], args[1], args[2]);
+			break;
+		case Type::DRAW_ARRAYS_INSTANCED:
+			glDrawArraysInstanced(args[0], args[1], args[2], args[3]);
+			break;
+		case Type::CLEAR:
+			glClear(args[0]);
+			break;
+	}
+}
+
+
+
+uint32_t OpenGLBackend::Create(RenderCommands::Object object)
+{
+	GLuint name = 0;
+	if(object == RenderCommands::Object::VERTEX_ARRAY)
+		glGenVertexArrays(1, &name);
+	else if(object == RenderCommands::Object::BUFFER)
+		glGenBuffers(1, &name);
+	else
+		glGenTextures(1, &name);
+	return name;
+}
+
+
+
+uint32_t OpenGLBackend::CompileProgram(const char *vertex, const char *fragment)
+{
+	GLuint vertexShader = Compile(vertex, GL_VERTEX_SHADER);
+	GLuint fragmentShader = Compile(fragment, GL_FRAGMENT_SHADER);
+	
+	GLuint program = glCreateProgram();
+	if(!program)
+		throw runtime_error("Creating OpenGL shader program failed.");
+	
+	glAttachShader(program, vertexShader);
+	glAttachShader(program, fragmentShader);
+	
+	glLinkProgram(program);
+	
+	glDetachShader(program, vertexShader);
+	glDetachShader(program, fragmentShader);
+	
+	GLint status;
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
+	if(status == GL_FALSE)
+	{
+		GLint maxLength = 0;
+		glGetProgramiv(program, GL_INFO_LOG_LENGTH, &maxLength);
+		vector<GLchar> infoLog(maxLength);
+		glGetProgramInfoLog(program, maxLength, &maxLength, &infoLog[0]);
+		string error(infoLog.data());
+		Files::LogError(error);
+		
+		throw runtime_error("Linking OpenGL shader program failed.");
+	}
+	return program;
+}
+
+
+
+int32_t OpenGLBackend::GetLocation(uint32_t program, const char *name, bool isAttribute)
+{
+	return isAttribute ? glGetAttribLocation(program, name) : glGetUniformLocation(program, name);
+}
+
+
+
+int32_t OpenGLBackend::GetInteger(uint32_t name)
+{
+	GLint value = 0;
+	glGetIntegerv(name, &value);
+	return value;
+}
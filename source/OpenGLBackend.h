@@ -0,0 +1,35 @@
+/* OpenGLBackend.h
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef OPENGL_BACKEND_H_
+#define OPENGL_BACKEND_H_
+
+#include "RenderCommands.h"
+
+
+
+// Class that carries out recorded render commands by calling the OpenGL
+// functions that they correspond to. This is what is normally used to draw
+// the game, so it requires an OpenGL context.
+class OpenGLBackend : public RenderCommands::Backend {
+public:
+	virtual void Execute(const RenderCommands::Command &command, const void *data) override;
+	
+	virtual uint32_t Create(RenderCommands::Object object) override;
+	virtual uint32_t CompileProgram(const char *vertex, const char *fragment) override;
+	virtual int32_t GetLocation(uint32_t program, const char *name, bool isAttribute) override;
+	virtual int32_t GetInteger(uint32_t name) override;
+};
+
+
+
+#endif
@@ -61,6 +61,7 @@ public:
 	
 	double Get(const char *attribute) const;
 	double Get(const std::string &attribute) const;
+	double Get(Dictionary::Id attribute) const;
 	const Dictionary &Attributes() const;
 	
 	// Determine whether the given number of instances of the given outfit can
@@ -133,6 +134,7 @@ private:
 // These get called a lot, so inline them for speed.
 inline int64_t Outfit::Cost() const { return cost; }
 inline double Outfit::Mass() const { return mass; }
+inline double Outfit::Get(Dictionary::Id attribute) const { return attributes.Get(attribute); }
 
 
 
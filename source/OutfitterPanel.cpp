@@ -58,7 +58,7 @@ OutfitterPanel::OutfitterPanel(PlayerInfo &player)
 	
 	// Add owned licenses
 	const string PREFIX = "license: ";
-	for(auto &it : player.Conditions())
+	for(const auto &it : player.Conditions())
 		if(it.first.compare(0, PREFIX.length(), PREFIX) == 0 && it.second > 0)
 		{
 			const string name = it.first.substr(PREFIX.length()) + " License";
@@ -69,6 +69,8 @@ OutfitterPanel::OutfitterPanel(PlayerInfo &player)
 	
 	if(player.GetPlanet())
 		outfitter = player.GetPlanet()->Outfitter();
+	for(const Outfit *outfit : outfitter)
+		GameData::Preload(outfit->Thumbnail());
 }
 
 
@@ -14,6 +14,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "Color.h"
 #include "Point.h"
+#include "RenderCommands.h"
 #include "Screen.h"
 #include "Shader.h"
 #include "Sprite.h"
@@ -26,8 +27,10 @@ namespace {
 	GLint offI;
 	GLint transformI;
 	GLint positionI;
-	GLint frameI;
-	GLint frameCountI;
+	GLint firstRectI;
+	GLint secondRectI;
+	GLint layersI;
+	GLint fadeI;
 	GLint colorI;
 	
 	GLuint vao;
@@ -67,8 +70,10 @@ void OutlineShader::Init()
 	static const char *fragmentCode =
 		"// fragment outline shader\n"
 		"uniform sampler2DArray tex;\n"
-		"uniform float frame = 0;\n"
-		"uniform float frameCount = 0;\n"
+		"uniform vec4 firstRect = vec4(0, 0, 1, 1);\n"
+		"uniform vec4 secondRect = vec4(0, 0, 1, 1);\n"
+		"uniform vec2 layers = vec2(0, 0);\n"
+		"uniform float fade = 0;\n"
 		"uniform vec4 color = vec4(1, 1, 1, 1);\n"
 		"uniform vec2 off;\n"
 		"const vec4 weight = vec4(.4, .4, .4, 1.);\n"
@@ -77,23 +82,29 @@ void OutlineShader::Init()
 		
 		"out vec4 finalColor;\n"
 		
-		"float Sobel(float layer) {\n"
+		// Sample one frame, given coordinates within the sprite. The sprite may
+		// be in a texture atlas, so samples past its edge are clamped to it.
+		"float Sample(vec2 coord, vec4 rect, float layer) {\n"
+		"  return dot(texture(tex, vec3(mix(rect.xy, rect.zw, clamp(coord, 0., 1.)), layer)), weight);\n"
+		"}\n"
+		
+		"float Sobel(vec4 rect, float layer) {\n"
 		"  float sum = 0;\n"
 		"  for(int dy = -1; dy <= 1; ++dy)\n"
 		"  {\n"
 		"    for(int dx = -1; dx <= 1; ++dx)\n"
 		"    {\n"
 		"      vec2 center = fragTexCoord + .618034 * off * vec2(dx, dy);\n"
-		"      float nw = dot(texture(tex, vec3(center + vec2(-off.x, -off.y), layer)), weight);\n"
-		"      float ne = dot(texture(tex, vec3(center + vec2(off.x, -off.y), layer)), weight);\n"
-		"      float sw = dot(texture(tex, vec3(center + vec2(-off.x, off.y), layer)), weight);\n"
-		"      float se = dot(texture(tex, vec3(center + vec2(off.x, off.y), layer)), weight);\n"
+		"      float nw = Sample(center + vec2(-off.x, -off.y), rect, layer);\n"
+		"      float ne = Sample(center + vec2(off.x, -off.y), rect, layer);\n"
+		"      float sw = Sample(center + vec2(-off.x, off.y), rect, layer);\n"
+		"      float se = Sample(center + vec2(off.x, off.y), rect, layer);\n"
 		"      float h = nw + sw - ne - se + 2 * (\n"
-		"        dot(texture(tex, vec3(center + vec2(-off.x, 0), layer)), weight)\n"
-		"          - dot(texture(tex, vec3(center + vec2(off.x, 0), layer)), weight));\n"
+		"        Sample(center + vec2(-off.x, 0), rect, layer)\n"
+		"          - Sample(center + vec2(off.x, 0), rect, layer));\n"
 		"      float v = nw + ne - sw - se + 2 * (\n"
-		"        dot(texture(tex, vec3(center + vec2(0, -off.y), layer)), weight)\n"
-		"          - dot(texture(tex, vec3(center + vec2(0, off.y), layer)), weight));\n"
+		"        Sample(center + vec2(0, -off.y), rect, layer)\n"
+		"          - Sample(center + vec2(0, off.y), rect, layer));\n"
 		"      sum += h * h + v * v;\n"
 		"    }\n"
 		"  }\n"
@@ -101,10 +112,7 @@ void OutlineShader::Init()
 		"}\n"
 		
 		"void main() {\n"
-		"  float first = floor(frame);\n"
-		"  float second = mod(ceil(frame), frameCount);\n"
-		"  float fade = frame - first;\n"
-		"  float sum = mix(Sobel(first), Sobel(second), fade);\n"
+		"  float sum = mix(Sobel(firstRect, layers.x), Sobel(secondRect, layers.y), fade);\n"
 		"  finalColor = color * sqrt(sum / 180);\n"
 		"}\n";
 	
@@ -113,20 +121,22 @@ void OutlineShader::Init()
 	offI = shader.Uniform("off");
 	transformI = shader.Uniform("transform");
 	positionI = shader.Uniform("position");
-	frameI = shader.Uniform("frame");
-	frameCountI = shader.Uniform("frameCount");
+	firstRectI = shader.Uniform("firstRect");
+	secondRectI = shader.Uniform("secondRect");
+	layersI = shader.Uniform("layers");
+	fadeI = shader.Uniform("fade");
 	colorI = shader.Uniform("color");
 	
-	glUseProgram(shader.Object());
-	glUniform1i(shader.Uniform("tex"), 0);
-	glUseProgram(0);
+	RenderCommands::UseProgram(shader.Object());
+	RenderCommands::Uniform1i(shader.Uniform("tex"), 0);
+	RenderCommands::UseProgram(0);
 	
 	// Generate the vertex data for drawing sprites.
-	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
+	vao = RenderCommands::GenVertexArray();
+	RenderCommands::BindVertexArray(vao);
 	
-	glGenBuffers(1, &vbo);
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	vbo = RenderCommands::GenBuffer();
+	RenderCommands::BindBuffer(GL_ARRAY_BUFFER, vbo);
 	
 	GLfloat vertexData[] = {
 		-.5f, -.5f, 0.f, 0.f,
@@ -135,37 +145,43 @@ void OutlineShader::Init()
 		 .5f,  .5f, 1.f, 1.f
 	};
 	constexpr auto stride = 4 * sizeof(GLfloat);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertexData), vertexData, GL_STATIC_DRAW);
+	RenderCommands::BufferData(GL_ARRAY_BUFFER, sizeof(vertexData), vertexData, GL_STATIC_DRAW);
 	
-	glEnableVertexAttribArray(shader.Attrib("vert"));
-	glVertexAttribPointer(shader.Attrib("vert"), 2, GL_FLOAT, GL_FALSE, stride, nullptr);
+	RenderCommands::EnableVertexAttribArray(shader.Attrib("vert"));
+	RenderCommands::VertexAttribPointer(shader.Attrib("vert"), 2, GL_FLOAT, false, stride, 0);
 	
-	glEnableVertexAttribArray(shader.Attrib("vertTexCoord"));
-	glVertexAttribPointer(shader.Attrib("vertTexCoord"), 2, GL_FLOAT, GL_TRUE,
-		stride, reinterpret_cast<const GLvoid*>(2 * sizeof(GLfloat)));
+	RenderCommands::EnableVertexAttribArray(shader.Attrib("vertTexCoord"));
+	RenderCommands::VertexAttribPointer(shader.Attrib("vertTexCoord"), 2, GL_FLOAT, true,
+		stride, 2 * sizeof(GLfloat));
 	
 	// unbind the VBO and VAO
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	RenderCommands::BindBuffer(GL_ARRAY_BUFFER, 0);
+	RenderCommands::BindVertexArray(0);
 }
 
 
 
 void OutlineShader::Draw(const Sprite *sprite, const Point &pos, const Point &size, const Color &color, const Point &unit, float frame)
 {
-	glUseProgram(shader.Object());
-	glBindVertexArray(vao);
+	RenderCommands::UseProgram(shader.Object());
+	RenderCommands::BindVertexArray(vao);
 	
 	GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
-	glUniform2fv(scaleI, 1, scale);
+	RenderCommands::Uniform2fv(scaleI, scale);
 	
 	GLfloat off[2] = {
 		static_cast<float>(.5 / size.X()),
 		static_cast<float>(.5 / size.Y())};
-	glUniform2fv(offI, 1, off);
+	RenderCommands::Uniform2fv(offI, off);
 	
-	glUniform1f(frameI, frame);
-	glUniform1f(frameCountI, sprite->Frames());
+	bool isHighDPI = (unit.Length() * Screen::Zoom() > 50.);
+	Sprite::Region first;
+	Sprite::Region second;
+	float fade = sprite->GetRegions(frame, isHighDPI, first, second);
+	RenderCommands::Uniform4fv(firstRectI, first.rect);
+	RenderCommands::Uniform4fv(secondRectI, second.rect);
+	RenderCommands::Uniform2f(layersI, first.layer, second.layer);
+	RenderCommands::Uniform1f(fadeI, fade);
 	
 	Point uw = unit * size.X();
 	Point uh = unit * size.Y();
@@ -175,18 +191,18 @@ void OutlineShader::Draw(const Sprite *sprite, const Point &pos, const Point &si
 		static_cast<float>(-uh.X()),
 		static_cast<float>(-uh.Y())
 	};
-	glUniformMatrix2fv(transformI, 1, false, transform);
+	RenderCommands::UniformMatrix2fv(transformI, transform);
 	
 	GLfloat position[2] = {
 		static_cast<float>(pos.X()), static_cast<float>(pos.Y())};
-	glUniform2fv(positionI, 1, position);
+	RenderCommands::Uniform2fv(positionI, position);
 	
-	glUniform4fv(colorI, 1, color.Get());
+	RenderCommands::Uniform4fv(colorI, color.Get());
 	
-	glBindTexture(GL_TEXTURE_2D_ARRAY, sprite->Texture(unit.Length() * Screen::Zoom() > 50.));
+	RenderCommands::BindTexture(GL_TEXTURE_2D_ARRAY, sprite->Texture(isHighDPI));
 	
-	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	RenderCommands::DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 	
-	glBindVertexArray(0);
-	glUseProgram(0);
+	RenderCommands::BindVertexArray(0);
+	RenderCommands::UseProgram(0);
 }
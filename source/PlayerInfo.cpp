@@ -23,7 +23,9 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Government.h"
 #include "Hardpoint.h"
 #include "Messages.h"
+#include "Minable.h"
 #include "Mission.h"
+#include "NPC.h"
 #include "Outfit.h"
 #include "Person.h"
 #include "Planet.h"
@@ -33,6 +35,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "SavedGame.h"
 #include "Ship.h"
 #include "ShipEvent.h"
+#include "SpriteSet.h"
 #include "StartConditions.h"
 #include "StellarObject.h"
 #include "System.h"
@@ -110,6 +113,8 @@ void PlayerInfo::New(const StartConditions &start)
 	for(const auto &it : GameData::Events())
 		if(it.second.GetDate())
 			AddEvent(it.second, it.second.GetDate());
+	
+	PrioritizeSprites();
 }
 
 
@@ -305,6 +310,8 @@ void PlayerInfo::Load(const string &path)
 	// will count as non-depreciated.
 	if(!depreciation.IsLoaded())
 		depreciation.Init(ships, date.DaysSinceEpoch());
+	
+	PrioritizeSprites();
 }
 
 
@@ -1802,7 +1809,7 @@ int64_t PlayerInfo::GetCondition(const string &name) const
 
 
 // Get mutable access to the player's list of conditions.
-map<string, int64_t> &PlayerInfo::Conditions()
+ConditionsStore &PlayerInfo::Conditions()
 {
 	return conditions;
 }
@@ -1810,7 +1817,7 @@ map<string, int64_t> &PlayerInfo::Conditions()
 
 
 // Access the player's list of conditions.
-const map<string, int64_t> &PlayerInfo::Conditions() const
+const ConditionsStore &PlayerInfo::Conditions() const
 {
 	return conditions;
 }
@@ -2514,6 +2521,33 @@ void PlayerInfo::ValidateLoad()
 
 
 
+// If the game is still loading, load the sprites of this pilot's ships and
+// of everything in its current system ahead of all the others.
+void PlayerInfo::PrioritizeSprites() const
+{
+	if(GameData::IsLoaded())
+		return;
+	
+	for(const shared_ptr<Ship> &ship : ships)
+		GameData::Prioritize(ship->GetSprite());
+	if(!system)
+		return;
+	
+	GameData::Prioritize(system->Haze());
+	for(const StellarObject &object : system->Objects())
+		GameData::Prioritize(object.GetSprite());
+	for(const System::Asteroid &asteroid : system->Asteroids())
+		GameData::Prioritize(asteroid.Type() ? asteroid.Type()->GetSprite()
+			: SpriteSet::Get("asteroid/" + asteroid.Name() + "/spin"));
+	for(const Mission &mission : missions)
+		for(const NPC &npc : mission.NPCs())
+			for(const shared_ptr<Ship> &ship : npc.Ships())
+				if(ship->GetSystem() == system)
+					GameData::Prioritize(ship->GetSprite());
+}
+
+
+
 // Update the conditions that reflect the current status of the player.
 void PlayerInfo::UpdateAutoConditions(bool isBoarding)
 {
@@ -2529,7 +2563,7 @@ void PlayerInfo::UpdateAutoConditions(bool isBoarding)
 	// Serialize the current reputation with other governments.
 	SetReputationConditions();
 	// Helper lambda function to clear a range
-	auto clearRange = [](map<string, int64_t> &conditionsMap, string firstStr, string lastStr)
+	auto clearRange = [](ConditionsStore &conditionsMap, string firstStr, string lastStr)
 	{
 		auto first = conditionsMap.lower_bound(firstStr);
 		auto last = conditionsMap.lower_bound(lastStr);
@@ -2593,27 +2627,31 @@ void PlayerInfo::CreateMissions()
 {
 	boardingMissions.clear();
 	
-	// Check for available missions.
-	bool skipJobs = planet && !planet->IsInhabited();
+	// Check for available missions. Only the missions that might be offered on
+	// this planet need to be checked, and any that the player's conditions did
+	// not allow last time are skipped unless those conditions have changed.
 	bool hasPriorityMissions = false;
-	for(const auto &it : GameData::Missions())
+	for(size_t index : missionIndex.Candidates(planet))
 	{
-		if(it.second.IsAtLocation(Mission::BOARDING) || it.second.IsAtLocation(Mission::ASSISTING))
-			continue;
-		if(skipJobs && it.second.IsAtLocation(Mission::JOB))
+		const Mission &mission = missionIndex.GetMission(index);
+		if(missionIndex.IsBlocked(index, conditions))
 			continue;
-		
-		if(it.second.CanOffer(*this))
+		if(!mission.ConditionsAllowOffer(conditions))
 		{
-			list<Mission> &missions =
-				it.second.IsAtLocation(Mission::JOB) ? availableJobs : availableMissions;
-			
-			missions.push_back(it.second.Instantiate(*this));
-			if(missions.back().HasFailed(*this))
-				missions.pop_back();
-			else if(!it.second.IsAtLocation(Mission::JOB))
-				hasPriorityMissions |= missions.back().HasPriority();
+			missionIndex.SetBlocked(index, conditions);
+			continue;
 		}
+		if(!mission.ActionsAllowOffer(*this))
+			continue;
+		
+		list<Mission> &missions =
+			mission.IsAtLocation(Mission::JOB) ? availableJobs : availableMissions;
+		
+		missions.push_back(mission.Instantiate(*this));
+		if(missions.back().HasFailed(*this))
+			missions.pop_back();
+		else if(!mission.IsAtLocation(Mission::JOB))
+			hasPriorityMissions |= missions.back().HasPriority();
 	}
 	
 	// If any of the available missions are "priority" missions, no other
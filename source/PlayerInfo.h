@@ -15,12 +15,14 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "Account.h"
 #include "CargoHold.h"
+#include "ConditionsStore.h"
 #include "CoreStartData.h"
 #include "DataNode.h"
 #include "Date.h"
 #include "Depreciation.h"
 #include "GameEvent.h"
 #include "Mission.h"
+#include "MissionIndex.h"
 
 #include <chrono>
 #include <list>
@@ -200,8 +202,8 @@ public:
 	
 	// Access the "condition" flags for this player.
 	int64_t GetCondition(const std::string &name) const;
-	std::map<std::string, int64_t> &Conditions();
-	const std::map<std::string, int64_t> &Conditions() const;
+	ConditionsStore &Conditions();
+	const ConditionsStore &Conditions() const;
 	// Set and check the reputation conditions, which missions and events
 	// can use to modify the player's reputation with other governments.
 	void SetReputationConditions();
@@ -276,6 +278,9 @@ private:
 	void ApplyChanges();
 	// After loading & applying changes, make sure the player & ship locations are sensible.
 	void ValidateLoad();
+	// If the game is still loading, load the sprites of this pilot's ships and
+	// of everything in its current system ahead of all the others.
+	void PrioritizeSprites() const;
 	
 	// New missions are generated each time you land on a planet.
 	void UpdateAutoConditions(bool isBoarding = false);
@@ -338,7 +343,10 @@ private:
 	// its NPCs to be placed before the player lands, and is then cleared.
 	Mission *activeBoardingMission = nullptr;
 	
-	std::map<std::string, int64_t> conditions;
+	ConditionsStore conditions;
+	// Which missions might be offered where, and which of them the player's
+	// conditions are known not to allow.
+	MissionIndex missionIndex;
 	
 	std::set<const System *> seen;
 	std::set<const System *> visitedSystems;
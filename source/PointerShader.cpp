@@ -14,6 +14,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "Color.h"
 #include "Point.h"
+#include "RenderCommands.h"
 #include "Screen.h"
 #include "Shader.h"
 
@@ -82,25 +83,25 @@ void PointerShader::Init()
 	colorI = shader.Uniform("color");
 	
 	// Generate the vertex data for drawing sprites.
-	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
+	vao = RenderCommands::GenVertexArray();
+	RenderCommands::BindVertexArray(vao);
 	
-	glGenBuffers(1, &vbo);
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	vbo = RenderCommands::GenBuffer();
+	RenderCommands::BindBuffer(GL_ARRAY_BUFFER, vbo);
 	
 	GLfloat vertexData[] = {
 		0.f, 0.f,
 		0.f, 1.f,
 		1.f, 0.f,
 	};
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertexData), vertexData, GL_STATIC_DRAW);
+	RenderCommands::BufferData(GL_ARRAY_BUFFER, sizeof(vertexData), vertexData, GL_STATIC_DRAW);
 	
-	glEnableVertexAttribArray(shader.Attrib("vert"));
-	glVertexAttribPointer(shader.Attrib("vert"), 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), nullptr);
+	RenderCommands::EnableVertexAttribArray(shader.Attrib("vert"));
+	RenderCommands::VertexAttribPointer(shader.Attrib("vert"), 2, GL_FLOAT, false, 2 * sizeof(GLfloat), 0);
 	
 	// unbind the VBO and VAO
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	RenderCommands::BindBuffer(GL_ARRAY_BUFFER, 0);
+	RenderCommands::BindVertexArray(0);
 }
 
 
@@ -121,11 +122,11 @@ void PointerShader::Bind()
 	if(!shader.Object())
 		throw runtime_error("PointerShader: Bind() called before Init().");
 	
-	glUseProgram(shader.Object());
-	glBindVertexArray(vao);
+	RenderCommands::UseProgram(shader.Object());
+	RenderCommands::BindVertexArray(vao);
 	
 	GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
-	glUniform2fv(scaleI, 1, scale);
+	RenderCommands::Uniform2fv(scaleI, scale);
 }
 
 
@@ -133,25 +134,25 @@ void PointerShader::Bind()
 void PointerShader::Add(const Point &center, const Point &angle, float width, float height, float offset, const Color &color)
 {
 	GLfloat c[2] = {static_cast<float>(center.X()), static_cast<float>(center.Y())};
-	glUniform2fv(centerI, 1, c);
+	RenderCommands::Uniform2fv(centerI, c);
 	
 	GLfloat a[2] = {static_cast<float>(angle.X()), static_cast<float>(angle.Y())};
-	glUniform2fv(angleI, 1, a);
+	RenderCommands::Uniform2fv(angleI, a);
 	
 	GLfloat size[2] = {width, height};
-	glUniform2fv(sizeI, 1, size);
+	RenderCommands::Uniform2fv(sizeI, size);
 	
-	glUniform1f(offsetI, offset);
+	RenderCommands::Uniform1f(offsetI, offset);
 	
-	glUniform4fv(colorI, 1, color.Get());
+	RenderCommands::Uniform4fv(colorI, color.Get());
 	
-	glDrawArrays(GL_TRIANGLES, 0, 3);
+	RenderCommands::DrawArrays(GL_TRIANGLES, 0, 3);
 }
 
 
 
 void PointerShader::Unbind()
 {
-	glBindVertexArray(0);
-	glUseProgram(0);
+	RenderCommands::BindVertexArray(0);
+	RenderCommands::UseProgram(0);
 }
@@ -26,6 +26,10 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 using namespace std;
 
+namespace {
+	const unsigned BITS = 64;
+}
+
 
 
 // Reset to the initial political state defined in the game data.
@@ -42,11 +46,59 @@ void Politics::Reset()
 	// were already checked for when you first landed).
 	for(const auto &it : GameData::Governments())
 		fined.insert(&it.second);
+	
+	UpdateAttitudes();
 }
 
 
 
 bool Politics::IsEnemy(const Government *first, const Government *second) const
+{
+	unsigned firstId = first->GetId();
+	unsigned secondId = second->GetId();
+	if(firstId < governmentCount && secondId < governmentCount)
+		return (hostility[firstId * rowSize + secondId / BITS] >> (secondId % BITS)) & 1;
+	
+	return FindIsEnemy(first, second);
+}
+
+
+
+// Recompute which governments are enemies of each other. This must be done
+// whenever the governments' attitudes toward each other may have changed.
+void Politics::UpdateAttitudes()
+{
+	governmentCount = 0;
+	for(const auto &it : GameData::Governments())
+		governmentCount = max(governmentCount, it.second.GetId() + 1);
+	rowSize = (governmentCount + BITS - 1) / BITS;
+	hostility.assign(governmentCount * rowSize, 0);
+	
+	for(const auto &it : GameData::Governments())
+		for(const auto &oit : GameData::Governments())
+		{
+			unsigned secondId = oit.second.GetId();
+			if(FindIsEnemy(&it.second, &oit.second))
+				hostility[it.second.GetId() * rowSize + secondId / BITS] |= uint64_t(1) << (secondId % BITS);
+		}
+	++revision;
+}
+
+
+
+// Get a number that changes whenever any two governments become enemies or
+// stop being enemies, so that anything that caches who is hostile to whom
+// can tell when it needs to be recomputed.
+uint64_t Politics::Revision() const
+{
+	return revision;
+}
+
+
+
+// Check if the given governments are enemies without using the cached
+// hostility matrix.
+bool Politics::FindIsEnemy(const Government *first, const Government *second) const
 {
 	if(first == second)
 		return false;
@@ -73,6 +125,30 @@ bool Politics::IsEnemy(const Government *first, const Government *second) const
 
 
 
+// Recompute whether the given government is an enemy of the player.
+void Politics::UpdatePlayerHostility(const Government *gov)
+{
+	const Government *player = GameData::PlayerGovernment();
+	if(!player)
+		return;
+	unsigned playerId = player->GetId();
+	unsigned govId = gov->GetId();
+	if(playerId >= governmentCount || govId >= governmentCount)
+		return;
+	
+	uint64_t &playerBits = hostility[playerId * rowSize + govId / BITS];
+	uint64_t &govBits = hostility[govId * rowSize + playerId / BITS];
+	bool isEnemy = FindIsEnemy(player, gov);
+	if(((playerBits >> (govId % BITS)) & 1) == isEnemy)
+		return;
+	
+	playerBits ^= uint64_t(1) << (govId % BITS);
+	govBits ^= uint64_t(1) << (playerId % BITS);
+	++revision;
+}
+
+
+
 // Commit the given "offense" against the given government (which may not
 // actually consider it to be an offense). This may result in temporary
 // hostilities (if the even type is PROVOKE), or a permanent change to your
@@ -97,6 +173,7 @@ void Politics::Offend(const Government *gov, int eventType, int count)
 				// your bribe is cancelled out.
 				bribed.erase(other);
 				provoked.insert(other);
+				UpdatePlayerHostility(other);
 			}
 		}
 		else if(count && abs(weight) >= .05)
@@ -110,6 +187,7 @@ void Politics::Offend(const Government *gov, int eventType, int count)
 				reputationWith[other] = min(0., reputationWith[other]);
 			
 			reputationWith[other] -= penalty;
+			UpdatePlayerHostility(other);
 		}
 	}
 }
@@ -122,6 +200,7 @@ void Politics::Bribe(const Government *gov)
 	bribed.insert(gov);
 	provoked.erase(gov);
 	fined.insert(gov);
+	UpdatePlayerHostility(gov);
 }
 
 
@@ -311,6 +390,7 @@ double Politics::Reputation(const Government *gov) const
 void Politics::AddReputation(const Government *gov, double value)
 {
 	reputationWith[gov] += value;
+	UpdatePlayerHostility(gov);
 }
 
 
@@ -318,6 +398,7 @@ void Politics::AddReputation(const Government *gov, double value)
 void Politics::SetReputation(const Government *gov, double value)
 {
 	reputationWith[gov] = value;
+	UpdatePlayerHostility(gov);
 }
 
 
@@ -329,4 +410,7 @@ void Politics::ResetDaily()
 	bribed.clear();
 	bribedPlanets.clear();
 	fined.clear();
+	
+	for(const auto &it : GameData::Governments())
+		UpdatePlayerHostility(&it.second);
 }
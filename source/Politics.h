@@ -13,9 +13,11 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #ifndef POLITICS_H_
 #define POLITICS_H_
 
+#include <cstdint>
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 class Government;
 class Planet;
@@ -34,6 +36,13 @@ public:
 	void Reset();
 	
 	bool IsEnemy(const Government *first, const Government *second) const;
+	// Recompute which governments are enemies of each other. This must be done
+	// whenever the governments' attitudes toward each other may have changed.
+	void UpdateAttitudes();
+	// Get a number that changes whenever any two governments become enemies or
+	// stop being enemies, so that anything that caches who is hostile to whom
+	// can tell when it needs to be recomputed.
+	uint64_t Revision() const;
 	
 	// Commit the given "offense" against the given government (which may not
 	// actually consider it to be an offense). This may result in temporary
@@ -66,6 +75,14 @@ public:
 	void ResetDaily();
 	
 	
+private:
+	// Check if the given governments are enemies without using the cached
+	// hostility matrix.
+	bool FindIsEnemy(const Government *first, const Government *second) const;
+	// Recompute whether the given government is an enemy of the player.
+	void UpdatePlayerHostility(const Government *gov);
+	
+	
 private:
 	// attitude[target][other] stores how much an action toward the given target
 	// government will affect your reputation with the given other government.
@@ -78,6 +95,15 @@ private:
 	std::map<const Planet *, bool> bribedPlanets;
 	std::set<const Planet *> dominatedPlanets;
 	std::set<const Government *> fined;
+	
+	// Whether each pair of governments are enemies, stored as one row of bits
+	// per government ID: the bit for the second government in the first one's
+	// row is set if they are enemies. Governments created since the matrix was
+	// built are not in it.
+	std::vector<uint64_t> hostility;
+	unsigned governmentCount = 0;
+	unsigned rowSize = 0;
+	uint64_t revision = 0;
 };
 
 
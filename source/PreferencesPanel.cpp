@@ -24,6 +24,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Interface.h"
 #include "text/layout.hpp"
 #include "Preferences.h"
+#include "RenderCommands.h"
 #include "Screen.h"
 #include "Sprite.h"
 #include "SpriteSet.h"
@@ -75,7 +76,7 @@ PreferencesPanel::PreferencesPanel()
 // Draw this panel.
 void PreferencesPanel::Draw()
 {
-	glClear(GL_COLOR_BUFFER_BIT);
+	RenderCommands::Clear(GL_COLOR_BUFFER_BIT);
 	GameData::Background().Draw(Point(), Point());
 	
 	Information info;
@@ -0,0 +1,213 @@
+/* Profiler.cpp
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace {
+	class Phase {
+	public:
+		explicit Phase(const string &name) : name(name) {}
+		
+		string name;
+		double total = 0.;
+		int count = 0;
+		// The time spent on each individual item in this phase, if any.
+		vector<pair<double, string>> items;
+	};
+	
+	atomic<bool> enabled(false);
+#ifdef ES_COUNT_ALLOCATIONS
+	// Each thread counts its own allocations, so that they can be counted
+	// without any locking, and so that allocations made by other threads do
+	// not affect the count.
+	thread_local uint64_t allocations = 0;
+#endif
+	mutex profileMutex;
+	// Phases are kept in the order in which they are first recorded.
+	vector<Phase> phases;
+	
+	Phase &GetPhase(const string &name)
+	{
+		auto it = find_if(phases.begin(), phases.end(),
+			[&name](const Phase &phase) noexcept -> bool { return phase.name == name; });
+		if(it != phases.end())
+			return *it;
+		
+		phases.emplace_back(name);
+		return phases.back();
+	}
+	
+#ifdef ES_COUNT_ALLOCATIONS
+	void *Allocate(size_t size) noexcept
+	{
+		if(enabled.load(memory_order_relaxed))
+			++allocations;
+		// Allocating zero bytes must still return a unique pointer.
+		return malloc(size ? size : 1);
+	}
+#endif
+}
+
+
+
+#ifdef ES_COUNT_ALLOCATIONS
+// Replace the global allocation functions, so that allocations can be counted.
+// All the other forms of "new" and "delete" use these by default. This adds a
+// little overhead to every allocation, so the game itself does not do this.
+void *operator new(size_t size)
+{
+	void *result = Allocate(size);
+	while(!result)
+	{
+		// If there is a handler for running out of memory, it may be able to
+		// free some up. Otherwise, report the failure.
+		new_handler handler = get_new_handler();
+		if(!handler)
+			throw bad_alloc();
+		handler();
+		result = Allocate(size);
+	}
+	return result;
+}
+
+
+
+void *operator new(size_t size, const nothrow_t &) noexcept
+{
+	return Allocate(size);
+}
+
+
+
+void operator delete(void *pointer) noexcept
+{
+	free(pointer);
+}
+
+
+
+void operator delete(void *pointer, const nothrow_t &) noexcept
+{
+	free(pointer);
+}
+#endif
+
+
+
+void Profiler::Enable()
+{
+	enabled = true;
+}
+
+
+
+bool Profiler::IsEnabled()
+{
+	return enabled;
+}
+
+
+
+// Add the given number of seconds to the total for the given phase.
+void Profiler::Add(const string &phase, double seconds)
+{
+	if(!enabled)
+		return;
+	
+	lock_guard<mutex> lock(profileMutex);
+	Phase &it = GetPhase(phase);
+	it.total += seconds;
+	++it.count;
+}
+
+
+
+// Add the time spent on a single item to the total for the given phase, and
+// remember it so the slowest items in that phase can be reported.
+void Profiler::Add(const string &phase, const string &item, double seconds)
+{
+	if(!enabled)
+		return;
+	
+	lock_guard<mutex> lock(profileMutex);
+	Phase &it = GetPhase(phase);
+	it.total += seconds;
+	++it.count;
+	it.items.emplace_back(seconds, item);
+}
+
+
+
+// Get the number of times that the calling thread has allocated memory with
+// "new" (including in standard containers) while the profiler was enabled.
+bool Profiler::CountsAllocations()
+{
+#ifdef ES_COUNT_ALLOCATIONS
+	return true;
+#else
+	return false;
+#endif
+}
+
+
+
+uint64_t Profiler::Allocations()
+{
+#ifdef ES_COUNT_ALLOCATIONS
+	return allocations;
+#else
+	return 0;
+#endif
+}
+
+
+
+// Print the total time for each phase, followed by the slowest items in each
+// phase that recorded individual items.
+void Profiler::Print(ostream &out, size_t slowest)
+{
+	lock_guard<mutex> lock(profileMutex);
+	ios_base::fmtflags flags = out.flags();
+	streamsize precision = out.precision();
+	out << fixed << setprecision(3);
+	out << "phase" << '\t' << "seconds" << '\t' << "count" << '\n';
+	for(const Phase &phase : phases)
+		out << phase.name << '\t' << phase.total << '\t' << phase.count << '\n';
+	
+	for(Phase &phase : phases)
+	{
+		if(phase.items.empty())
+			continue;
+		
+		size_t count = min(slowest, phase.items.size());
+		partial_sort(phase.items.begin(), phase.items.begin() + count, phase.items.end(),
+			greater<pair<double, string>>());
+		out << '\n' << "slowest: " << phase.name << '\n';
+		for(size_t i = 0; i < count; ++i)
+			out << phase.items[i].first << '\t' << phase.items[i].second << '\n';
+	}
+	out.flags(flags);
+	out.precision(precision);
+	out.flush();
+}
@@ -0,0 +1,59 @@
+/* Profiler.h
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+
+
+// Class for collecting the time spent in each phase of some lengthy work (such
+// as loading the game data and sprites at startup), along with the time spent
+// on each individual item (e.g. a data file or a sprite) within a phase, so
+// that a report of where the time went can be printed. In builds that define
+// ES_COUNT_ALLOCATIONS (such as the unit tests), it also counts how many times
+// each thread allocates memory, so that code that should not need to allocate
+// any can be checked. Nothing is recorded unless the profiler has been enabled.
+// This class is thread-safe.
+class Profiler {
+public:
+	static void Enable();
+	static bool IsEnabled();
+	
+	// Add the given number of seconds to the total for the given phase.
+	static void Add(const std::string &phase, double seconds);
+	// Add the time spent on a single item to the total for the given phase,
+	// and remember it so the slowest items in that phase can be reported.
+	static void Add(const std::string &phase, const std::string &item, double seconds);
+	
+	// Check whether this build counts allocations. If not, Allocations()
+	// always returns 0.
+	static bool CountsAllocations();
+	// Get the number of times that the calling thread has allocated memory
+	// with "new" (including in standard containers) while the profiler was
+	// enabled. Compare this before and after some code to find out how many
+	// allocations that code made.
+	static uint64_t Allocations();
+	
+	// Print the total time for each phase (in the order in which they were
+	// first recorded), followed by the given number of slowest items in each
+	// phase that recorded individual items.
+	static void Print(std::ostream &out, size_t slowest = 10);
+};
+
+
+
+#endif
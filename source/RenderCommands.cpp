@@ -0,0 +1,374 @@
+/* RenderCommands.cpp
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "RenderCommands.h"
+
+#include "gl_header.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+using namespace std;
+
+namespace {
+	class Record {
+	public:
+		RenderCommands::Command command;
+		// Where this command's data starts in the recorded data.
+		size_t offset = 0;
+	};
+	
+	// Nothing can be drawn until the game window installs its backend.
+	RenderCommands::Backend *backend = nullptr;
+	
+	// The commands that have not been carried out yet. The memory for them is
+	// kept from one frame to the next.
+	vector<Record> records;
+	vector<char> data;
+	
+	RenderCommands::Command Make(RenderCommands::Type type, uint32_t a = 0, uint32_t b = 0,
+		uint32_t c = 0, uint32_t d = 0)
+	{
+		RenderCommands::Command command;
+		command.type = type;
+		command.args[0] = a;
+		command.args[1] = b;
+		command.args[2] = c;
+		command.args[3] = d;
+		return command;
+	}
+	
+	// Record a command, along with a copy of its data.
+	void Add(RenderCommands::Command command, const void *source = nullptr, size_t size = 0)
+	{
+		records.emplace_back();
+		records.back().command = command;
+		records.back().command.size = source ? size : 0;
+		if(!source || !size)
+			return;
+		
+		// Keep all the data aligned, since it is read back as floats and ints.
+		size_t offset = (data.size() + 3) & ~static_cast<size_t>(3);
+		data.resize(offset + size);
+		memcpy(data.data() + offset, source, size);
+		records.back().offset = offset;
+	}
+	
+	// Carry out a command with an image, without copying it.
+	void Upload(RenderCommands::Type type, uint32_t target, uint32_t xOrFormat, int y, int z,
+		int width, int height, int depth, uint32_t format, uint32_t dataType, const void *pixels)
+	{
+		RenderCommands::Command command = Make(type, target, xOrFormat, y, z);
+		command.args[4] = width;
+		command.args[5] = height;
+		command.args[6] = depth;
+		command.args[7] = format;
+		command.args[8] = dataType;
+		if(pixels)
+		{
+			size_t channels = (format == GL_RED ? 1 : format == GL_RG ? 2 : format == GL_RGB ? 3 : 4);
+			command.size = channels * width * height * max(1, depth);
+		}
+		
+		// Everything that was recorded before this must be done first.
+		RenderCommands::Execute();
+		backend->Execute(command, pixels);
+	}
+}
+
+
+
+// Carry out all future commands with the given backend, which may be null.
+// Any commands that were recorded before this are carried out by the
+// previous backend first.
+void RenderCommands::SetBackend(Backend *newBackend)
+{
+	Execute();
+	backend = newBackend;
+}
+
+
+
+// Carry out all the recorded commands, in the order they were recorded.
+void RenderCommands::Execute()
+{
+	// If there is no backend yet, keep the commands until there is one.
+	if(!backend)
+		return;
+	
+	for(const Record &record : records)
+		backend->Execute(record.command, record.command.size ? data.data() + record.offset : nullptr);
+	records.clear();
+	data.clear();
+}
+
+
+
+uint32_t RenderCommands::GenVertexArray()
+{
+	return backend->Create(Object::VERTEX_ARRAY);
+}
+
+
+
+uint32_t RenderCommands::GenBuffer()
+{
+	return backend->Create(Object::BUFFER);
+}
+
+
+
+uint32_t RenderCommands::GenTexture()
+{
+	return backend->Create(Object::TEXTURE);
+}
+
+
+
+void RenderCommands::DeleteTexture(uint32_t texture)
+{
+	Add(Make(Type::DELETE_TEXTURE, texture));
+}
+
+
+
+void RenderCommands::DeleteBuffer(uint32_t buffer)
+{
+	Add(Make(Type::DELETE_BUFFER, buffer));
+}
+
+
+
+// Compile and link a shader program. This throws an exception if the
+// program is not valid.
+uint32_t RenderCommands::CompileProgram(const char *vertex, const char *fragment)
+{
+	return backend->CompileProgram(vertex, fragment);
+}
+
+
+
+// Get the location of an attribute or uniform, or -1 if it is not found.
+int32_t RenderCommands::GetAttribLocation(uint32_t program, const char *name)
+{
+	return backend->GetLocation(program, name, true);
+}
+
+
+
+int32_t RenderCommands::GetUniformLocation(uint32_t program, const char *name)
+{
+	return backend->GetLocation(program, name, false);
+}
+
+
+
+int32_t RenderCommands::GetInteger(uint32_t name)
+{
+	return backend->GetInteger(name);
+}
+
+
+
+void RenderCommands::UseProgram(uint32_t program)
+{
+	Add(Make(Type::USE_PROGRAM, program));
+}
+
+
+
+void RenderCommands::BindVertexArray(uint32_t vertexArray)
+{
+	Add(Make(Type::BIND_VERTEX_ARRAY, vertexArray));
+}
+
+
+
+void RenderCommands::BindBuffer(uint32_t target, uint32_t buffer)
+{
+	Add(Make(Type::BIND_BUFFER, target, buffer));
+}
+
+
+
+void RenderCommands::BindTexture(uint32_t target, uint32_t texture)
+{
+	Add(Make(Type::BIND_TEXTURE, target, texture));
+}
+
+
+
+void RenderCommands::TexParameteri(uint32_t target, uint32_t name, int32_t value)
+{
+	Add(Make(Type::TEXTURE_PARAMETERS, target, name), &value, sizeof(value));
+}
+
+
+
+// This is only for parameters with four values, such as the swizzle.
+void RenderCommands::TexParameteriv(uint32_t target, uint32_t name, const int32_t *values)
+{
+	Add(Make(Type::TEXTURE_PARAMETERS, target, name), values, 4 * sizeof(int32_t));
+}
+
+
+
+// The data is copied, so it does not need to outlive this call.
+void RenderCommands::BufferData(uint32_t target, size_t size, const void *data, uint32_t usage)
+{
+	Add(Make(Type::BUFFER_DATA, target, usage), data, size);
+}
+
+
+
+// Images are uploaded immediately (after all the commands that came before
+// them), rather than being copied, because they may be very large. The data
+// may be null to allocate a texture without initializing it.
+void RenderCommands::TexImage2D(uint32_t target, uint32_t internalFormat, int width, int height,
+	uint32_t format, uint32_t type, const void *data)
+{
+	Upload(Type::TEXTURE_IMAGE, target, internalFormat, 0, 0, width, height, 0, format, type, data);
+}
+
+
+
+void RenderCommands::TexImage3D(uint32_t target, uint32_t internalFormat, int width, int height, int depth,
+	uint32_t format, uint32_t type, const void *data)
+{
+	Upload(Type::TEXTURE_IMAGE, target, internalFormat, 0, 0, width, height, depth, format, type, data);
+}
+
+
+
+void RenderCommands::TexSubImage2D(uint32_t target, int x, int y, int width, int height,
+	uint32_t format, uint32_t type, const void *data)
+{
+	Upload(Type::TEXTURE_SUBIMAGE, target, x, y, 0, width, height, 0, format, type, data);
+}
+
+
+
+void RenderCommands::TexSubImage3D(uint32_t target, int x, int y, int z, int width, int height, int depth,
+	uint32_t format, uint32_t type, const void *data)
+{
+	Upload(Type::TEXTURE_SUBIMAGE, target, x, y, z, width, height, depth, format, type, data);
+}
+
+
+
+void RenderCommands::EnableVertexAttribArray(uint32_t index)
+{
+	Add(Make(Type::ENABLE_ATTRIBUTE_ARRAY, index));
+}
+
+
+
+void RenderCommands::VertexAttribPointer(uint32_t index, int size, uint32_t type, bool normalized, int stride, size_t offset)
+{
+	Command command = Make(Type::ATTRIBUTE_POINTER, index, size, type, normalized);
+	command.args[4] = stride;
+	command.args[5] = offset;
+	Add(command);
+}
+
+
+
+void RenderCommands::VertexAttribDivisor(uint32_t index, uint32_t divisor)
+{
+	Add(Make(Type::ATTRIBUTE_DIVISOR, index, divisor));
+}
+
+
+
+void RenderCommands::VertexAttrib1fv(uint32_t index, const float *values)
+{
+	Add(Make(Type::ATTRIBUTE, index), values, sizeof(float));
+}
+
+
+
+void RenderCommands::VertexAttrib2fv(uint32_t index, const float *values)
+{
+	Add(Make(Type::ATTRIBUTE, index), values, 2 * sizeof(float));
+}
+
+
+
+void RenderCommands::VertexAttrib4fv(uint32_t index, const float *values)
+{
+	Add(Make(Type::ATTRIBUTE, index), values, 4 * sizeof(float));
+}
+
+
+
+void RenderCommands::Uniform1i(int32_t location, int32_t value)
+{
+	Add(Make(Type::UNIFORM_INT, location, value));
+}
+
+
+
+void RenderCommands::Uniform1f(int32_t location, float value)
+{
+	Add(Make(Type::UNIFORM_FLOATS, location), &value, sizeof(float));
+}
+
+
+
+void RenderCommands::Uniform2f(int32_t location, float x, float y)
+{
+	float values[2] = {x, y};
+	Add(Make(Type::UNIFORM_FLOATS, location), values, sizeof(values));
+}
+
+
+
+void RenderCommands::Uniform2fv(int32_t location, const float *values)
+{
+	Add(Make(Type::UNIFORM_FLOATS, location), values, 2 * sizeof(float));
+}
+
+
+
+void RenderCommands::Uniform4fv(int32_t location, const float *values)
+{
+	Add(Make(Type::UNIFORM_FLOATS, location), values, 4 * sizeof(float));
+}
+
+
+
+void RenderCommands::UniformMatrix2fv(int32_t location, const float *values)
+{
+	Add(Make(Type::UNIFORM_MATRIX, location), values, 4 * sizeof(float));
+}
+
+
+
+void RenderCommands::DrawArrays(uint32_t mode, int first, int count)
+{
+	Add(Make(Type::DRAW_ARRAYS, mode, first, count));
+}
+
+
+
+void RenderCommands::DrawArraysInstanced(uint32_t mode, int first, int count, int instances)
+{
+	Add(Make(Type::DRAW_ARRAYS_INSTANCED, mode, first, count, instances));
+}
+
+
+
+void RenderCommands::Clear(uint32_t mask)
+{
+	Add(Make(Type::CLEAR, mask));
+}
@@ -0,0 +1,160 @@
+/* RenderCommands.h
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef RENDER_COMMANDS_H_
+#define RENDER_COMMANDS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+
+
+// Class that records the commands that the drawing classes (the shaders, the
+// star field, and the fonts) issue, instead of them calling OpenGL directly.
+// The recorded commands are carried out by a "backend," once a frame has been
+// completely built. Normally, that backend is OpenGL, but a different one can
+// be used, e.g. to count the draw calls in a frame without needing a graphics
+// card. The commands correspond to the OpenGL functions of the same names, and
+// take the same arguments. This class must only be used from the main thread.
+class RenderCommands {
+public:
+	enum class Type : uint8_t {
+		USE_PROGRAM,
+		BIND_VERTEX_ARRAY,
+		BIND_BUFFER,
+		BIND_TEXTURE,
+		TEXTURE_PARAMETERS,
+		DELETE_TEXTURE,
+		DELETE_BUFFER,
+		BUFFER_DATA,
+		TEXTURE_IMAGE,
+		TEXTURE_SUBIMAGE,
+		ENABLE_ATTRIBUTE_ARRAY,
+		ATTRIBUTE_POINTER,
+		ATTRIBUTE_DIVISOR,
+		ATTRIBUTE,
+		UNIFORM_INT,
+		UNIFORM_FLOATS,
+		UNIFORM_MATRIX,
+		DRAW_ARRAYS,
+		DRAW_ARRAYS_INSTANCED,
+		CLEAR
+	};
+	
+	class Command {
+	public:
+		Type type = Type::CLEAR;
+		// The arguments, in the same order as for the corresponding OpenGL call,
+		// leaving out any that are given as data. Texture images always have
+		// three dimensions (the depth of a 2D image is zero), so their arguments
+		// are the target, then the internal format (for an image) or the x, y,
+		// and z offsets (for a subimage), then the width, height, and depth, and
+		// then the format and type of the data.
+		uint32_t args[9] = {};
+		// How many bytes of data go along with this command (e.g. the values of
+		// a uniform, the contents of a buffer, or an image).
+		size_t size = 0;
+	};
+	
+	// The kinds of objects that can be created.
+	enum class Object : uint8_t {
+		VERTEX_ARRAY,
+		BUFFER,
+		TEXTURE
+	};
+	
+	// Interface for something that carries out the commands.
+	class Backend {
+	public:
+		virtual ~Backend() = default;
+		
+		// Carry out the given command. If it has any data, that is given
+		// separately, and is only valid until this function returns.
+		virtual void Execute(const Command &command, const void *data) = 0;
+		
+		// These functions are called immediately, rather than being recorded,
+		// because their results are needed right away.
+		virtual uint32_t Create(Object object) = 0;
+		virtual uint32_t CompileProgram(const char *vertex, const char *fragment) = 0;
+		virtual int32_t GetLocation(uint32_t program, const char *name, bool isAttribute) = 0;
+		virtual int32_t GetInteger(uint32_t name) = 0;
+	};
+
+
+public:
+	// Carry out all future commands with the given backend, which may be null.
+	// There is no backend until the game window installs one for OpenGL. Any
+	// commands that were recorded before this are carried out by the previous
+	// backend first.
+	static void SetBackend(Backend *backend);
+	// Carry out all the recorded commands, in the order they were recorded.
+	static void Execute();
+	
+	// Objects are created immediately, so that their names can be used in the
+	// commands that follow. Deleting an object is recorded, because commands
+	// that were recorded earlier may still use it.
+	static uint32_t GenVertexArray();
+	static uint32_t GenBuffer();
+	static uint32_t GenTexture();
+	static void DeleteTexture(uint32_t texture);
+	static void DeleteBuffer(uint32_t buffer);
+	// Compile and link a shader program. This throws an exception if the
+	// program is not valid.
+	static uint32_t CompileProgram(const char *vertex, const char *fragment);
+	// Get the location of an attribute or uniform, or -1 if it is not found.
+	static int32_t GetAttribLocation(uint32_t program, const char *name);
+	static int32_t GetUniformLocation(uint32_t program, const char *name);
+	static int32_t GetInteger(uint32_t name);
+	
+	static void UseProgram(uint32_t program);
+	static void BindVertexArray(uint32_t vertexArray);
+	static void BindBuffer(uint32_t target, uint32_t buffer);
+	static void BindTexture(uint32_t target, uint32_t texture);
+	static void TexParameteri(uint32_t target, uint32_t name, int32_t value);
+	// This is only for parameters with four values, such as the swizzle.
+	static void TexParameteriv(uint32_t target, uint32_t name, const int32_t *values);
+	// The data is copied, so it does not need to outlive this call.
+	static void BufferData(uint32_t target, size_t size, const void *data, uint32_t usage);
+	// Images are uploaded immediately (after all the commands that came before
+	// them), rather than being copied, because they may be very large. The data
+	// may be null to allocate a texture without initializing it.
+	static void TexImage2D(uint32_t target, uint32_t internalFormat, int width, int height,
+		uint32_t format, uint32_t type, const void *data);
+	static void TexImage3D(uint32_t target, uint32_t internalFormat, int width, int height, int depth,
+		uint32_t format, uint32_t type, const void *data);
+	static void TexSubImage2D(uint32_t target, int x, int y, int width, int height,
+		uint32_t format, uint32_t type, const void *data);
+	static void TexSubImage3D(uint32_t target, int x, int y, int z, int width, int height, int depth,
+		uint32_t format, uint32_t type, const void *data);
+	
+	static void EnableVertexAttribArray(uint32_t index);
+	static void VertexAttribPointer(uint32_t index, int size, uint32_t type, bool normalized, int stride, size_t offset);
+	static void VertexAttribDivisor(uint32_t index, uint32_t divisor);
+	static void VertexAttrib1fv(uint32_t index, const float *values);
+	static void VertexAttrib2fv(uint32_t index, const float *values);
+	static void VertexAttrib4fv(uint32_t index, const float *values);
+	
+	static void Uniform1i(int32_t location, int32_t value);
+	static void Uniform1f(int32_t location, float value);
+	static void Uniform2f(int32_t location, float x, float y);
+	static void Uniform2fv(int32_t location, const float *values);
+	static void Uniform4fv(int32_t location, const float *values);
+	static void UniformMatrix2fv(int32_t location, const float *values);
+	
+	static void DrawArrays(uint32_t mode, int first, int count);
+	static void DrawArraysInstanced(uint32_t mode, int first, int count, int instances);
+	static void Clear(uint32_t mask);
+};
+
+
+
+#endif
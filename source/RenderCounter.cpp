@@ -0,0 +1,97 @@
+/* RenderCounter.cpp
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "RenderCounter.h"
+
+using namespace std;
+
+using Type = RenderCommands::Type;
+
+
+
+void RenderCounter::Execute(const RenderCommands::Command &command, const void *data)
+{
+	switch(command.type)
+	{
+		case Type::DRAW_ARRAYS:
+			++drawCalls;
+			vertices += command.args[2];
+			break;
+		case Type::DRAW_ARRAYS_INSTANCED:
+			++drawCalls;
+			vertices += static_cast<size_t>(command.args[2]) * command.args[3];
+			break;
+		case Type::ATTRIBUTE:
+		case Type::UNIFORM_INT:
+		case Type::UNIFORM_FLOATS:
+		case Type::UNIFORM_MATRIX:
+			++uniforms;
+			break;
+		case Type::BUFFER_DATA:
+		case Type::TEXTURE_IMAGE:
+		case Type::TEXTURE_SUBIMAGE:
+			bytes += command.size;
+			break;
+		case Type::CLEAR:
+		case Type::DELETE_TEXTURE:
+		case Type::DELETE_BUFFER:
+			break;
+		default:
+			++stateChanges;
+			break;
+	}
+}
+
+
+
+// Objects and programs get names that are unique, but do not refer to
+// anything.
+uint32_t RenderCounter::Create(RenderCommands::Object object)
+{
+	return nextName++;
+}
+
+
+
+uint32_t RenderCounter::CompileProgram(const char *vertex, const char *fragment)
+{
+	return nextName++;
+}
+
+
+
+// Every attribute and uniform is treated as existing, so that the shaders can
+// be set up the same way as with a real backend.
+int32_t RenderCounter::GetLocation(uint32_t program, const char *name, bool isAttribute)
+{
+	return 0;
+}
+
+
+
+// There are no limits to report, so the drawing code uses its defaults.
+int32_t RenderCounter::GetInteger(uint32_t name)
+{
+	return 0;
+}
+
+
+
+// Reset all the counts to zero.
+void RenderCounter::Clear()
+{
+	drawCalls = 0;
+	vertices = 0;
+	stateChanges = 0;
+	uniforms = 0;
+	bytes = 0;
+}
@@ -0,0 +1,58 @@
+/* RenderCounter.h
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef RENDER_COUNTER_H_
+#define RENDER_COUNTER_H_
+
+#include "RenderCommands.h"
+
+#include <cstddef>
+#include <cstdint>
+
+
+
+// A render backend that does not draw anything, but just counts the commands
+// that it is given. This makes it possible to measure how much work it takes
+// to build a frame, and how many draw calls and state changes that frame
+// needs, without a graphics card or even a window.
+class RenderCounter : public RenderCommands::Backend {
+public:
+	virtual void Execute(const RenderCommands::Command &command, const void *data) override;
+	virtual uint32_t Create(RenderCommands::Object object) override;
+	virtual uint32_t CompileProgram(const char *vertex, const char *fragment) override;
+	virtual int32_t GetLocation(uint32_t program, const char *name, bool isAttribute) override;
+	virtual int32_t GetInteger(uint32_t name) override;
+	
+	// Reset all the counts to zero.
+	void Clear();
+
+
+public:
+	// The number of draw calls, and the number of vertices that they drew.
+	size_t drawCalls = 0;
+	size_t vertices = 0;
+	// Changes to which program, vertex array, buffer, or texture is bound, or
+	// to the texture parameters or vertex attribute layout.
+	size_t stateChanges = 0;
+	// Changes to uniforms or to constant vertex attributes.
+	size_t uniforms = 0;
+	// The number of bytes copied into buffers and textures.
+	size_t bytes = 0;
+
+
+private:
+	uint32_t nextName = 1;
+};
+
+
+
+#endif
@@ -15,6 +15,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Color.h"
 #include "pi.h"
 #include "Point.h"
+#include "RenderCommands.h"
 #include "Screen.h"
 #include "Shader.h"
 
@@ -94,11 +95,11 @@ void RingShader::Init()
 	colorI = shader.Uniform("color");
 	
 	// Generate the vertex data for drawing sprites.
-	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
+	vao = RenderCommands::GenVertexArray();
+	RenderCommands::BindVertexArray(vao);
 	
-	glGenBuffers(1, &vbo);
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	vbo = RenderCommands::GenBuffer();
+	RenderCommands::BindBuffer(GL_ARRAY_BUFFER, vbo);
 	
 	GLfloat vertexData[] = {
 		-1.f, -1.f,
@@ -106,14 +107,14 @@ void RingShader::Init()
 		 1.f, -1.f,
 		 1.f,  1.f
 	};
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertexData), vertexData, GL_STATIC_DRAW);
+	RenderCommands::BufferData(GL_ARRAY_BUFFER, sizeof(vertexData), vertexData, GL_STATIC_DRAW);
 	
-	glEnableVertexAttribArray(shader.Attrib("vert"));
-	glVertexAttribPointer(shader.Attrib("vert"), 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), nullptr);
+	RenderCommands::EnableVertexAttribArray(shader.Attrib("vert"));
+	RenderCommands::VertexAttribPointer(shader.Attrib("vert"), 2, GL_FLOAT, false, 2 * sizeof(GLfloat), 0);
 	
 	// unbind the VBO and VAO
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	RenderCommands::BindBuffer(GL_ARRAY_BUFFER, 0);
+	RenderCommands::BindVertexArray(0);
 }
 
 
@@ -142,11 +143,11 @@ void RingShader::Bind()
 	if(!shader.Object())
 		throw runtime_error("RingShader: Bind() called before Init().");
 	
-	glUseProgram(shader.Object());
-	glBindVertexArray(vao);
+	RenderCommands::UseProgram(shader.Object());
+	RenderCommands::BindVertexArray(vao);
 	
 	GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
-	glUniform2fv(scaleI, 1, scale);
+	RenderCommands::Uniform2fv(scaleI, scale);
 }
 
 
@@ -162,23 +163,23 @@ void RingShader::Add(const Point &pos, float out, float in, const Color &color)
 void RingShader::Add(const Point &pos, float radius, float width, float fraction, const Color &color, float dash, float startAngle)
 {
 	GLfloat position[2] = {static_cast<float>(pos.X()), static_cast<float>(pos.Y())};
-	glUniform2fv(positionI, 1, position);
+	RenderCommands::Uniform2fv(positionI, position);
 	
-	glUniform1f(radiusI, radius);
-	glUniform1f(widthI, width);
-	glUniform1f(angleI, fraction * 2. * PI);
-	glUniform1f(startAngleI, startAngle * TO_RAD);
-	glUniform1f(dashI, dash ? 2. * PI / dash : 0.);
+	RenderCommands::Uniform1f(radiusI, radius);
+	RenderCommands::Uniform1f(widthI, width);
+	RenderCommands::Uniform1f(angleI, fraction * 2. * PI);
+	RenderCommands::Uniform1f(startAngleI, startAngle * TO_RAD);
+	RenderCommands::Uniform1f(dashI, dash ? 2. * PI / dash : 0.);
 	
-	glUniform4fv(colorI, 1, color.Get());
+	RenderCommands::Uniform4fv(colorI, color.Get());
 	
-	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	RenderCommands::DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 }
 
 
 
 void RingShader::Unbind()
 {
-	glBindVertexArray(0);
-	glUseProgram(0);
+	RenderCommands::BindVertexArray(0);
+	RenderCommands::UseProgram(0);
 }
@@ -13,26 +13,42 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #ifndef SET_H_
 #define SET_H_
 
+#include <functional>
 #include <map>
 #include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
 
 
 
 // Template representing a set of named objects of a given type, where you can
 // query it for a pointer to any object and it will return one, whether or not that
 // object has been loaded yet. (This allows cyclic pointers.)
+// The objects are stored in a sorted map, so they never move in memory and
+// iterating over the set visits them in order of their names. Lookups by name
+// go through a hash index into that map instead of a tree search.
 template<class Type>
 class Set {
 public:
+	Set() = default;
+	// Copying a set must rebuild the index so that it points to the copy.
+	Set(const Set<Type> &other);
+	Set<Type> &operator=(const Set<Type> &other);
+	// Moving a set keeps the map's nodes where they are, so the index can be
+	// moved along with it.
+	Set(Set<Type> &&) = default;
+	Set<Type> &operator=(Set<Type> &&) = default;
+	
 	// Allow non-const access to the owner of this set; it can hand off only
 	// const references to avoid anyone else modifying the objects.
-	Type *Get(const std::string &name) { return &data[name]; }
-	const Type *Get(const std::string &name) const { return &data[name]; }
+	Type *Get(const std::string &name) { return Emplace(name); }
+	const Type *Get(const std::string &name) const { return Emplace(name); }
 	// If an item already exists in this set, get it. Otherwise, return a null
 	// pointer rather than creating the item.
 	const Type *Find(const std::string &name) const;
 	
-	bool Has(const std::string &name) const { return data.count(name); }
+	bool Has(const std::string &name) const { return index.count(&name); }
 	
 	typename std::map<std::string, Type>::iterator begin() { return data.begin(); }
 	typename std::map<std::string, Type>::const_iterator begin() const { return data.begin(); }
@@ -45,17 +61,58 @@ public:
 	void Revert(const Set<Type> &other);
 	
 	
+private:
+	// Hash and compare the index keys by the names they point to, so that a
+	// lookup can be done with a pointer to any string.
+	class NameHash {
+	public:
+		size_t operator()(const std::string *name) const { return std::hash<std::string>()(*name); }
+	};
+	class NameEqual {
+	public:
+		bool operator()(const std::string *a, const std::string *b) const { return *a == *b; }
+	};
+	
+	
+private:
+	// Get the item with the given name, creating it if it does not exist.
+	Type *Emplace(const std::string &name) const;
+	// Regenerate the index after the map has been copied.
+	void Reindex();
+	
+	
 private:
 	mutable std::map<std::string, Type> data;
+	// The keys and values of the index point into the nodes of the map above.
+	mutable std::unordered_map<const std::string *, Type *, NameHash, NameEqual> index;
 };
 
 
 
+template <class Type>
+Set<Type>::Set(const Set<Type> &other)
+	: data(other.data)
+{
+	Reindex();
+}
+
+
+
+template <class Type>
+Set<Type> &Set<Type>::operator=(const Set<Type> &other)
+{
+	data = other.data;
+	Reindex();
+	return *this;
+}
+
+
+
 template <class Type>
 const Type *Set<Type>::Find(const std::string &name) const
 {
-	auto it = data.find(name);
-	return (it == data.end() ? nullptr : &it->second);
+	auto it = index.find(&name);
+	return (it == index.end() ? nullptr : it->second);
 }
 
 
@@ -69,7 +126,10 @@ void Set<Type>::Revert(const Set<Type> &other)
 	while(it != data.end())
 	{
 		if(oit == other.data.end() || it->first < oit->first)
+		{
+			index.erase(&it->first);
 			it = data.erase(it);
+		}
 		else if(it->first == oit->first)
 		{
 			// If this is an entry that is in the set we are reverting to, copy
@@ -86,4 +146,29 @@ void Set<Type>::Revert(const Set<Type> &other)
 
 
 
+template <class Type>
+Type *Set<Type>::Emplace(const std::string &name) const
+{
+	auto it = index.find(&name);
+	if(it != index.end())
+		return it->second;
+	
+	auto &entry = *data.emplace(std::piecewise_construct, std::forward_as_tuple(name), std::forward_as_tuple()).first;
+	index.emplace(&entry.first, &entry.second);
+	return &entry.second;
+}
+
+
+
+template <class Type>
+void Set<Type>::Reindex()
+{
+	index.clear();
+	index.reserve(data.size());
+	for(auto &it : data)
+		index.emplace(&it.first, &it.second);
+}
+
+
+
 #endif
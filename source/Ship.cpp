@@ -12,6 +12,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "Ship.h"
 
+#include "Attribute.h"
 #include "Audio.h"
 #include "CategoryTypes.h"
 #include "DataNode.h"
@@ -40,6 +41,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <limits>
 #include <sstream>
 
@@ -157,6 +159,8 @@ void Ship::Load(const DataNode &node)
 	government = GameData::PlayerGovernment();
 	equipped.clear();
 	
+	MakeLoadoutUnique();
+	
 	// Note: I do not clear the attributes list here so that it is permissible
 	// to override one ship definition with another.
 	bool hasEngine = false;
@@ -192,11 +196,11 @@ void Ship::Load(const DataNode &node)
 		else if(key == "attributes" || add)
 		{
 			if(!add)
-				baseAttributes.Load(child);
+				loadout->baseAttributes.Load(child);
 			else
 			{
 				addAttributes = true;
-				attributes.Load(child);
+				loadout->attributes.Load(child);
 			}
 		}
 		else if((key == "engine" || key == "reverse engine" || key == "steering engine") && child.Size() >= 3)
@@ -391,14 +395,14 @@ void Ship::Load(const DataNode &node)
 		{
 			if(!hasOutfits)
 			{
-				outfits.clear();
+				loadout->outfits.clear();
 				hasOutfits = true;
 			}
 			for(const DataNode &grand : child)
 			{
 				int count = (grand.Size() >= 2) ? grand.Value(1) : 1;
 				if(count > 0)
-					outfits[GameData::Outfits().Get(grand.Token(0))] += count;
+					loadout->outfits[GameData::Outfits().Get(grand.Token(0))] += count;
 				else
 					grand.PrintTrace("Skipping invalid outfit count:");
 			}
@@ -447,14 +451,15 @@ void Ship::Load(const DataNode &node)
 // loaded yet. So, wait until everything has been loaded, then call this.
 void Ship::FinishLoading(bool isNewInstance)
 {
-	// All copies of this ship should save pointers to the "explosion" weapon
-	// definition stored safely in the ship model, which will not be destroyed
-	// until GameData is when the program quits. Also copy other attributes of
-	// the base model if no overrides were given.
+	MakeLoadoutUnique();
+	
+	// All copies of this ship should share the ship model's loadout, whose
+	// base attributes are the "explosion" weapon definition. Also copy other
+	// attributes of the base model if no overrides were given.
 	if(GameData::Ships().Has(modelName))
 	{
 		const Ship *model = GameData::Ships().Get(modelName);
-		explosionWeapon = &model->BaseAttributes();
+		modelLoadout = model->loadout;
 		if(pluralModelName.empty())
 			pluralModelName = model->pluralModelName;
 		if(noun.empty())
@@ -471,8 +476,8 @@ void Ship::FinishLoading(bool isNewInstance)
 			reinterpret_cast<Body &>(*this) = *base;
 		if(customSwizzle == -1)
 			customSwizzle = base->CustomSwizzle();
-		if(baseAttributes.Attributes().empty())
-			baseAttributes = base->baseAttributes;
+		if(loadout->baseAttributes.Attributes().empty())
+			loadout->baseAttributes = base->loadout->baseAttributes;
 		if(bays.empty() && !base->bays.empty())
 			bays = base->bays;
 		if(enginePoints.empty())
@@ -488,8 +493,8 @@ void Ship::FinishLoading(bool isNewInstance)
 		}
 		if(finalExplosions.empty())
 			finalExplosions = base->finalExplosions;
-		if(outfits.empty())
-			outfits = base->outfits;
+		if(loadout->outfits.empty())
+			loadout->outfits = base->loadout->outfits;
 		if(description.empty())
 			description = base->description;
 		
@@ -547,7 +552,7 @@ void Ship::FinishLoading(bool isNewInstance)
 	// warn if any non-weapon outfits are "installed" in a hardpoint.
 	for(auto &it : equipped)
 	{
-		int excess = it.second - outfits[it.first];
+		int excess = it.second - loadout->outfits[it.first];
 		if(excess > 0)
 		{
 			// If there are more hardpoints specifying this outfit than there
@@ -576,30 +581,30 @@ void Ship::FinishLoading(bool isNewInstance)
 	
 	// Mark any drone that has no "automaton" value as an automaton, to
 	// grandfather in the drones from before that attribute existed.
-	if(baseAttributes.Category() == "Drone" && !baseAttributes.Get("automaton"))
-		baseAttributes.Set("automaton", 1.);
+	if(loadout->baseAttributes.Category() == "Drone" && !loadout->baseAttributes.Get(Attribute::AUTOMATON))
+		loadout->baseAttributes.Set("automaton", 1.);
 	
-	baseAttributes.Set("gun ports", armament.GunCount());
-	baseAttributes.Set("turret mounts", armament.TurretCount());
+	loadout->baseAttributes.Set("gun ports", armament.GunCount());
+	loadout->baseAttributes.Set("turret mounts", armament.TurretCount());
 	
 	if(addAttributes)
 	{
 		// Store attributes from an "add attributes" node in the ship's
 		// baseAttributes so they can be written to the save file.
-		baseAttributes.Add(attributes);
+		loadout->baseAttributes.Add(loadout->attributes);
 		addAttributes = false;
 	}
 	// Add the attributes of all your outfits to the ship's base attributes.
-	attributes = baseAttributes;
+	loadout->attributes = loadout->baseAttributes;
 	vector<string> undefinedOutfits;
-	for(const auto &it : outfits)
+	for(const auto &it : loadout->outfits)
 	{
 		if(!it.first->IsDefined())
 		{
 			undefinedOutfits.emplace_back("\"" + it.first->Name() + "\"");
 			continue;
 		}
-		attributes.Add(*it.first, it.second);
+		loadout->attributes.Add(*it.first, it.second);
 		// Some ship variant definitions do not specify which weapons
 		// are placed in which hardpoint. Add any weapons that are not
 		// yet installed to the ship's armament.
@@ -644,7 +649,7 @@ void Ship::FinishLoading(bool isNewInstance)
 	{
 		const Outfit *outfit = hardpoint.GetOutfit();
 		if(outfit && outfit->IsDefined()
-				&& (hardpoint.IsTurret() != (outfit->Get("turret mounts") != 0.)))
+				&& (hardpoint.IsTurret() != (outfit->Get(Attribute::TURRET_MOUNTS) != 0.)))
 		{
 			string warning = (!isYours && !variantName.empty()) ? "variant \"" + variantName + "\"" : modelName;
 			if(!name.empty())
@@ -656,9 +661,10 @@ void Ship::FinishLoading(bool isNewInstance)
 			Files::LogError(warning);
 		}
 	}
-	cargo.SetSize(attributes.Get("cargo space"));
+	cargo.SetSize(loadout->attributes.Get(Attribute::CARGO_SPACE));
 	equipped.clear();
 	armament.FinishLoading();
+	UpdateDerivedStats();
 	
 	// Figure out how far from center the farthest hardpoint is.
 	weaponRadius = 0.;
@@ -690,20 +696,21 @@ void Ship::FinishLoading(bool isNewInstance)
 			bay.launchEffects.emplace_back(GameData::Effects().Get("basic launch"));
 	}
 	
-	canBeCarried = find(bayCategories.begin(), bayCategories.end(), attributes.Category()) != bayCategories.end();
+	canBeCarried = find(bayCategories.begin(), bayCategories.end(), loadout->attributes.Category()) != bayCategories.end();
 	
 	// Issue warnings if this ship has is misconfigured, e.g. is missing required values
 	// or has negative outfit, cargo, weapon, or engine capacity.
 	for(auto &&attr : set<string>{"outfit space", "cargo space", "weapon capacity", "engine capacity"})
 	{
-		double val = attributes.Get(attr);
+		double val = loadout->attributes.Get(attr);
 		if(val < 0)
 			warning += attr + ": " + Format::Number(val) + "\n";
 	}
-	if(attributes.Get("drag") <= 0.)
+	if(loadout->attributes.Get(Attribute::DRAG) <= 0.)
 	{
-		warning += "Defaulting " + string(attributes.Get("drag") ? "invalid" : "missing") + " \"drag\" attribute to 100.0\n";
-		attributes.Set("drag", 100.);
+		warning += "Defaulting " + string(loadout->attributes.Get(Attribute::DRAG) ? "invalid" : "missing") + " \"drag\" attribute to 100.0\n";
+		loadout->attributes.Set("drag", 100.);
+		UpdateDerivedStats();
 	}
 	if(!warning.empty())
 	{
@@ -712,7 +719,7 @@ void Ship::FinishLoading(bool isNewInstance)
 		string message = (!name.empty() ? "Ship \"" + name + "\" " : "") + "(" + VariantName() + "):\n";
 		ostringstream outfitNames;
 		outfitNames << "has outfits:\n";
-		for(const auto &it : outfits)
+		for(const auto &it : loadout->outfits)
 			outfitNames << '\t' << it.second << " " + it.first->Name() << endl;
 		Files::LogError(message + warning + outfitNames.str());
 	}
@@ -750,7 +757,7 @@ void Ship::FinishLoading(bool isNewInstance)
 // Check if this ship (model) and its outfits have been defined.
 bool Ship::IsValid() const
 {
-	for(auto &&outfit : outfits)
+	for(auto &&outfit : loadout->outfits)
 		if(!outfit.first->IsDefined())
 			return false;
 	
@@ -784,52 +791,52 @@ void Ship::Save(DataWriter &out) const
 		out.Write("attributes");
 		out.BeginChild();
 		{
-			out.Write("category", baseAttributes.Category());
-			out.Write("cost", baseAttributes.Cost());
-			out.Write("mass", baseAttributes.Mass());
-			for(const auto &it : baseAttributes.FlareSprites())
+			out.Write("category", loadout->baseAttributes.Category());
+			out.Write("cost", loadout->baseAttributes.Cost());
+			out.Write("mass", loadout->baseAttributes.Mass());
+			for(const auto &it : loadout->baseAttributes.FlareSprites())
 				for(int i = 0; i < it.second; ++i)
 					it.first.SaveSprite(out, "flare sprite");
-			for(const auto &it : baseAttributes.FlareSounds())
+			for(const auto &it : loadout->baseAttributes.FlareSounds())
 				for(int i = 0; i < it.second; ++i)
 					out.Write("flare sound", it.first->Name());
-			for(const auto &it : baseAttributes.ReverseFlareSprites())
+			for(const auto &it : loadout->baseAttributes.ReverseFlareSprites())
 				for(int i = 0; i < it.second; ++i)
 					it.first.SaveSprite(out, "reverse flare sprite");
-			for(const auto &it : baseAttributes.ReverseFlareSounds())
+			for(const auto &it : loadout->baseAttributes.ReverseFlareSounds())
 				for(int i = 0; i < it.second; ++i)
 					out.Write("reverse flare sound", it.first->Name());
-			for(const auto &it : baseAttributes.SteeringFlareSprites())
+			for(const auto &it : loadout->baseAttributes.SteeringFlareSprites())
 				for(int i = 0; i < it.second; ++i)
 					it.first.SaveSprite(out, "steering flare sprite");
-			for(const auto &it : baseAttributes.SteeringFlareSounds())
+			for(const auto &it : loadout->baseAttributes.SteeringFlareSounds())
 				for(int i = 0; i < it.second; ++i)
 					out.Write("steering flare sound", it.first->Name());
-			for(const auto &it : baseAttributes.AfterburnerEffects())
+			for(const auto &it : loadout->baseAttributes.AfterburnerEffects())
 				for(int i = 0; i < it.second; ++i)
 					out.Write("afterburner effect", it.first->Name());
-			for(const auto &it : baseAttributes.JumpEffects())
+			for(const auto &it : loadout->baseAttributes.JumpEffects())
 				for(int i = 0; i < it.second; ++i)
 					out.Write("jump effect", it.first->Name());
-			for(const auto &it : baseAttributes.JumpSounds())
+			for(const auto &it : loadout->baseAttributes.JumpSounds())
 				for(int i = 0; i < it.second; ++i)
 					out.Write("jump sound", it.first->Name());
-			for(const auto &it : baseAttributes.JumpInSounds())
+			for(const auto &it : loadout->baseAttributes.JumpInSounds())
 				for(int i = 0; i < it.second; ++i)
 					out.Write("jump in sound", it.first->Name());
-			for(const auto &it : baseAttributes.JumpOutSounds())
+			for(const auto &it : loadout->baseAttributes.JumpOutSounds())
 				for(int i = 0; i < it.second; ++i)
 					out.Write("jump out sound", it.first->Name());
-			for(const auto &it : baseAttributes.HyperSounds())
+			for(const auto &it : loadout->baseAttributes.HyperSounds())
 				for(int i = 0; i < it.second; ++i)
 					out.Write("hyperdrive sound", it.first->Name());
-			for(const auto &it : baseAttributes.HyperInSounds())
+			for(const auto &it : loadout->baseAttributes.HyperInSounds())
 				for(int i = 0; i < it.second; ++i)
 					out.Write("hyperdrive in sound", it.first->Name());
-			for(const auto &it : baseAttributes.HyperOutSounds())
+			for(const auto &it : loadout->baseAttributes.HyperOutSounds())
 				for(int i = 0; i < it.second; ++i)
 					out.Write("hyperdrive out sound", it.first->Name());
-			for(const auto &it : baseAttributes.Attributes())
+			for(const auto &it : loadout->baseAttributes.Attributes())
 				if(it.second)
 					out.Write(it.first, it.second);
 		}
@@ -839,7 +846,7 @@ void Ship::Save(DataWriter &out) const
 		out.BeginChild();
 		{
 			using OutfitElement = pair<const Outfit *const, int>;
-			WriteSorted(outfits,
+			WriteSorted(loadout->outfits,
 				[](const OutfitElement *lhs, const OutfitElement *rhs)
 					{ return lhs->first->Name() < rhs->first->Name(); },
 				[&out](const OutfitElement &it){
@@ -1033,7 +1040,7 @@ const Sprite *Ship::Thumbnail() const
 // Get this ship's cost.
 int64_t Ship::Cost() const
 {
-	return attributes.Cost();
+	return loadout->attributes.Cost();
 }
 
 
@@ -1041,7 +1048,7 @@ int64_t Ship::Cost() const
 // Get the cost of this ship's chassis, with no outfits installed.
 int64_t Ship::ChassisCost() const
 {
-	return baseAttributes.Cost();
+	return loadout->baseAttributes.Cost();
 }
 
 
@@ -1052,22 +1059,22 @@ vector<string> Ship::FlightCheck() const
 {
 	auto checks = vector<string>{};
 	
-	double generation = attributes.Get("energy generation") - attributes.Get("energy consumption");
-	double burning = attributes.Get("fuel energy");
-	double solar = attributes.Get("solar collection");
-	double battery = attributes.Get("energy capacity");
+	double generation = loadout->attributes.Get(Attribute::ENERGY_GENERATION) - loadout->attributes.Get(Attribute::ENERGY_CONSUMPTION);
+	double burning = loadout->attributes.Get(Attribute::FUEL_ENERGY);
+	double solar = loadout->attributes.Get(Attribute::SOLAR_COLLECTION);
+	double battery = loadout->attributes.Get(Attribute::ENERGY_CAPACITY);
 	double energy = generation + burning + solar + battery;
-	double fuelChange = attributes.Get("fuel generation") - attributes.Get("fuel consumption");
-	double fuelCapacity = attributes.Get("fuel capacity");
+	double fuelChange = loadout->attributes.Get(Attribute::FUEL_GENERATION) - loadout->attributes.Get(Attribute::FUEL_CONSUMPTION);
+	double fuelCapacity = loadout->attributes.Get(Attribute::FUEL_CAPACITY);
 	double fuel = fuelCapacity + fuelChange;
-	double thrust = attributes.Get("thrust");
-	double reverseThrust = attributes.Get("reverse thrust");
-	double afterburner = attributes.Get("afterburner thrust");
-	double thrustEnergy = attributes.Get("thrusting energy");
-	double turn = attributes.Get("turn");
-	double turnEnergy = attributes.Get("turning energy");
-	double hyperDrive = attributes.Get("hyperdrive");
-	double jumpDrive = attributes.Get("jump drive");
+	double thrust = loadout->attributes.Get(Attribute::THRUST);
+	double reverseThrust = loadout->attributes.Get(Attribute::REVERSE_THRUST);
+	double afterburner = loadout->attributes.Get(Attribute::AFTERBURNER_THRUST);
+	double thrustEnergy = loadout->attributes.Get(Attribute::THRUSTING_ENERGY);
+	double turn = loadout->attributes.Get(Attribute::TURN);
+	double turnEnergy = loadout->attributes.Get(Attribute::TURNING_ENERGY);
+	double hyperDrive = loadout->attributes.Get(Attribute::HYPERDRIVE);
+	double jumpDrive = loadout->attributes.Get(Attribute::JUMP_DRIVE);
 	
 	// Report the first error condition that will prevent takeoff:
 	if(IdleHeat() >= MaximumHeat())
@@ -1105,7 +1112,7 @@ vector<string> Ship::FlightCheck() const
 			if(fuelCapacity < JumpFuel())
 				checks.emplace_back("no fuel?");
 		}
-		for(const auto &it : outfits)
+		for(const auto &it : loadout->outfits)
 			if(it.first->IsWeapon() && it.first->FiringEnergy() > energy)
 			{
 				checks.emplace_back("insufficient energy to fire?");
@@ -1324,7 +1331,7 @@ void Ship::Move(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam)
 		return;
 	}
 	isInSystem = false;
-	if(!fuel || !(attributes.Get("hyperdrive") || attributes.Get("jump drive")))
+	if(!fuel || !(loadout->attributes.Get(Attribute::HYPERDRIVE) || loadout->attributes.Get(Attribute::JUMP_DRIVE)))
 		hyperspaceSystem = nullptr;
 	
 	// Adjust the error in the pilot's targeting.
@@ -1360,16 +1367,16 @@ void Ship::Move(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam)
 		if(!cloak)
 			cloakDisruption = max(0., cloakDisruption - 1.);
 		
-		double cloakingSpeed = attributes.Get("cloak");
+		double cloakingSpeed = loadout->attributes.Get(Attribute::CLOAK);
 		bool canCloak = (!isDisabled && cloakingSpeed > 0. && !cloakDisruption
-			&& fuel >= attributes.Get("cloaking fuel")
-			&& energy >= attributes.Get("cloaking energy"));
+			&& fuel >= loadout->attributes.Get(Attribute::CLOAKING_FUEL)
+			&& energy >= loadout->attributes.Get(Attribute::CLOAKING_ENERGY));
 		if(commands.Has(Command::CLOAK) && canCloak)
 		{
 			cloak = min(1., cloak + cloakingSpeed);
-			fuel -= attributes.Get("cloaking fuel");
-			energy -= attributes.Get("cloaking energy");
-			heat += attributes.Get("cloaking heat");
+			fuel -= loadout->attributes.Get(Attribute::CLOAKING_FUEL);
+			energy -= loadout->attributes.Get(Attribute::CLOAKING_ENERGY);
+			heat += loadout->attributes.Get(Attribute::CLOAKING_HEAT);
 		}
 		else if(cloakingSpeed)
 		{
@@ -1398,7 +1405,7 @@ void Ship::Move(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam)
 				double size = Width() + Height();
 				double scale = .03 * size + .5;
 				double radius = .2 * size;
-				int debrisCount = attributes.Mass() * .07;
+				int debrisCount = loadout->attributes.Mass() * .07;
 				
 				// Estimate how many new visuals will be added during destruction.
 				visuals.reserve(visuals.size() + debrisCount + explosionTotal + finalExplosions.size());
@@ -1423,7 +1430,7 @@ void Ship::Move(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam)
 				for(const auto &it : cargo.Outfits())
 					Jettison(it.first, Random::Binomial(it.second, .25));
 				// Ammunition has a 5% chance to survive as flotsam
-				for(const auto &it : outfits)
+				for(const auto &it : loadout->outfits)
 					if(it.first->Category() == "Ammunition")
 						Jettison(it.first, Random::Binomial(it.second, .05));
 				for(shared_ptr<Flotsam> &it : jettisoned)
@@ -1497,7 +1504,7 @@ void Ship::Move(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam)
 		if(isUsingJumpDrive && !forget)
 		{
 			double sparkAmount = hyperspaceCount * Width() * Height() * .000006;
-			const map<const Effect *, int> &jumpEffects = attributes.JumpEffects();
+			const map<const Effect *, int> &jumpEffects = loadout->attributes.JumpEffects();
 			if(jumpEffects.empty())
 				CreateSparks(visuals, "jump drive", sparkAmount);
 			else
@@ -1651,7 +1658,7 @@ void Ship::Move(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam)
 			}
 		}
 		// Only refuel if this planet has a spaceport.
-		else if(fuel >= attributes.Get("fuel capacity")
+		else if(fuel >= loadout->attributes.Get(Attribute::FUEL_CAPACITY)
 				|| !landingPlanet || !landingPlanet->HasSpaceport())
 		{
 			zoom = min(1.f, zoom + .02f);
@@ -1659,7 +1666,7 @@ void Ship::Move(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam)
 			landingPlanet = nullptr;
 		}
 		else
-			fuel = min(fuel + 1., attributes.Get("fuel capacity"));
+			fuel = min(fuel + 1., loadout->attributes.Get(Attribute::FUEL_CAPACITY));
 		
 		// Move the ship at the velocity it had when it began landing, but
 		// scaled based on how small it is now.
@@ -1677,7 +1684,7 @@ void Ship::Move(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam)
 	else if(commands.Has(Command::JUMP) && IsReadyToJump())
 	{
 		hyperspaceSystem = GetTargetSystem();
-		isUsingJumpDrive = !attributes.Get("hyperdrive") || !currentSystem->Links().count(hyperspaceSystem);
+		isUsingJumpDrive = !loadout->attributes.Get(Attribute::HYPERDRIVE) || !currentSystem->Links().count(hyperspaceSystem);
 		hyperspaceFuelCost = JumpFuel(hyperspaceSystem);
 	}
 	
@@ -1705,13 +1712,13 @@ void Ship::Move(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam)
 	double mass = Mass();
 	bool isUsingAfterburner = false;
 	if(isDisabled)
-		velocity *= 1. - attributes.Get("drag") / mass;
+		velocity *= 1. - loadout->attributes.Get(Attribute::DRAG) / mass;
 	else if(!pilotError)
 	{
 		if(commands.Turn())
 		{
 			// Check if we are able to turn.
-			double cost = attributes.Get("turning energy");
+			double cost = loadout->attributes.Get(Attribute::TURNING_ENERGY);
 			if(energy < cost * fabs(commands.Turn()))
 				commands.SetTurn(commands.Turn() * energy / (cost * fabs(commands.Turn())));
 			
@@ -1724,7 +1731,7 @@ void Ship::Move(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam)
 				// of the turning energy and produce a fraction of the heat.
 				double scale = fabs(commands.Turn());
 				energy -= scale * cost;
-				heat += scale * attributes.Get("turning heat");
+				heat += scale * loadout->attributes.Get(Attribute::TURNING_HEAT);
 				angle += commands.Turn() * TurnRate() * slowMultiplier;
 			}
 		}
@@ -1733,8 +1740,8 @@ void Ship::Move(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam)
 		if(thrustCommand)
 		{
 			// Check if we are able to apply this thrust.
-			double cost = attributes.Get((thrustCommand > 0.) ?
-				"thrusting energy" : "reverse thrusting energy");
+			double cost = loadout->attributes.Get((thrustCommand > 0.) ?
+				Attribute::THRUSTING_ENERGY : Attribute::REVERSE_THRUSTING_ENERGY);
 			if(energy < cost)
 				thrustCommand *= energy / cost;
 			
@@ -1743,13 +1750,13 @@ void Ship::Move(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam)
 				// If a reverse thrust is commanded and the capability does not
 				// exist, ignore it (do not even slow under drag).
 				isThrusting = (thrustCommand > 0.);
-				isReversing = !isThrusting && attributes.Get("reverse thrust");
-				thrust = attributes.Get(isThrusting ? "thrust" : "reverse thrust");
+				isReversing = !isThrusting && loadout->attributes.Get(Attribute::REVERSE_THRUST);
+				thrust = loadout->attributes.Get(isThrusting ? Attribute::THRUST : Attribute::REVERSE_THRUST);
 				if(thrust)
 				{
 					double scale = fabs(thrustCommand);
 					energy -= scale * cost;
-					heat += scale * attributes.Get(isThrusting ? "thrusting heat" : "reverse thrusting heat");
+					heat += scale * loadout->attributes.Get(isThrusting ? Attribute::THRUSTING_HEAT : Attribute::REVERSE_THRUSTING_HEAT);
 					acceleration += angle.Unit() * (thrustCommand * thrust / mass);
 				}
 			}
@@ -1758,12 +1765,12 @@ void Ship::Move(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam)
 				&& !CannotAct();
 		if(applyAfterburner)
 		{
-			thrust = attributes.Get("afterburner thrust");
-			double fuelCost = attributes.Get("afterburner fuel");
-			double energyCost = attributes.Get("afterburner energy");
+			thrust = loadout->attributes.Get(Attribute::AFTERBURNER_THRUST);
+			double fuelCost = loadout->attributes.Get(Attribute::AFTERBURNER_FUEL);
+			double energyCost = loadout->attributes.Get(Attribute::AFTERBURNER_ENERGY);
 			if(thrust && fuel >= fuelCost && energy >= energyCost)
 			{
-				heat += attributes.Get("afterburner heat");
+				heat += loadout->attributes.Get(Attribute::AFTERBURNER_HEAT);
 				fuel -= fuelCost;
 				energy -= energyCost;
 				acceleration += angle.Unit() * thrust / mass;
@@ -1776,7 +1783,7 @@ void Ship::Move(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam)
 	if(acceleration)
 	{
 		acceleration *= slowMultiplier;
-		Point dragAcceleration = acceleration - velocity * (attributes.Get("drag") / mass);
+		Point dragAcceleration = acceleration - velocity * (loadout->attributes.Get(Attribute::DRAG) / mass);
 		// Make sure dragAcceleration has nonzero length, to avoid divide by zero.
 		if(dragAcceleration)
 		{
@@ -1857,7 +1864,7 @@ void Ship::Move(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam)
 				{
 					isBoarding = false;
 					bool isEnemy = government->IsEnemy(target->government);
-					if(isEnemy && Random::Real() < target->Attributes().Get("self destruct"))
+					if(isEnemy && Random::Real() < target->Attributes().Get(Attribute::SELF_DESTRUCT))
 					{
 						Messages::Add("The " + target->ModelName() + " \"" + target->Name()
 							+ "\" has activated its self-destruct mechanism.");
@@ -1911,21 +1918,19 @@ void Ship::DoGeneration()
 		// 4. Shields of carried fighters
 		// 5. Transfer of excess energy and fuel to carried fighters.
 		
-		const double hullAvailable = attributes.Get("hull repair rate") * (1. + attributes.Get("hull repair multiplier"));
-		const double hullEnergy = (attributes.Get("hull energy") * (1. + attributes.Get("hull energy multiplier"))) / hullAvailable;
-		const double hullFuel = (attributes.Get("hull fuel") * (1. + attributes.Get("hull fuel multiplier"))) / hullAvailable;
-		const double hullHeat = (attributes.Get("hull heat") * (1. + attributes.Get("hull heat multiplier"))) / hullAvailable;
-		double hullRemaining = hullAvailable;
+		const double hullEnergy = derived.hullEnergy;
+		const double hullFuel = derived.hullFuel;
+		const double hullHeat = derived.hullHeat;
+		double hullRemaining = derived.hullAvailable;
 		if(!hullDelay)
-			DoRepair(hull, hullRemaining, attributes.Get("hull"), energy, hullEnergy, fuel, hullFuel, heat, hullHeat);
+			DoRepair(hull, hullRemaining, loadout->attributes.Get(Attribute::HULL), energy, hullEnergy, fuel, hullFuel, heat, hullHeat);
 		
-		const double shieldsAvailable = attributes.Get("shield generation") * (1. + attributes.Get("shield generation multiplier"));
-		const double shieldsEnergy = (attributes.Get("shield energy") * (1. + attributes.Get("shield energy multiplier"))) / shieldsAvailable;
-		const double shieldsFuel = (attributes.Get("shield fuel") * (1. + attributes.Get("shield fuel multiplier"))) / shieldsAvailable;
-		const double shieldsHeat = (attributes.Get("shield heat") * (1. + attributes.Get("shield heat multiplier"))) / shieldsAvailable;
-		double shieldsRemaining = shieldsAvailable;
+		const double shieldsEnergy = derived.shieldsEnergy;
+		const double shieldsFuel = derived.shieldsFuel;
+		const double shieldsHeat = derived.shieldsHeat;
+		double shieldsRemaining = derived.shieldsAvailable;
 		if(!shieldDelay)
-			DoRepair(shields, shieldsRemaining, attributes.Get("shields"), energy, shieldsEnergy, fuel, shieldsFuel, heat, shieldsHeat);
+			DoRepair(shields, shieldsRemaining, loadout->attributes.Get(Attribute::SHIELDS), energy, shieldsEnergy, fuel, shieldsFuel, heat, shieldsHeat);
 		
 		if(!bays.empty())
 		{
@@ -1949,20 +1954,20 @@ void Ship::DoGeneration()
 			{
 				Ship &ship = *it.second;
 				if(!hullDelay)
-					DoRepair(ship.hull, hullRemaining, ship.attributes.Get("hull"), energy, hullEnergy, heat, hullHeat, fuel, hullFuel);
+					DoRepair(ship.hull, hullRemaining, ship.loadout->attributes.Get(Attribute::HULL), energy, hullEnergy, heat, hullHeat, fuel, hullFuel);
 				if(!shieldDelay)
-					DoRepair(ship.shields, shieldsRemaining, ship.attributes.Get("shields"), energy, shieldsEnergy, heat, shieldsHeat, fuel, shieldsFuel);
+					DoRepair(ship.shields, shieldsRemaining, ship.loadout->attributes.Get(Attribute::SHIELDS), energy, shieldsEnergy, heat, shieldsHeat, fuel, shieldsFuel);
 			}
 			
 			// Now that there is no more need to use energy for hull and shield
 			// repair, if there is still excess energy, transfer it.
-			double energyRemaining = min(0., energy - attributes.Get("energy capacity"));
-			double fuelRemaining = min(0., fuel - attributes.Get("fuel capacity"));
+			double energyRemaining = min(0., energy - loadout->attributes.Get(Attribute::ENERGY_CAPACITY));
+			double fuelRemaining = min(0., fuel - loadout->attributes.Get(Attribute::FUEL_CAPACITY));
 			for(const pair<double, Ship *> &it : carried)
 			{
 				Ship &ship = *it.second;
-				DoRepair(ship.energy, energyRemaining, ship.attributes.Get("energy capacity"));
-				DoRepair(ship.fuel, fuelRemaining, ship.attributes.Get("fuel capacity"));
+				DoRepair(ship.energy, energyRemaining, ship.loadout->attributes.Get(Attribute::ENERGY_CAPACITY));
+				DoRepair(ship.fuel, fuelRemaining, ship.loadout->attributes.Get(Attribute::FUEL_CAPACITY));
 			}
 		}
 		// Decrease the shield and hull delays by 1 now that shield generation
@@ -1975,28 +1980,28 @@ void Ship::DoGeneration()
 	// TODO: Mothership gives status resistance to carried ships?
 	if(ionization)
 	{
-		double ionResistance = attributes.Get("ion resistance");
-		double ionEnergy = attributes.Get("ion resistance energy") / ionResistance;
-		double ionFuel = attributes.Get("ion resistance fuel") / ionResistance;
-		double ionHeat = attributes.Get("ion resistance heat") / ionResistance;
+		double ionResistance = loadout->attributes.Get(Attribute::ION_RESISTANCE);
+		double ionEnergy = loadout->attributes.Get(Attribute::ION_RESISTANCE_ENERGY) / ionResistance;
+		double ionFuel = loadout->attributes.Get(Attribute::ION_RESISTANCE_FUEL) / ionResistance;
+		double ionHeat = loadout->attributes.Get(Attribute::ION_RESISTANCE_HEAT) / ionResistance;
 		DoStatusEffect(isDisabled, ionization, ionResistance, energy, ionEnergy, fuel, ionFuel, heat, ionHeat);
 	}
 	
 	if(disruption)
 	{
-		double disruptionResistance = attributes.Get("disruption resistance");
-		double disruptionEnergy = attributes.Get("disruption resistance energy") / disruptionResistance;
-		double disruptionFuel = attributes.Get("disruption resistance fuel") / disruptionResistance;
-		double disruptionHeat = attributes.Get("disruption resistance heat") / disruptionResistance;
+		double disruptionResistance = loadout->attributes.Get(Attribute::DISRUPTION_RESISTANCE);
+		double disruptionEnergy = loadout->attributes.Get(Attribute::DISRUPTION_RESISTANCE_ENERGY) / disruptionResistance;
+		double disruptionFuel = loadout->attributes.Get(Attribute::DISRUPTION_RESISTANCE_FUEL) / disruptionResistance;
+		double disruptionHeat = loadout->attributes.Get(Attribute::DISRUPTION_RESISTANCE_HEAT) / disruptionResistance;
 		DoStatusEffect(isDisabled, disruption, disruptionResistance, energy, disruptionEnergy, fuel, disruptionFuel, heat, disruptionHeat);
 	}
 	
 	if(slowness)
 	{
-		double slowingResistance = attributes.Get("slowing resistance");
-		double slowingEnergy = attributes.Get("slowing resistance energy") / slowingResistance;
-		double slowingFuel = attributes.Get("slowing resistance fuel") / slowingResistance;
-		double slowingHeat = attributes.Get("slowing resistance heat") / slowingResistance;
+		double slowingResistance = loadout->attributes.Get(Attribute::SLOWING_RESISTANCE);
+		double slowingEnergy = loadout->attributes.Get(Attribute::SLOWING_RESISTANCE_ENERGY) / slowingResistance;
+		double slowingFuel = loadout->attributes.Get(Attribute::SLOWING_RESISTANCE_FUEL) / slowingResistance;
+		double slowingHeat = loadout->attributes.Get(Attribute::SLOWING_RESISTANCE_HEAT) / slowingResistance;
 		DoStatusEffect(isDisabled, slowness, slowingResistance, energy, slowingEnergy, fuel, slowingFuel, heat, slowingHeat);
 	}
 	
@@ -2004,8 +2009,8 @@ void Ship::DoGeneration()
 	// maximum capacity for the rest of the turn, but must be clamped to the
 	// maximum here before they gain more. This is so that, for example, a ship
 	// with no batteries but a good generator can still move.
-	energy = min(energy, attributes.Get("energy capacity"));
-	fuel = min(fuel, attributes.Get("fuel capacity"));
+	energy = min(energy, loadout->attributes.Get(Attribute::ENERGY_CAPACITY));
+	fuel = min(fuel, loadout->attributes.Get(Attribute::FUEL_CAPACITY));
 	
 	heat -= heat * HeatDissipation();
 	if(heat > MaximumHeat())
@@ -2013,9 +2018,9 @@ void Ship::DoGeneration()
 	else if(heat < .9 * MaximumHeat())
 		isOverheated = false;
 	
-	double maxShields = attributes.Get("shields");
+	double maxShields = loadout->attributes.Get(Attribute::SHIELDS);
 	shields = min(shields, maxShields);
-	double maxHull = attributes.Get("hull");
+	double maxHull = loadout->attributes.Get(Attribute::HULL);
 	hull = min(hull, maxHull);
 	
 	isDisabled = isOverheated || hull < MinimumHull() || (!crew && RequiredCrew());
@@ -2041,35 +2046,34 @@ void Ship::DoGeneration()
 		if(currentSystem)
 		{
 			double scale = .2 + 1.8 / (.001 * position.Length() + 1);
-			fuel += currentSystem->SolarWind() * .03 * scale * (sqrt(attributes.Get("ramscoop")) + .05 * scale);
+			fuel += currentSystem->SolarWind() * .03 * scale * (sqrt(loadout->attributes.Get(Attribute::RAMSCOOP)) + .05 * scale);
 			
 			double solarScaling = currentSystem->SolarPower() * scale;
-			energy += solarScaling * attributes.Get("solar collection");
-			heat += solarScaling * attributes.Get("solar heat");
+			energy += solarScaling * loadout->attributes.Get(Attribute::SOLAR_COLLECTION);
+			heat += solarScaling * loadout->attributes.Get(Attribute::SOLAR_HEAT);
 		}
 		
-		double coolingEfficiency = CoolingEfficiency();
-		energy += attributes.Get("energy generation") - attributes.Get("energy consumption");
-		fuel += attributes.Get("fuel generation");
-		heat += attributes.Get("heat generation");
-		heat -= coolingEfficiency * attributes.Get("cooling");
+		energy += loadout->attributes.Get(Attribute::ENERGY_GENERATION) - loadout->attributes.Get(Attribute::ENERGY_CONSUMPTION);
+		fuel += loadout->attributes.Get(Attribute::FUEL_GENERATION);
+		heat += loadout->attributes.Get(Attribute::HEAT_GENERATION);
+		heat -= derived.cooling;
 		
 		// Convert fuel into energy and heat only when the required amount of fuel is available.
-		if(attributes.Get("fuel consumption") <= fuel)
+		if(loadout->attributes.Get(Attribute::FUEL_CONSUMPTION) <= fuel)
 		{	
-			fuel -= attributes.Get("fuel consumption");
-			energy += attributes.Get("fuel energy");
-			heat += attributes.Get("fuel heat");
+			fuel -= loadout->attributes.Get(Attribute::FUEL_CONSUMPTION);
+			energy += loadout->attributes.Get(Attribute::FUEL_ENERGY);
+			heat += loadout->attributes.Get(Attribute::FUEL_HEAT);
 		}
 		
 		// Apply active cooling. The fraction of full cooling to apply equals
 		// your ship's current fraction of its maximum temperature.
-		double activeCooling = coolingEfficiency * attributes.Get("active cooling");
+		double activeCooling = derived.activeCooling;
 		if(activeCooling > 0. && heat > 0. && energy >= 0.)
 		{
 			// Although it's a misuse of this feature, handle the case where
 			// "active cooling" does not require any energy.
-			double coolingEnergy = attributes.Get("cooling energy");
+			double coolingEnergy = loadout->attributes.Get(Attribute::COOLING_ENERGY);
 			if(coolingEnergy)
 			{
 				double spentEnergy = min(energy, coolingEnergy * min(1., Heat()));
@@ -2100,7 +2104,7 @@ void Ship::Launch(list<shared_ptr<Ship>> &ships, vector<Visual> &visuals)
 		return;
 	
 	for(Bay &bay : bays)
-		if(bay.ship && ((bay.ship->Commands().Has(Command::DEPLOY) && !Random::Int(40 + 20 * !bay.ship->attributes.Get("automaton")))
+		if(bay.ship && ((bay.ship->Commands().Has(Command::DEPLOY) && !Random::Int(40 + 20 * !bay.ship->loadout->attributes.Get(Attribute::AUTOMATON)))
 				|| (ejecting && !Random::Int(6))))
 		{
 			// Resupply any ships launching of their own accord.
@@ -2110,7 +2114,7 @@ void Ship::Launch(list<shared_ptr<Ship>> &ships, vector<Visual> &visuals)
 				
 				// This ship will refuel naturally based on the carrier's fuel
 				// collection, but the carrier may have some reserves to spare.
-				double maxFuel = bay.ship->attributes.Get("fuel capacity");
+				double maxFuel = bay.ship->loadout->attributes.Get(Attribute::FUEL_CAPACITY);
 				if(maxFuel)
 				{
 					double spareFuel = fuel - JumpFuel();
@@ -2176,7 +2180,7 @@ shared_ptr<Ship> Ship::Board(bool autoPlunder)
 		SetShipToAssist(shared_ptr<Ship>());
 		SetTargetShip(shared_ptr<Ship>());
 		bool helped = victim->isDisabled;
-		victim->hull = min(max(victim->hull, victim->MinimumHull() * 1.5), victim->attributes.Get("hull"));
+		victim->hull = min(max(victim->hull, victim->MinimumHull() * 1.5), victim->loadout->attributes.Get(Attribute::HULL));
 		victim->isDisabled = false;
 		// Transfer some fuel if needed.
 		if(!victim->JumpsRemaining() && CanRefuel(*victim))
@@ -2226,8 +2230,8 @@ int Ship::Scan()
 		return 0;
 	
 	// The range of a scanner is proportional to the square root of its power.
-	double cargoDistance = 100. * sqrt(attributes.Get("cargo scan power"));
-	double outfitDistance = 100. * sqrt(attributes.Get("outfit scan power"));
+	double cargoDistance = 100. * sqrt(loadout->attributes.Get(Attribute::CARGO_SCAN_POWER));
+	double outfitDistance = 100. * sqrt(loadout->attributes.Get(Attribute::OUTFIT_SCAN_POWER));
 	
 	// Bail out if this ship has no scanners.
 	if(!cargoDistance && !outfitDistance)
@@ -2235,10 +2239,10 @@ int Ship::Scan()
 	
 	// Scanning speed also uses a square root, so you need four scanners to get
 	// twice the speed out of them.
-	double cargoSpeed = sqrt(attributes.Get("cargo scan speed"));
+	double cargoSpeed = sqrt(loadout->attributes.Get(Attribute::CARGO_SCAN_SPEED));
 	if(!cargoSpeed)
 		cargoSpeed = 1.;
-	double outfitSpeed = sqrt(attributes.Get("outfit scan speed"));
+	double outfitSpeed = sqrt(loadout->attributes.Get(Attribute::OUTFIT_SCAN_SPEED));
 	if(!outfitSpeed)
 		outfitSpeed = 1.;
 	
@@ -2319,8 +2323,13 @@ bool Ship::Fire(vector<Projectile> &projectiles, vector<Visual> &visuals)
 	
 	// A ship that is about to die creates a special single-turn "projectile"
 	// representing its death explosion.
-	if(IsDestroyed() && explosionCount == explosionTotal && explosionWeapon)
-		projectiles.emplace_back(position, explosionWeapon);
+	if(IsDestroyed() && explosionCount == explosionTotal && modelLoadout)
+	{
+		// Explode using the model as it is now, in case it has been reloaded.
+		if(GameData::Ships().Has(modelName))
+			modelLoadout = GameData::Ships().Get(modelName)->loadout;
+		projectiles.emplace_back(position, &modelLoadout->baseAttributes);
+	}
 	
 	if(CannotAct())
 		return false;
@@ -2498,8 +2507,8 @@ bool Ship::IsReadyToJump(bool waitingIsReady) const
 		return false;
 	
 	Point direction = targetSystem->Position() - currentSystem->Position();
-	bool isJump = !attributes.Get("hyperdrive") || !currentSystem->Links().count(targetSystem);
-	double scramThreshold = attributes.Get("scram drive");
+	bool isJump = !loadout->attributes.Get(Attribute::HYPERDRIVE) || !currentSystem->Links().count(targetSystem);
+	double scramThreshold = loadout->attributes.Get(Attribute::SCRAM_DRIVE);
 	
 	// The ship can only enter hyperspace if it is traveling slowly enough
 	// and pointed in the right direction.
@@ -2509,7 +2518,7 @@ bool Ship::IsReadyToJump(bool waitingIsReady) const
 		if(deviation > scramThreshold)
 			return false;
 	}
-	else if(velocity.Length() > attributes.Get("jump speed"))
+	else if(velocity.Length() > loadout->attributes.Get(Attribute::JUMP_SPEED))
 		return false;
 	
 	if(!isJump)
@@ -2641,18 +2650,18 @@ void Ship::Recharge(bool atSpaceport)
 	
 	if(atSpaceport)
 	{
-		crew = min<int>(max(crew, RequiredCrew()), attributes.Get("bunks"));
-		fuel = attributes.Get("fuel capacity");
+		crew = min<int>(max(crew, RequiredCrew()), loadout->attributes.Get(Attribute::BUNKS));
+		fuel = loadout->attributes.Get(Attribute::FUEL_CAPACITY);
 	}
 	pilotError = 0;
 	pilotOkay = 0;
 	
-	if(atSpaceport || attributes.Get("shield generation"))
-		shields = attributes.Get("shields");
-	if(atSpaceport || attributes.Get("hull repair rate"))
-		hull = attributes.Get("hull");
-	if(atSpaceport || attributes.Get("energy generation"))
-		energy = attributes.Get("energy capacity");
+	if(atSpaceport || loadout->attributes.Get(Attribute::SHIELD_GENERATION))
+		shields = loadout->attributes.Get(Attribute::SHIELDS);
+	if(atSpaceport || loadout->attributes.Get(Attribute::HULL_REPAIR_RATE))
+		hull = loadout->attributes.Get(Attribute::HULL);
+	if(atSpaceport || loadout->attributes.Get(Attribute::ENERGY_GENERATION))
+		energy = loadout->attributes.Get(Attribute::ENERGY_CAPACITY);
 	
 	heat = IdleHeat();
 	ionization = 0.;
@@ -2673,10 +2682,10 @@ bool Ship::CanRefuel(const Ship &other) const
 
 double Ship::TransferFuel(double amount, Ship *to)
 {
-	amount = max(fuel - attributes.Get("fuel capacity"), amount);
+	amount = max(fuel - loadout->attributes.Get(Attribute::FUEL_CAPACITY), amount);
 	if(to)
 	{
-		amount = min(to->attributes.Get("fuel capacity") - to->fuel, amount);
+		amount = min(to->loadout->attributes.Get(Attribute::FUEL_CAPACITY) - to->fuel, amount);
 		to->fuel += amount;
 	}
 	fuel -= amount;
@@ -2690,7 +2699,7 @@ double Ship::TransferFuel(double amount, Ship *to)
 void Ship::WasCaptured(const shared_ptr<Ship> &capturer)
 {
 	// Repair up to the point where this ship is just barely not disabled.
-	hull = min(max(hull, MinimumHull() * 1.5), attributes.Get("hull"));
+	hull = min(max(hull, MinimumHull() * 1.5), loadout->attributes.Get(Attribute::HULL));
 	isDisabled = false;
 	
 	// Set the new government.
@@ -2747,7 +2756,7 @@ void Ship::WasCaptured(const shared_ptr<Ship> &capturer)
 // Get characteristics of this ship, as a fraction between 0 and 1.
 double Ship::Shields() const
 {
-	double maximum = attributes.Get("shields");
+	double maximum = loadout->attributes.Get(Attribute::SHIELDS);
 	return maximum ? min(1., shields / maximum) : 0.;
 }
 
@@ -2755,7 +2764,7 @@ double Ship::Shields() const
 
 double Ship::Hull() const
 {
-	double maximum = attributes.Get("hull");
+	double maximum = loadout->attributes.Get(Attribute::HULL);
 	return maximum ? min(1., hull / maximum) : 1.;
 }
 
@@ -2763,7 +2772,7 @@ double Ship::Hull() const
 
 double Ship::Fuel() const
 {
-	double maximum = attributes.Get("fuel capacity");
+	double maximum = loadout->attributes.Get(Attribute::FUEL_CAPACITY);
 	return maximum ? min(1., fuel / maximum) : 0.;
 }
 
@@ -2771,7 +2780,7 @@ double Ship::Fuel() const
 
 double Ship::Energy() const
 {
-	double maximum = attributes.Get("energy capacity");
+	double maximum = loadout->attributes.Get(Attribute::ENERGY_CAPACITY);
 	return maximum ? min(1., energy / maximum) : (hull > 0.) ? 1. : 0.;
 }
 
@@ -2791,8 +2800,8 @@ double Ship::Heat() const
 double Ship::Health() const
 {
 	double minimumHull = MinimumHull();
-	double hullDivisor = attributes.Get("hull") - minimumHull;
-	double divisor = attributes.Get("shields") + hullDivisor;
+	double hullDivisor = loadout->attributes.Get(Attribute::HULL) - minimumHull;
+	double divisor = loadout->attributes.Get(Attribute::SHIELDS) + hullDivisor;
 	// This should not happen, but just in case.
 	if(divisor <= 0. || hullDivisor <= 0.)
 		return 0.;
@@ -2807,7 +2816,7 @@ double Ship::Health() const
 // Get the hull fraction at which this ship is disabled.
 double Ship::DisabledHull() const
 {
-	double hull = attributes.Get("hull");
+	double hull = loadout->attributes.Get(Attribute::HULL);
 	double minimumHull = MinimumHull();
 	
 	return (hull > 0. ? minimumHull / hull : 0.);
@@ -2847,10 +2856,10 @@ double Ship::JumpFuel(const System *destination) const
 	
 	bool linked = currentSystem->Links().count(destination);
 	// Figure out what sort of jump we're making.
-	if(attributes.Get("hyperdrive") && linked)
+	if(loadout->attributes.Get(Attribute::HYPERDRIVE) && linked)
 		return HyperdriveFuel();
 	
-	if(attributes.Get("jump drive") && currentSystem->JumpNeighbors(JumpRange()).count(destination))
+	if(loadout->attributes.Get(Attribute::JUMP_DRIVE) && currentSystem->JumpNeighbors(JumpRange()).count(destination))
 		return JumpDriveFuel((linked || currentSystem->JumpRange()) ? 0. : currentSystem->Position().Distance(destination->Position()));
 	
 	// If the given system is not a possible destination, return 0.
@@ -2865,23 +2874,23 @@ double Ship::JumpRange(bool getCached) const
 		return jumpRange;
 	
 	// Ships without a jump drive have no jump range.
-	if(!attributes.Get("jump drive"))
+	if(!loadout->attributes.Get(Attribute::JUMP_DRIVE))
 		return 0.;
 	
 	// Find the outfit that provides the farthest jump range.
 	double best = 0.;
 	// Make it possible for the jump range to be integrated into a ship.
-	if(baseAttributes.Get("jump drive"))
+	if(loadout->baseAttributes.Get(Attribute::JUMP_DRIVE))
 	{
-		best = baseAttributes.Get("jump range");
+		best = loadout->baseAttributes.Get(Attribute::JUMP_RANGE);
 		if(!best)
 			best = System::DEFAULT_NEIGHBOR_DISTANCE;
 	}
 	// Search through all the outfits.
-	for(const auto &it : outfits)
-		if(it.first->Get("jump drive"))
+	for(const auto &it : loadout->outfits)
+		if(it.first->Get(Attribute::JUMP_DRIVE))
 		{
-			double range = it.first->Get("jump range");
+			double range = it.first->Get(Attribute::JUMP_RANGE);
 			if(!range)
 				range = System::DEFAULT_NEIGHBOR_DISTANCE;
 			if(!best || range > best)
@@ -2896,10 +2905,10 @@ double Ship::JumpRange(bool getCached) const
 double Ship::HyperdriveFuel() const
 {
 	// Don't bother searching through the outfits if there is no hyperdrive.
-	if(!attributes.Get("hyperdrive"))
+	if(!loadout->attributes.Get(Attribute::HYPERDRIVE))
 		return JumpDriveFuel();
 	
-	if(attributes.Get("scram drive"))
+	if(loadout->attributes.Get(Attribute::SCRAM_DRIVE))
 		return BestFuel("hyperdrive", "scram drive", 150.);
 	
 	return BestFuel("hyperdrive", "", 100.);
@@ -2910,7 +2919,7 @@ double Ship::HyperdriveFuel() const
 double Ship::JumpDriveFuel(double jumpDistance) const
 {
 	// Don't bother searching through the outfits if there is no jump drive.
-	if(!attributes.Get("jump drive"))
+	if(!loadout->attributes.Get(Attribute::JUMP_DRIVE))
 		return 0.;
 	
 	return BestFuel("jump drive", "", 200., jumpDistance);
@@ -2923,7 +2932,7 @@ double Ship::JumpFuelMissing() const
 	// Used for smart refueling: transfer only as much as really needed
 	// includes checking if fuel cap is high enough at all
 	double jumpFuel = JumpFuel(targetSystem);
-	if(!jumpFuel || fuel > jumpFuel || jumpFuel > attributes.Get("fuel capacity"))
+	if(!jumpFuel || fuel > jumpFuel || jumpFuel > loadout->attributes.Get(Attribute::FUEL_CAPACITY))
 		return 0.;
 	
 	return jumpFuel - fuel;
@@ -2935,15 +2944,14 @@ double Ship::JumpFuelMissing() const
 double Ship::IdleHeat() const
 {
 	// This ship's cooling ability:
-	double coolingEfficiency = CoolingEfficiency();
-	double cooling = coolingEfficiency * attributes.Get("cooling");
-	double activeCooling = coolingEfficiency * attributes.Get("active cooling");
+	double cooling = derived.cooling;
+	double activeCooling = derived.activeCooling;
 	
 	// Idle heat is the heat level where:
 	// heat = heat * diss + heatGen - cool - activeCool * heat / (100 * mass)
 	// heat = heat * (diss - activeCool / (100 * mass)) + (heatGen - cool)
 	// heat * (1 - diss + activeCool / (100 * mass)) = (heatGen - cool)
-	double production = max(0., attributes.Get("heat generation") - cooling);
+	double production = max(0., loadout->attributes.Get(Attribute::HEAT_GENERATION) - cooling);
 	double dissipation = HeatDissipation() + activeCooling / MaximumHeat();
 	if(!dissipation) return production ? numeric_limits<double>::max() : 0;
 	return production / dissipation;
@@ -2954,7 +2962,7 @@ double Ship::IdleHeat() const
 // Get the heat dissipation, in heat units per heat unit per frame.
 double Ship::HeatDissipation() const
 {
-	return .001 * attributes.Get("heat dissipation");
+	return derived.heatDissipation;
 }
 
 
@@ -2962,7 +2970,7 @@ double Ship::HeatDissipation() const
 // Get the maximum heat level, in heat units (not temperature).
 double Ship::MaximumHeat() const
 {
-	return MAXIMUM_TEMPERATURE * (cargo.Used() + attributes.Mass());
+	return MAXIMUM_TEMPERATURE * (cargo.Used() + loadout->attributes.Mass());
 }
 
 
@@ -2970,11 +2978,7 @@ double Ship::MaximumHeat() const
 // Calculate the multiplier for cooling efficiency.
 double Ship::CoolingEfficiency() const
 {
-	// This is an S-curve where the efficiency is 100% if you have no outfits
-	// that create "cooling inefficiency", and as that value increases the
-	// efficiency stays high for a while, then drops off, then approaches 0.
-	double x = attributes.Get("cooling inefficiency");
-	return 2. + 2. / (1. + exp(x / -2.)) - 4. / (1. + exp(x / -4.));
+	return derived.coolingEfficiency;
 }
 
 
@@ -2988,18 +2992,18 @@ int Ship::Crew() const
 
 int Ship::RequiredCrew() const
 {
-	if(attributes.Get("automaton"))
+	if(loadout->attributes.Get(Attribute::AUTOMATON))
 		return 0;
 	
 	// Drones do not need crew, but all other ships need at least one.
-	return max<int>(1, attributes.Get("required crew"));
+	return max<int>(1, loadout->attributes.Get(Attribute::REQUIRED_CREW));
 }
 
 
 
 void Ship::AddCrew(int count)
 {
-	crew = min<int>(crew + count, attributes.Get("bunks"));
+	crew = min<int>(crew + count, loadout->attributes.Get(Attribute::BUNKS));
 }
 
 
@@ -3014,40 +3018,35 @@ bool Ship::CanBeFlagship() const
 
 double Ship::Mass() const
 {
-	return carriedMass + cargo.Used() + attributes.Mass();
+	return carriedMass + cargo.Used() + loadout->attributes.Mass();
 }
 
 
 
 double Ship::TurnRate() const
 {
-	return attributes.Get("turn") / Mass();
+	return loadout->attributes.Get(Attribute::TURN) / Mass();
 }
 
 
 
 double Ship::Acceleration() const
 {
-	double thrust = attributes.Get("thrust");
-	return (thrust ? thrust : attributes.Get("afterburner thrust")) / Mass();
+	return derived.thrust / Mass();
 }
 
 
 
 double Ship::MaxVelocity() const
 {
-	// v * drag / mass == thrust / mass
-	// v * drag == thrust
-	// v = thrust / drag
-	double thrust = attributes.Get("thrust");
-	return (thrust ? thrust : attributes.Get("afterburner thrust")) / attributes.Get("drag");
+	return derived.maxVelocity;
 }
 
 
 
 double Ship::MaxReverseVelocity() const
 {
-	return attributes.Get("reverse thrust") / attributes.Get("drag");
+	return derived.maxReverseVelocity;
 }
 
 
@@ -3076,24 +3075,24 @@ int Ship::TakeDamage(vector<Visual> &visuals, const Weapon &weapon, double damag
 	if(weapon.HasDamageDropoff())
 		damageScaling *= weapon.DamageDropoff(distanceTraveled);
 	
-	double shieldDamage = (weapon.ShieldDamage() + weapon.RelativeShieldDamage() * attributes.Get("shields"))
-		* damageScaling / (1. + attributes.Get("shield protection"));
-	double hullDamage = (weapon.HullDamage() + weapon.RelativeHullDamage() * attributes.Get("hull"))
-		* damageScaling / (1. + attributes.Get("hull protection"));
-	double energyDamage = (weapon.EnergyDamage() + weapon.RelativeEnergyDamage() * attributes.Get("energy capacity"))
-		* damageScaling / (1. + attributes.Get("energy protection"));
-	double fuelDamage = (weapon.FuelDamage() + weapon.RelativeFuelDamage() * attributes.Get("fuel capacity"))
-		* damageScaling / (1. + attributes.Get("fuel protection"));
+	double shieldDamage = (weapon.ShieldDamage() + weapon.RelativeShieldDamage() * loadout->attributes.Get(Attribute::SHIELDS))
+		* damageScaling / (1. + loadout->attributes.Get(Attribute::SHIELD_PROTECTION));
+	double hullDamage = (weapon.HullDamage() + weapon.RelativeHullDamage() * loadout->attributes.Get(Attribute::HULL))
+		* damageScaling / (1. + loadout->attributes.Get(Attribute::HULL_PROTECTION));
+	double energyDamage = (weapon.EnergyDamage() + weapon.RelativeEnergyDamage() * loadout->attributes.Get(Attribute::ENERGY_CAPACITY))
+		* damageScaling / (1. + loadout->attributes.Get(Attribute::ENERGY_PROTECTION));
+	double fuelDamage = (weapon.FuelDamage() + weapon.RelativeFuelDamage() * loadout->attributes.Get(Attribute::FUEL_CAPACITY))
+		* damageScaling / (1. + loadout->attributes.Get(Attribute::FUEL_PROTECTION));
 	double heatDamage = (weapon.HeatDamage() + weapon.RelativeHeatDamage() * MaximumHeat())
-		* damageScaling / (1. + attributes.Get("heat protection"));
-	double ionDamage = weapon.IonDamage() * damageScaling / (1. + attributes.Get("ion protection"));
-	double disruptionDamage = weapon.DisruptionDamage() * damageScaling / (1. + attributes.Get("disruption protection"));
-	double slowingDamage = weapon.SlowingDamage() * damageScaling / (1. + attributes.Get("slowing protection"));
-	double hitForce = weapon.HitForce() * damageScaling / (1. + attributes.Get("force protection"));
+		* damageScaling / (1. + loadout->attributes.Get(Attribute::HEAT_PROTECTION));
+	double ionDamage = weapon.IonDamage() * damageScaling / (1. + loadout->attributes.Get(Attribute::ION_PROTECTION));
+	double disruptionDamage = weapon.DisruptionDamage() * damageScaling / (1. + loadout->attributes.Get(Attribute::DISRUPTION_PROTECTION));
+	double slowingDamage = weapon.SlowingDamage() * damageScaling / (1. + loadout->attributes.Get(Attribute::SLOWING_PROTECTION));
+	double hitForce = weapon.HitForce() * damageScaling / (1. + loadout->attributes.Get(Attribute::FORCE_PROTECTION));
 	bool wasDisabled = IsDisabled();
 	bool wasDestroyed = IsDestroyed();
 	
-	double shieldFraction = 1. - max(0., min(1., weapon.Piercing() / (1. + attributes.Get("piercing protection")) - attributes.Get("piercing resistance")));
+	double shieldFraction = 1. - max(0., min(1., weapon.Piercing() / (1. + loadout->attributes.Get(Attribute::PIERCING_PROTECTION)) - loadout->attributes.Get(Attribute::PIERCING_RESISTANCE)));
 	shieldFraction *= 1. / (1. + disruption * .01);
 	if(shields <= 0.)
 		shieldFraction = 0.;
@@ -3102,12 +3101,12 @@ int Ship::TakeDamage(vector<Visual> &visuals, const Weapon &weapon, double damag
 	shields -= shieldDamage * shieldFraction;
 	if(shieldDamage && !isDisabled)
 	{
-		int disabledDelay = static_cast<int>(attributes.Get("depleted shield delay"));
-		shieldDelay = max(shieldDelay, (shields <= 0. && disabledDelay) ? disabledDelay : static_cast<int>(attributes.Get("shield delay")));
+		int disabledDelay = static_cast<int>(loadout->attributes.Get(Attribute::DEPLETED_SHIELD_DELAY));
+		shieldDelay = max(shieldDelay, (shields <= 0. && disabledDelay) ? disabledDelay : static_cast<int>(loadout->attributes.Get(Attribute::SHIELD_DELAY)));
 	}
 	hull -= hullDamage * (1. - shieldFraction);
 	if(hullDamage && !isDisabled)
-		hullDelay = max(hullDelay, static_cast<int>(attributes.Get("repair delay")));
+		hullDelay = max(hullDelay, static_cast<int>(loadout->attributes.Get(Attribute::REPAIR_DELAY)));
 	// For the following damage types, the total effect depends on how much is
 	// "leaking" through the shields.
 	double leakage = (1. - .5 * shieldFraction);
@@ -3137,7 +3136,7 @@ int Ship::TakeDamage(vector<Visual> &visuals, const Weapon &weapon, double damag
 	if(!wasDisabled && isDisabled)
 	{
 		type |= ShipEvent::DISABLE;
-		hullDelay = max(hullDelay, static_cast<int>(attributes.Get("disabled repair delay")));
+		hullDelay = max(hullDelay, static_cast<int>(loadout->attributes.Get(Attribute::DISABLED_REPAIR_DELAY)));
 	}
 	if(!wasDestroyed && IsDestroyed())
 		type |= ShipEvent::DESTROY;
@@ -3229,7 +3228,7 @@ bool Ship::CanCarry(const Ship &ship) const
 	if(!ship.CanBeCarried())
 		return false;
 	// Check only for the category that we are interested in.
-	const string &category = ship.attributes.Category();
+	const string &category = ship.loadout->attributes.Category();
 	
 	int free = BaysTotal(category);
 	if(!free)
@@ -3238,7 +3237,7 @@ bool Ship::CanCarry(const Ship &ship) const
 	for(const auto &it : escorts)
 	{
 		auto escort = it.lock();
-		if(escort && escort.get() != &ship && escort->attributes.Category() == category 
+		if(escort && escort.get() != &ship && escort->loadout->attributes.Category() == category 
 			&& !escort->IsDestroyed())
 			--free;
 	}
@@ -3250,7 +3249,7 @@ bool Ship::CanCarry(const Ship &ship) const
 void Ship::AllowCarried(bool allowCarried)
 {
 	const auto &bayCategories = GameData::Category(CategoryType::BAY);
-	canBeCarried = allowCarried && find(bayCategories.begin(), bayCategories.end(), attributes.Category()) != bayCategories.end();
+	canBeCarried = allowCarried && find(bayCategories.begin(), bayCategories.end(), loadout->attributes.Category()) != bayCategories.end();
 }
 
 
@@ -3268,7 +3267,7 @@ bool Ship::Carry(const shared_ptr<Ship> &ship)
 		return false;
 	
 	// Check only for the category that we are interested in.
-	const string &category = ship->attributes.Category();
+	const string &category = ship->loadout->attributes.Category();
 	
 	for(Bay &bay : bays)
 		if((bay.category == category) && !bay.ship)
@@ -3396,14 +3395,14 @@ void Ship::Jettison(const Outfit *outfit, int count, bool wasAppeasing)
 
 const Outfit &Ship::Attributes() const
 {
-	return attributes;
+	return loadout->attributes;
 }
 
 
 
 const Outfit &Ship::BaseAttributes() const
 {
-	return baseAttributes;
+	return loadout->baseAttributes;
 }
 
 
@@ -3411,15 +3410,15 @@ const Outfit &Ship::BaseAttributes() const
 // Get outfit information.
 const map<const Outfit *, int> &Ship::Outfits() const
 {
-	return outfits;
+	return loadout->outfits;
 }
 
 
 
 int Ship::OutfitCount(const Outfit *outfit) const
 {
-	auto it = outfits.find(outfit);
-	return (it == outfits.end()) ? 0 : it->second;
+	auto it = loadout->outfits.find(outfit);
+	return (it == loadout->outfits.end()) ? 0 : it->second;
 }
 
 
@@ -3429,32 +3428,46 @@ void Ship::AddOutfit(const Outfit *outfit, int count)
 {
 	if(outfit && count)
 	{
-		auto it = outfits.find(outfit);
-		if(it == outfits.end())
-			outfits[outfit] = count;
+		MakeLoadoutUnique();
+		auto it = loadout->outfits.find(outfit);
+		if(it == loadout->outfits.end())
+			loadout->outfits[outfit] = count;
 		else
 		{
 			it->second += count;
 			if(!it->second)
-				outfits.erase(it);
+				loadout->outfits.erase(it);
 		}
-		attributes.Add(*outfit, count);
+		loadout->attributes.Add(*outfit, count);
+		UpdateDerivedStats();
 		if(outfit->IsWeapon())
 			armament.Add(outfit, count);
 		
-		if(outfit->Get("cargo space"))
-			cargo.SetSize(attributes.Get("cargo space"));
-		if(outfit->Get("hull"))
-			hull += outfit->Get("hull") * count;
+		if(outfit->Get(Attribute::CARGO_SPACE))
+			cargo.SetSize(loadout->attributes.Get(Attribute::CARGO_SPACE));
+		if(outfit->Get(Attribute::HULL))
+			hull += outfit->Get(Attribute::HULL) * count;
 		// If the added or removed outfit is a jump drive, recalculate
 		// and cache this ship's jump range.
-		if(outfit->Get("jump drive"))
+		if(outfit->Get(Attribute::JUMP_DRIVE))
 			jumpRange = JumpRange(false);
 	}
 }
 
 
 
+// Check that the stats this ship caches match its current attributes.
+bool Ship::HasCurrentDerivedStats() const
+{
+	DerivedStats stats;
+	ComputeDerivedStats(stats);
+	// Compare the bits rather than the values, because some of the stats are
+	// NaN if the ship has no way of repairing itself.
+	return !memcmp(&stats, &derived, sizeof(stats));
+}
+
+
+
 // Get the list of weapons.
 Armament &Ship::GetArmament()
 {
@@ -3479,18 +3492,18 @@ bool Ship::CanFire(const Weapon *weapon) const
 	
 	if(weapon->Ammo())
 	{
-		auto it = outfits.find(weapon->Ammo());
-		if(it == outfits.end() || it->second < weapon->AmmoUsage())
+		auto it = loadout->outfits.find(weapon->Ammo());
+		if(it == loadout->outfits.end() || it->second < weapon->AmmoUsage())
 			return false;
 	}
 	
-	if(energy < weapon->FiringEnergy() + weapon->RelativeFiringEnergy() * attributes.Get("energy capacity"))
+	if(energy < weapon->FiringEnergy() + weapon->RelativeFiringEnergy() * loadout->attributes.Get(Attribute::ENERGY_CAPACITY))
 		return false;
-	if(fuel < weapon->FiringFuel() + weapon->RelativeFiringFuel() * attributes.Get("fuel capacity"))
+	if(fuel < weapon->FiringFuel() + weapon->RelativeFiringFuel() * loadout->attributes.Get(Attribute::FUEL_CAPACITY))
 		return false;
 	// We do check hull, but we don't check shields. Ships can survive with all shields depleted.
 	// Ships should not disable themselves, so we check if we stay above minimumHull.
-	if(hull - MinimumHull() < weapon->FiringHull() + weapon->RelativeFiringHull() * attributes.Get("hull"))
+	if(hull - MinimumHull() < weapon->FiringHull() + weapon->RelativeFiringHull() * loadout->attributes.Get(Attribute::HULL))
 		return false;
 
 	// If a weapon requires heat to fire, (rather than generating heat), we must
@@ -3520,13 +3533,13 @@ void Ship::ExpendAmmo(const Weapon *weapon)
 	if(weapon->Ammo())
 		AddOutfit(weapon->Ammo(), -weapon->AmmoUsage());
 	
-	energy -= weapon->FiringEnergy() + weapon->RelativeFiringEnergy() * attributes.Get("energy capacity");
-	fuel -= weapon->FiringFuel() + weapon->RelativeFiringFuel() * attributes.Get("fuel capacity");
+	energy -= weapon->FiringEnergy() + weapon->RelativeFiringEnergy() * loadout->attributes.Get(Attribute::ENERGY_CAPACITY);
+	fuel -= weapon->FiringFuel() + weapon->RelativeFiringFuel() * loadout->attributes.Get(Attribute::FUEL_CAPACITY);
 	heat += weapon->FiringHeat() + weapon->RelativeFiringHeat() * MaximumHeat();
 	// Weapons fire from within shields, so hull damage goes directly into the hull, while shield damage
 	// only affects shields.
-	hull -= weapon->FiringHull() + weapon->RelativeFiringHull() * attributes.Get("hull");
-	shields -= weapon->FiringShields() + weapon->RelativeFiringShields() * attributes.Get("shields");
+	hull -= weapon->FiringHull() + weapon->RelativeFiringHull() * loadout->attributes.Get(Attribute::HULL);
+	shields -= weapon->FiringShields() + weapon->RelativeFiringShields() * loadout->attributes.Get(Attribute::SHIELDS);
 	
 	// Those values are usually reduced by active shields, but weapons fire from within the shields, so
 	// it seems more appropriate to apply those damages with a factor 1 directly.
@@ -3688,15 +3701,15 @@ double Ship::MinimumHull() const
 	if(neverDisabled)
 		return 0.;
 	
-	double maximumHull = attributes.Get("hull");
-	double absoluteThreshold = attributes.Get("absolute threshold");
+	double maximumHull = loadout->attributes.Get(Attribute::HULL);
+	double absoluteThreshold = loadout->attributes.Get(Attribute::ABSOLUTE_THRESHOLD);
 	if(absoluteThreshold > 0.)
 		return absoluteThreshold;
 	
-	double thresholdPercent = attributes.Get("threshold percentage");
+	double thresholdPercent = loadout->attributes.Get(Attribute::THRESHOLD_PERCENTAGE);
 	double minimumHull = maximumHull * (thresholdPercent > 0. ? min(thresholdPercent, 1.) : max(.15, min(.45, 10. / sqrt(maximumHull))));
 
-	return max(0., floor(minimumHull + attributes.Get("hull threshold")));
+	return max(0., floor(minimumHull + loadout->attributes.Get(Attribute::HULL_THRESHOLD)));
 }
 
 
@@ -3707,14 +3720,14 @@ double Ship::BestFuel(const string &type, const string &subtype, double defaultF
 	// Find the outfit that provides the least costly hyperjump.
 	double best = 0.;
 	// Make it possible for a hyperdrive to be integrated into a ship.
-	if(baseAttributes.Get(type) && (subtype.empty() || baseAttributes.Get(subtype)))
+	if(loadout->baseAttributes.Get(type) && (subtype.empty() || loadout->baseAttributes.Get(subtype)))
 	{
 		// If a distance was given, then we know that we are making a jump.
 		// Only use the fuel from a jump drive if it is capable of making
 		// the given jump. We can guarantee that at least one jump drive
 		// is capable of making the given jump, as the destination must
 		// be among the neighbors of the current system.
-		double jumpRange = baseAttributes.Get("jump range");
+		double jumpRange = loadout->baseAttributes.Get(Attribute::JUMP_RANGE);
 		if(!jumpRange)
 			jumpRange = System::DEFAULT_NEIGHBOR_DISTANCE;
 		// If no distance was given then we're either using a hyperdrive
@@ -3722,21 +3735,21 @@ double Ship::BestFuel(const string &type, const string &subtype, double defaultF
 		// always pass.
 		if(jumpRange >= jumpDistance)
 		{
-			best = baseAttributes.Get("jump fuel");
+			best = loadout->baseAttributes.Get(Attribute::JUMP_FUEL);
 			if(!best)
 				best = defaultFuel;
 		}
 	}
 	// Search through all the outfits.
-	for(const auto &it : outfits)
+	for(const auto &it : loadout->outfits)
 		if(it.first->Get(type) && (subtype.empty() || it.first->Get(subtype)))
 		{
-			double jumpRange = it.first->Get("jump range");
+			double jumpRange = it.first->Get(Attribute::JUMP_RANGE);
 			if(!jumpRange)
 				jumpRange = System::DEFAULT_NEIGHBOR_DISTANCE;
 			if(jumpRange >= jumpDistance)
 			{
-				double fuel = it.first->Get("jump fuel");
+				double fuel = it.first->Get(Attribute::JUMP_FUEL);
 				if(!fuel)
 					fuel = defaultFuel;
 				if(!best || fuel < best)
@@ -3814,3 +3827,52 @@ void Ship::CreateSparks(vector<Visual> &visuals, const Effect *effect, double am
 			visuals.emplace_back(*effect, angle.Rotate(point) + position, velocity, angle);
 	}
 }
+
+
+
+void Ship::MakeLoadoutUnique()
+{
+	if(loadout.use_count() == 1)
+		return;
+	
+	loadout = make_shared<Loadout>(*loadout);
+}
+
+
+
+void Ship::UpdateDerivedStats()
+{
+	ComputeDerivedStats(derived);
+}
+
+
+
+void Ship::ComputeDerivedStats(DerivedStats &stats) const
+{
+	// This is an S-curve where the efficiency is 100% if you have no outfits
+	// that create "cooling inefficiency", and as that value increases the
+	// efficiency stays high for a while, then drops off, then approaches 0.
+	double x = loadout->attributes.Get(Attribute::COOLING_INEFFICIENCY);
+	stats.coolingEfficiency = 2. + 2. / (1. + exp(x / -2.)) - 4. / (1. + exp(x / -4.));
+	stats.heatDissipation = .001 * loadout->attributes.Get(Attribute::HEAT_DISSIPATION);
+	stats.cooling = stats.coolingEfficiency * loadout->attributes.Get(Attribute::COOLING);
+	stats.activeCooling = stats.coolingEfficiency * loadout->attributes.Get(Attribute::ACTIVE_COOLING);
+	
+	// v * drag / mass == thrust / mass
+	// v * drag == thrust
+	// v = thrust / drag
+	double thrust = loadout->attributes.Get(Attribute::THRUST);
+	stats.thrust = (thrust ? thrust : loadout->attributes.Get(Attribute::AFTERBURNER_THRUST));
+	stats.maxVelocity = stats.thrust / loadout->attributes.Get(Attribute::DRAG);
+	stats.maxReverseVelocity = loadout->attributes.Get(Attribute::REVERSE_THRUST) / loadout->attributes.Get(Attribute::DRAG);
+	
+	stats.hullAvailable = loadout->attributes.Get(Attribute::HULL_REPAIR_RATE) * (1. + loadout->attributes.Get(Attribute::HULL_REPAIR_MULTIPLIER));
+	stats.hullEnergy = (loadout->attributes.Get(Attribute::HULL_ENERGY) * (1. + loadout->attributes.Get(Attribute::HULL_ENERGY_MULTIPLIER))) / stats.hullAvailable;
+	stats.hullFuel = (loadout->attributes.Get(Attribute::HULL_FUEL) * (1. + loadout->attributes.Get(Attribute::HULL_FUEL_MULTIPLIER))) / stats.hullAvailable;
+	stats.hullHeat = (loadout->attributes.Get(Attribute::HULL_HEAT) * (1. + loadout->attributes.Get(Attribute::HULL_HEAT_MULTIPLIER))) / stats.hullAvailable;
+	
+	stats.shieldsAvailable = loadout->attributes.Get(Attribute::SHIELD_GENERATION) * (1. + loadout->attributes.Get(Attribute::SHIELD_GENERATION_MULTIPLIER));
+	stats.shieldsEnergy = (loadout->attributes.Get(Attribute::SHIELD_ENERGY) * (1. + loadout->attributes.Get(Attribute::SHIELD_ENERGY_MULTIPLIER))) / stats.shieldsAvailable;
+	stats.shieldsFuel = (loadout->attributes.Get(Attribute::SHIELD_FUEL) * (1. + loadout->attributes.Get(Attribute::SHIELD_FUEL_MULTIPLIER))) / stats.shieldsAvailable;
+	stats.shieldsHeat = (loadout->attributes.Get(Attribute::SHIELD_HEAT) * (1. + loadout->attributes.Get(Attribute::SHIELD_HEAT_MULTIPLIER))) / stats.shieldsAvailable;
+}
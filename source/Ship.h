@@ -372,6 +372,8 @@ public:
 	int OutfitCount(const Outfit *outfit) const;
 	// Add or remove outfits. (To remove, pass a negative number.)
 	void AddOutfit(const Outfit *outfit, int count);
+	// Check that the stats this ship caches match its current attributes.
+	bool HasCurrentDerivedStats() const;
 	
 	// Get the list of weapons.
 	Armament &GetArmament();
@@ -424,6 +426,14 @@ private:
 	// Place a "spark" effect, like ionization or disruption.
 	void CreateSparks(std::vector<Visual> &visuals, const std::string &name, double amount);
 	void CreateSparks(std::vector<Visual> &visuals, const Effect *effect, double amount);
+	// Make sure this ship's loadout is not shared with any other ship. This
+	// must be done before modifying it.
+	void MakeLoadoutUnique();
+	// Recompute the values that are derived from this ship's attributes. This
+	// must be done whenever the attributes change.
+	class DerivedStats;
+	void UpdateDerivedStats();
+	void ComputeDerivedStats(DerivedStats &stats) const;
 	
 	
 private:
@@ -483,12 +493,22 @@ private:
 	Personality personality;
 	const Phrase *hail = nullptr;
 	
-	// Installed outfits, cargo, etc.:
-	Outfit attributes;
-	Outfit baseAttributes;
+	// Installed outfits, and the attributes of the chassis with and without
+	// them. These only change when outfits are added or removed, so copies of
+	// a ship (e.g. every ship that a fleet spawns from a model) share them, and
+	// a ship only gets its own copy once it needs to modify them.
+	class Loadout {
+	public:
+		Outfit attributes;
+		Outfit baseAttributes;
+		std::map<const Outfit *, int> outfits;
+	};
+	std::shared_ptr<Loadout> loadout = std::make_shared<Loadout>();
 	bool addAttributes = false;
-	const Outfit *explosionWeapon = nullptr;
-	std::map<const Outfit *, int> outfits;
+	// The base attributes of this ship's model are the "weapon" it fires when
+	// it explodes. Keep that model's loadout, so the weapon stays valid even
+	// if the model is reloaded.
+	std::shared_ptr<const Loadout> modelLoadout;
 	CargoHold cargo;
 	std::list<std::shared_ptr<Flotsam>> jettisoned;
 	
@@ -537,6 +557,34 @@ private:
 	
 	double jumpRange = 0.;
 	
+	// Values derived from this ship's attributes that are needed every step.
+	// They only change when the attributes do, i.e. when outfits are added or
+	// removed, so they are cached instead of recomputed each time.
+	class DerivedStats {
+	public:
+		double coolingEfficiency = 1.;
+		double heatDissipation = 0.;
+		// Passive and active cooling, scaled by the cooling efficiency.
+		double cooling = 0.;
+		double activeCooling = 0.;
+		// The thrust that determines acceleration and top speed: the ship's
+		// thrusters, or its afterburner if it has no thrusters.
+		double thrust = 0.;
+		double maxVelocity = 0.;
+		double maxReverseVelocity = 0.;
+		// How much hull and shields can be repaired each step, and how much
+		// energy, fuel, and heat each point of repair costs.
+		double hullAvailable = 0.;
+		double hullEnergy = 0.;
+		double hullFuel = 0.;
+		double hullHeat = 0.;
+		double shieldsAvailable = 0.;
+		double shieldsEnergy = 0.;
+		double shieldsFuel = 0.;
+		double shieldsHeat = 0.;
+	};
+	DerivedStats derived;
+	
 	// The hull may spring a "leak" (venting atmosphere, flames, blood, etc.)
 	// when the ship is dying.
 	class Leak {
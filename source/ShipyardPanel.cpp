@@ -87,6 +87,11 @@ ShipyardPanel::ShipyardPanel(PlayerInfo &player)
 	
 	if(player.GetPlanet())
 		shipyard = player.GetPlanet()->Shipyard();
+	for(const Ship *ship : shipyard)
+	{
+		GameData::Preload(ship->Thumbnail());
+		GameData::Preload(ship->GetSprite());
+	}
 }
 
 
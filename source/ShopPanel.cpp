@@ -27,6 +27,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "PlayerInfo.h"
 #include "PointerShader.h"
 #include "Preferences.h"
+#include "RenderCommands.h"
 #include "Sale.h"
 #include "Screen.h"
 #include "Ship.h"
@@ -67,6 +68,10 @@ ShopPanel::ShopPanel(PlayerInfo &player, bool isOutfitter)
 {
 	if(playerShip)
 		playerShips.insert(playerShip);
+	// Start loading the sprites of the player's ships, which are shown in the
+	// sidebar, in case they have been unloaded.
+	for(const shared_ptr<Ship> &ship : player.Ships())
+		GameData::Preload(ship->GetSprite());
 	SetIsFullScreen(true);
 	SetInterruptible(false);
 }
@@ -103,7 +108,7 @@ void ShopPanel::Draw()
 {
 	const double oldSelectedTopY = selectedTopY;
 	
-	glClear(GL_COLOR_BUFFER_BIT);
+	RenderCommands::Clear(GL_COLOR_BUFFER_BIT);
 	
 	// Clear the list of clickable zones.
 	zones.clear();
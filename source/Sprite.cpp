@@ -14,20 +14,40 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "ImageBuffer.h"
 #include "Preferences.h"
+#include "RenderCommands.h"
 #include "Screen.h"
+#include "TextureAtlas.h"
 
 #include "gl_header.h"
 #include <SDL2/SDL.h>
 
 #include <algorithm>
+#include <cmath>
 
 using namespace std;
 
+namespace {
+	// Images up to this size (in 1x pixels) are put in a texture atlas. There
+	// are far fewer sprites that are larger than this, and they would waste
+	// a lot more of the atlas's space.
+	const int MAX_ATLAS_SIZE = 128;
+	
+	// Get the atlas for 1x or 2x images. This is only created once it is
+	// needed, since OpenGL must be initialized first.
+	TextureAtlas &Atlas(bool is2x)
+	{
+		static TextureAtlas atlas[2];
+		return atlas[is2x];
+	}
+}
+
 
 
 Sprite::Sprite(const string &name)
-	: name(name)
+	: name(name), drawn(false)
 {
+	inAtlas[0] = false;
+	inAtlas[1] = false;
 }
 
 
@@ -58,23 +78,61 @@ void Sprite::AddFrames(ImageBuffer &buffer, bool is2x)
 	if(Preferences::Has("Reduce large graphics") && buffer.Width() * buffer.Height() >= 1000000)
 		buffer.ShrinkToHalfSize();
 	
+	// Space in the atlas is never freed, so if this sprite is being loaded
+	// again, its frames are still there.
+	if(inAtlas[is2x])
+	{
+		buffer.Clear();
+		return;
+	}
+	// Small images are copied into a texture atlas, so that they can be drawn
+	// along with other small sprites without switching textures.
+	int maxAtlasSize = MAX_ATLAS_SIZE * (1 + is2x);
+	if(buffer.Width() <= maxAtlasSize && buffer.Height() <= maxAtlasSize)
+	{
+		TextureAtlas &atlas = Atlas(is2x);
+		vector<TexturePacker::Rect> rects;
+		uint32_t page = atlas.Add(buffer, rects);
+		if(page)
+		{
+			float scale = 1.f / atlas.LayerSize();
+			regions[is2x].clear();
+			for(const TexturePacker::Rect &it : rects)
+			{
+				regions[is2x].emplace_back();
+				Region &region = regions[is2x].back();
+				region.layer = it.layer;
+				region.rect[0] = it.x * scale;
+				region.rect[1] = it.y * scale;
+				region.rect[2] = (it.x + buffer.Width()) * scale;
+				region.rect[3] = (it.y + buffer.Height()) * scale;
+			}
+			texture[is2x] = page;
+			// The regions may be read by another thread as soon as this is set.
+			inAtlas[is2x].store(true, memory_order_release);
+			buffer.Clear();
+			return;
+		}
+	}
+	
 	// Upload the images as a single array texture.
-	glGenTextures(1, &texture[is2x]);
-	glBindTexture(GL_TEXTURE_2D_ARRAY, texture[is2x]);
+	texture[is2x] = RenderCommands::GenTexture();
+	RenderCommands::BindTexture(GL_TEXTURE_2D_ARRAY, texture[is2x]);
 	
 	// Use linear interpolation and no wrapping.
-	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	RenderCommands::TexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	RenderCommands::TexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	RenderCommands::TexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	RenderCommands::TexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 	
 	// Upload the image data.
-	glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, // target, mipmap level, internal format,
+	RenderCommands::TexImage3D(GL_TEXTURE_2D_ARRAY, GL_RGBA8, // target, internal format,
 		buffer.Width(), buffer.Height(), buffer.Frames(), // width, height, depth,
-		0, GL_BGRA, GL_UNSIGNED_BYTE, buffer.Pixels()); // border, input format, data type, data.
+		GL_BGRA, GL_UNSIGNED_BYTE, buffer.Pixels()); // input format, data type, data.
+	bytes += sizeof(uint32_t) * buffer.Width() * buffer.Height() * buffer.Frames();
 	
 	// Unbind the texture.
-	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+	RenderCommands::BindTexture(GL_TEXTURE_2D_ARRAY, 0);
 	
 	// Free the ImageBuffer memory.
 	buffer.Clear();
@@ -86,22 +144,44 @@ void Sprite::AddFrames(ImageBuffer &buffer, bool is2x)
 // vector will be cleared.
 void Sprite::AddMasks(vector<Mask> &masks)
 {
-	this->masks.swap(masks);
+	// If this sprite is being reloaded after it was unloaded, keep the masks it
+	// already has, since they may be in use by the game right now.
+	if(this->masks.empty())
+		this->masks.swap(masks);
 	masks.clear();
 }
 
 
 
-// Free up all textures loaded for this sprite.
+// Free up all textures loaded for this sprite. Its dimensions and masks are
+// kept, because the game may still need them even if it is not drawn. Any
+// frames that are in a texture atlas stay there.
 void Sprite::Unload()
 {
-	glDeleteTextures(2, texture);
-	texture[0] = texture[1] = 0;
-	
-	masks.clear();
-	width = 0.f;
-	height = 0.f;
-	frames = 0;
+	for(int i = 0; i < 2; ++i)
+		if(!inAtlas[i])
+		{
+			RenderCommands::DeleteTexture(texture[i]);
+			texture[i] = 0;
+		}
+	bytes = 0;
+}
+
+
+
+// Get the number of bytes of video memory used by this sprite's textures.
+size_t Sprite::Bytes() const
+{
+	return bytes;
+}
+
+
+
+// Check whether this sprite's texture has been used for drawing since the
+// last time this was called.
+bool Sprite::WasDrawn() const
+{
+	return drawn.exchange(false, memory_order_relaxed);
 }
 
 
@@ -150,11 +230,43 @@ uint32_t Sprite::Texture() const
 // Get the index of the texture for the given high DPI mode.
 uint32_t Sprite::Texture(bool isHighDPI) const
 {
+	drawn.store(true, memory_order_relaxed);
 	return (isHighDPI && texture[1]) ? texture[1] : texture[0];
 }
 
 
 
+// Get where the given frame is stored in the texture for the given high DPI
+// mode. This does not mark the sprite as having been drawn.
+Sprite::Region Sprite::GetRegion(int frame, bool isHighDPI) const
+{
+	frame = (frames > 0 && frame > 0) ? frame % frames : 0;
+	
+	bool is2x = (isHighDPI && texture[1]);
+	if(inAtlas[is2x].load(memory_order_acquire) && frame < static_cast<int>(regions[is2x].size()))
+		return regions[is2x][frame];
+	
+	// Otherwise, each frame fills one whole layer of the sprite's own texture.
+	Region region;
+	region.layer = frame;
+	return region;
+}
+
+
+
+// Get the two frames to blend between in order to draw the given (possibly
+// fractional) frame of the animation. Returns how much of the second frame
+// should be blended in.
+float Sprite::GetRegions(float frame, bool isHighDPI, Region &first, Region &second) const
+{
+	float whole = floor(frame);
+	first = GetRegion(whole, isHighDPI);
+	second = GetRegion(ceil(frame), isHighDPI);
+	return frame - whole;
+}
+
+
+
 // Get the collision mask for the given frame of the animation.
 const Mask &Sprite::GetMask(int frame) const
 {
@@ -16,6 +16,8 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Mask.h"
 #include "Point.h"
 
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -26,11 +28,22 @@ class ImageBuffer;
 
 // Class representing a drawable sprite. A sprite can have multiple frames, for
 // animation. Certain sprites will also include a "mask" that can be used to
-// check whether something has collided with them. Each frame is stored in a
-// separate OpenGL texture object. This may not be as efficient as sprite
-// sheets, but with modern graphics cards it will not matter much and it makes
-// working with the graphics a lot simpler.
+// check whether something has collided with them. The frames are stored as the
+// layers of an OpenGL array texture, except that small sprites are copied into
+// a texture atlas so that many different ones can be drawn in a single batch.
 class Sprite {
+public:
+	// Where one frame of a sprite is stored within its texture: the layer of the
+	// array texture, and the left, top, right, and bottom edges of the frame in
+	// texture coordinates. Small sprites share a texture atlas with many other
+	// sprites, so each of their frames only takes up a small part of a layer.
+	class Region {
+	public:
+		float layer = 0.f;
+		float rect[4] = {0.f, 0.f, 1.f, 1.f};
+	};
+	
+	
 public:
 	explicit Sprite(const std::string &name = "");
 	
@@ -41,8 +54,14 @@ public:
 	// Move the given masks into this sprite's internal storage. The given
 	// vector will be cleared.
 	void AddMasks(std::vector<Mask> &masks);
-	// Free up all textures loaded for this sprite.
+	// Free up all textures loaded for this sprite. Its dimensions and masks are
+	// kept, because the game may still need them even if it is not drawn.
 	void Unload();
+	// Get the number of bytes of video memory used by this sprite's textures.
+	std::size_t Bytes() const;
+	// Check whether this sprite's texture has been used for drawing since the
+	// last time this was called.
+	bool WasDrawn() const;
 	
 	// Image dimensions, in pixels.
 	float Width() const;
@@ -59,6 +78,13 @@ public:
 	// setting or specifying it manually.
 	uint32_t Texture() const;
 	uint32_t Texture(bool isHighDPI) const;
+	// Get where the given frame is stored in the texture for the given high DPI
+	// mode. This does not mark the sprite as having been drawn.
+	Region GetRegion(int frame, bool isHighDPI) const;
+	// Get the two frames to blend between in order to draw the given (possibly
+	// fractional) frame of the animation. Returns how much of the second frame
+	// should be blended in.
+	float GetRegions(float frame, bool isHighDPI, Region &first, Region &second) const;
 	// Get the collision mask for the given frame of the animation.
 	const Mask &GetMask(int frame = 0) const;
 	
@@ -67,6 +93,14 @@ private:
 	std::string name;
 	
 	uint32_t texture[2] = {0, 0};
+	// Whether each of the textures is a page of a texture atlas, which is shared
+	// with other sprites. If so, this is where each frame was put in it.
+	std::atomic<bool> inAtlas[2];
+	std::vector<Region> regions[2];
+	std::size_t bytes = 0;
+	// Textures are looked up while the draw lists are filled in, which may
+	// happen in a different thread than the one keeping track of them.
+	mutable std::atomic<bool> drawn;
 	std::vector<Mask> masks;
 	
 	float width = 0.f;
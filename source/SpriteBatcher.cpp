@@ -0,0 +1,121 @@
+/* SpriteBatcher.cpp
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "SpriteBatcher.h"
+
+#include <cmath>
+
+using namespace std;
+
+namespace {
+	// How many batches to look back through for one that an item can be added
+	// to. This limits how long adding each item can take, even if there are
+	// many batches that it does not overlap.
+	const size_t MAX_LOOKBACK = 32;
+	
+	bool Overlaps(const SpriteBatcher::Batch &batch, float left, float top, float right, float bottom)
+	{
+		// Sprites that just touch are treated as overlapping, to be safe.
+		return !(right < batch.left || left > batch.right || bottom < batch.top || top > batch.bottom);
+	}
+}
+
+
+
+// Remove all the batches, but keep the memory allocated for them so that
+// filling the batcher again with a similar set of items does not need to
+// allocate any.
+void SpriteBatcher::Clear()
+{
+	for(size_t i = 0; i < size; ++i)
+		batches[i].items.clear();
+	size = 0;
+}
+
+
+
+// Add an item, after all the items that have already been added.
+void SpriteBatcher::Add(const SpriteShader::Item &item)
+{
+	// The item is drawn as a unit square, transformed by its matrix. Blurring
+	// it stretches the square by up to the blur vector in each direction.
+	float width = .5f + fabs(item.blur[0]);
+	float height = .5f + fabs(item.blur[1]);
+	float dx = fabs(item.transform[0]) * width + fabs(item.transform[2]) * height;
+	float dy = fabs(item.transform[1]) * width + fabs(item.transform[3]) * height;
+	float left = item.position[0] - dx;
+	float top = item.position[1] - dy;
+	float right = item.position[0] + dx;
+	float bottom = item.position[1] + dy;
+	bool isBlurred = (item.blur[0] || item.blur[1]);
+	
+	// Find the most recent batch with the same settings that this item can be
+	// added to without being drawn below anything that it overlaps.
+	Batch *batch = nullptr;
+	for(size_t i = size; i-- > 0 && size - i <= MAX_LOOKBACK; )
+	{
+		Batch &it = batches[i];
+		if(it.texture == item.texture && it.swizzle == item.swizzle && it.isBlurred == isBlurred)
+		{
+			batch = &it;
+			break;
+		}
+		if(Overlaps(it, left, top, right, bottom))
+			break;
+	}
+	
+	if(batch)
+	{
+		batch->left = min(batch->left, left);
+		batch->top = min(batch->top, top);
+		batch->right = max(batch->right, right);
+		batch->bottom = max(batch->bottom, bottom);
+	}
+	else
+	{
+		// Start a new batch, reusing one from a previous frame if possible.
+		if(size == batches.size())
+			batches.emplace_back();
+		batch = &batches[size++];
+		batch->texture = item.texture;
+		batch->swizzle = item.swizzle;
+		batch->isBlurred = isBlurred;
+		batch->left = left;
+		batch->top = top;
+		batch->right = right;
+		batch->bottom = bottom;
+	}
+	batch->items.push_back(item);
+}
+
+
+
+// Iterate over the batches, in the order in which they should be drawn.
+vector<SpriteBatcher::Batch>::const_iterator SpriteBatcher::begin() const
+{
+	return batches.begin();
+}
+
+
+
+vector<SpriteBatcher::Batch>::const_iterator SpriteBatcher::end() const
+{
+	return batches.begin() + size;
+}
+
+
+
+// Get the number of batches.
+size_t SpriteBatcher::Size() const
+{
+	return size;
+}
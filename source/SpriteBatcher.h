@@ -0,0 +1,73 @@
+/* SpriteBatcher.h
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef SPRITE_BATCHER_H_
+#define SPRITE_BATCHER_H_
+
+#include "SpriteShader.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+
+// Class that groups the sprites in a DrawList into batches that can each be
+// drawn with a single draw call, because they use the same texture, swizzle,
+// and kind of blur. Sprites are drawn in the order they were added, except
+// that a sprite may be moved earlier, into an existing batch, if it does not
+// overlap anything that was added in between. So, the result looks exactly the
+// same as drawing the sprites one at a time: anything that was added later
+// (e.g. the flagship) is still drawn on top of everything it covers. This class
+// does not make any OpenGL calls, so it can be used in any thread.
+class SpriteBatcher {
+public:
+	class Batch {
+	public:
+		uint32_t texture = 0;
+		uint32_t swizzle = 0;
+		bool isBlurred = false;
+		// The items in this batch, in the order in which they must be drawn.
+		std::vector<SpriteShader::Item> items;
+		// The bounding box of all the items, in screen coordinates.
+		float left = 0.f;
+		float top = 0.f;
+		float right = 0.f;
+		float bottom = 0.f;
+	};
+
+
+public:
+	// Remove all the batches, but keep the memory allocated for them so that
+	// filling the batcher again with a similar set of items does not need to
+	// allocate any.
+	void Clear();
+	// Add an item, after all the items that have already been added.
+	void Add(const SpriteShader::Item &item);
+	
+	// Iterate over the batches, in the order in which they should be drawn.
+	std::vector<Batch>::const_iterator begin() const;
+	std::vector<Batch>::const_iterator end() const;
+	// Get the number of batches.
+	size_t Size() const;
+
+
+private:
+	// Batches past the first "size" of them are not in use, but are kept for
+	// the memory allocated for their items.
+	std::vector<Batch> batches;
+	size_t size = 0;
+};
+
+
+
+#endif
@@ -12,9 +12,11 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "SpriteQueue.h"
 
+#include "FrameTimer.h"
 #include "ImageBuffer.h"
 #include "ImageSet.h"
 #include "Mask.h"
+#include "Profiler.h"
 #include "Sprite.h"
 #include "SpriteSet.h"
 
@@ -50,15 +52,21 @@ SpriteQueue::~SpriteQueue()
 
 
 // Add a sprite to load.
-void SpriteQueue::Add(const shared_ptr<ImageSet> &images)
+void SpriteQueue::Add(const shared_ptr<ImageSet> &images, Priority priority)
 {
+	bool isHigh = (priority == Priority::HIGH);
+	if(isHigh)
+	{
+		lock_guard<mutex> lock(loadMutex);
+		urgent.insert(images.get());
+	}
 	{
 		lock_guard<mutex> lock(readMutex);
 		// Do nothing if we are destroying the queue already.
 		if(added < 0)
 			return;
 		
-		toRead.push(images);
+		(isHigh ? toReadFirst : toRead).push_back(images);
 		++added;
 	}
 	readCondition.notify_one();
@@ -66,6 +74,39 @@ void SpriteQueue::Add(const shared_ptr<ImageSet> &images)
 
 
 
+// If the given sprite is still waiting to be loaded, move it to the front of
+// the queue, ahead of all the sprites of normal priority.
+void SpriteQueue::Prioritize(const string &name)
+{
+	auto isNamed = [&name](const shared_ptr<ImageSet> &imageSet) noexcept -> bool
+	{
+		return imageSet->Name() == name;
+	};
+	
+	lock_guard<mutex> lock(loadMutex);
+	// If the sprite has already been read, just upload it next.
+	auto it = find_if(toLoad.begin(), toLoad.end(), isNamed);
+	if(it != toLoad.end())
+	{
+		shared_ptr<ImageSet> imageSet = *it;
+		toLoad.erase(it);
+		toLoad.push_front(imageSet);
+		urgent.insert(imageSet.get());
+		return;
+	}
+	
+	lock_guard<mutex> readLock(readMutex);
+	it = find_if(toRead.begin(), toRead.end(), isNamed);
+	if(it != toRead.end())
+	{
+		toReadFirst.push_back(*it);
+		urgent.insert(it->get());
+		toRead.erase(it);
+	}
+}
+
+
+
 // Unload the texture for the given sprite (to free up memory).
 void SpriteQueue::Unload(const string &name)
 {
@@ -84,6 +125,15 @@ double SpriteQueue::Progress()
 
 
 
+// Check whether all the high priority sprites have been uploaded.
+bool SpriteQueue::IsPriorityDone()
+{
+	unique_lock<mutex> lock(loadMutex);
+	return urgent.empty();
+}
+
+
+
 // Finish loading.
 void SpriteQueue::Finish()
 {
@@ -116,12 +166,13 @@ void SpriteQueue::operator()()
 			// "added" to -1.
 			if(added < 0)
 				return;
-			if(toRead.empty())
+			if(toReadFirst.empty() && toRead.empty())
 				break;
 			
 			// Extract the one item we should work on reading right now.
-			shared_ptr<ImageSet> imageSet = toRead.front();
-			toRead.pop();
+			deque<shared_ptr<ImageSet>> &queue = (toReadFirst.empty() ? toRead : toReadFirst);
+			shared_ptr<ImageSet> imageSet = queue.front();
+			queue.pop_front();
 			
 			// It's now safe to add to the lists.
 			lock.unlock();
@@ -129,12 +180,17 @@ void SpriteQueue::operator()()
 			// Load the sprite.
 			// TODO: investigate catching exceptions from Load() (e.g. bad_alloc), to enable
 			// the UI thread to display a message prior to terminating the process.
+			FrameTimer timer;
 			imageSet->Load();
+			Profiler::Add("read sprites (incl. masks)", imageSet->Name(), timer.Time());
 			
 			{
 				// The texture must be uploaded to OpenGL in the main thread.
 				unique_lock<mutex> lock(loadMutex);
-				toLoad.push(imageSet);
+				if(urgent.count(imageSet.get()))
+					toLoad.push_front(imageSet);
+				else
+					toLoad.push_back(imageSet);
 			}
 			loadCondition.notify_one();
 			
@@ -163,14 +219,17 @@ double SpriteQueue::DoLoad(unique_lock<mutex> &lock)
 	{
 		// Extract the one item we should work on uploading right now.
 		shared_ptr<ImageSet> imageSet = toLoad.front();
-		toLoad.pop();
+		toLoad.pop_front();
 		
 		// It's now safe to modify the lists.
 		lock.unlock();
 		
+		FrameTimer timer;
 		imageSet->Upload(SpriteSet::Modify(imageSet->Name()));
+		Profiler::Add("upload sprites", imageSet->Name(), timer.Time());
 		
 		lock.lock();
+		urgent.erase(imageSet.get());
 		++completed;
 	}
 	
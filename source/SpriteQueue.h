@@ -14,10 +14,12 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #define SPRITE_QUEUE_H_
 
 #include <condition_variable>
+#include <deque>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <queue>
+#include <set>
 #include <string>
 #include <thread>
 #include <vector>
@@ -32,6 +34,15 @@ class Sprite;
 // Class for queuing up a list of sprites to be loaded from the disk, with a set of
 // worker threads that begins loading them as soon as they are added.
 class SpriteQueue {
+public:
+	// Sprites that are needed right away (e.g. to draw the main menu) are read
+	// and uploaded before any sprites of normal priority.
+	enum class Priority : int {
+		HIGH = 0,
+		NORMAL
+	};
+	
+	
 public:
 	SpriteQueue();
 	~SpriteQueue();
@@ -43,12 +54,17 @@ public:
 	SpriteQueue &operator=(SpriteQueue &&other) = delete;
 	
 	// Add a sprite to load.
-	void Add(const std::shared_ptr<ImageSet> &images);
+	void Add(const std::shared_ptr<ImageSet> &images, Priority priority = Priority::NORMAL);
+	// If the given sprite is still waiting to be loaded, move it to the front of
+	// the queue, ahead of all the sprites of normal priority.
+	void Prioritize(const std::string &name);
 	// Unload the texture for the given sprite (to free up memory).
 	void Unload(const std::string &name);
 	// Upload more images and find out our percent completion.
 	// TODO: make this a const accessor.
 	double Progress();
+	// Check whether all the high priority sprites have been uploaded.
+	bool IsPriorityDone();
 	// Finish loading.
 	void Finish();
 	
@@ -61,17 +77,23 @@ private:
 	
 	
 private:
-	// These are the image sets that need to be loaded from disk.
-	std::queue<std::shared_ptr<ImageSet>> toRead;
+	// These are the image sets that need to be loaded from disk. The high
+	// priority ones are read first.
+	std::deque<std::shared_ptr<ImageSet>> toReadFirst;
+	std::deque<std::shared_ptr<ImageSet>> toRead;
 	std::mutex readMutex;
 	std::condition_variable readCondition;
 	int added = 0;
 	
 	// These image sets have been loaded from disk but have not been uplodaed.
-	std::queue<std::shared_ptr<ImageSet>> toLoad;
+	// High priority image sets are placed at the front.
+	std::deque<std::shared_ptr<ImageSet>> toLoad;
 	std::mutex loadMutex;
 	std::condition_variable loadCondition;
 	int completed = 0;
+	// The high priority image sets that have not been uploaded yet. This is
+	// protected by loadMutex.
+	std::set<const ImageSet *> urgent;
 	
 	// These sprites must be unloaded to reclaim GPU memory.
 	std::queue<std::string> toUnload;
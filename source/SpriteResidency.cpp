@@ -0,0 +1,160 @@
+/* SpriteResidency.cpp
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "SpriteResidency.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace {
+	// A sprite that was drawn in the last few steps may still be in a draw
+	// list that has not been drawn yet, so it must not be unloaded.
+	const int MIN_IDLE_STEPS = 2;
+}
+
+
+
+SpriteResidency::SpriteResidency(Backend &backend)
+	: backend(backend)
+{
+}
+
+
+
+// Set the maximum number of bytes that the managed sprites may use. Zero
+// means that there is no limit.
+void SpriteResidency::SetBudget(size_t bytes)
+{
+	budget = bytes;
+}
+
+
+
+size_t SpriteResidency::Budget() const
+{
+	return budget;
+}
+
+
+
+// Start managing the given sprite, specifying whether it is already loaded
+// (or about to be), or must wait until it is requested.
+void SpriteResidency::Manage(const Sprite *sprite, bool isLoaded)
+{
+	if(!sprite)
+		return;
+	
+	Entry &entry = sprites[sprite];
+	entry.isResident = isLoaded;
+	entry.lastUsed = step;
+}
+
+
+
+bool SpriteResidency::IsManaged(const Sprite *sprite) const
+{
+	return sprites.count(sprite);
+}
+
+
+
+// Make sure the given sprite is loaded, and treat it as if it was just
+// drawn so that it is not immediately unloaded again. This does nothing if
+// the sprite is not managed.
+void SpriteResidency::Request(const Sprite *sprite)
+{
+	auto it = sprites.find(sprite);
+	if(it == sprites.end())
+		return;
+	
+	it->second.lastUsed = step;
+	if(!it->second.isResident)
+	{
+		it->second.isResident = true;
+		backend.Load(sprite);
+	}
+}
+
+
+
+// Check whether the given managed sprite is loaded or is being loaded.
+bool SpriteResidency::IsResident(const Sprite *sprite) const
+{
+	auto it = sprites.find(sprite);
+	return (it != sprites.end() && it->second.isResident);
+}
+
+
+
+// Find out which sprites were drawn since the last step, load any of them
+// that had been unloaded, and then unload the least recently drawn sprites
+// until the total size is within the budget.
+void SpriteResidency::Step()
+{
+	++step;
+	
+	size_t total = 0;
+	// Sprites that could be unloaded, along with when they were last used.
+	vector<pair<int, const Sprite *>> idle;
+	for(auto &it : sprites)
+	{
+		Entry &entry = it.second;
+		if(backend.WasDrawn(it.first))
+		{
+			entry.lastUsed = step;
+			// A sprite that was drawn after being unloaded was drawn without a
+			// texture, so load it again as soon as possible.
+			if(!entry.isResident)
+			{
+				entry.isResident = true;
+				backend.Load(it.first);
+			}
+		}
+		if(!entry.isResident)
+			continue;
+		
+		size_t bytes = backend.Bytes(it.first);
+		total += bytes;
+		// Sprites that have not finished loading do not take up any space yet.
+		if(bytes && step - entry.lastUsed >= MIN_IDLE_STEPS)
+			idle.emplace_back(entry.lastUsed, it.first);
+	}
+	if(!budget || total <= budget)
+		return;
+	
+	// Unload the least recently used sprites first.
+	sort(idle.begin(), idle.end());
+	for(const auto &it : idle)
+	{
+		if(total <= budget)
+			break;
+		
+		total -= backend.Bytes(it.second);
+		backend.Unload(it.second);
+		sprites[it.second].isResident = false;
+	}
+}
+
+
+
+// Get the number of bytes used by all the managed sprites that are loaded.
+size_t SpriteResidency::ResidentBytes() const
+{
+	size_t total = 0;
+	for(const auto &it : sprites)
+		if(it.second.isResident)
+			total += backend.Bytes(it.first);
+	return total;
+}
@@ -0,0 +1,95 @@
+/* SpriteResidency.h
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef SPRITE_RESIDENCY_H_
+#define SPRITE_RESIDENCY_H_
+
+#include <cstddef>
+#include <map>
+
+class Sprite;
+
+
+
+// Class that decides which sprites should have their textures loaded into video
+// memory. A sprite that this class manages is loaded when it is requested or
+// drawn, and whenever the textures of all the managed sprites take up more than
+// the budget, the ones that were drawn least recently are unloaded. Sprites
+// that are not managed are never unloaded.
+class SpriteResidency {
+public:
+	// The interface used to actually load and unload the textures. The game
+	// uses the SpriteQueue for this, but a backend that does not need OpenGL
+	// can be substituted (e.g. for testing).
+	class Backend {
+	public:
+		virtual ~Backend() = default;
+		
+		// Begin loading the textures for the given sprite.
+		virtual void Load(const Sprite *sprite) = 0;
+		// Free the textures for the given sprite.
+		virtual void Unload(const Sprite *sprite) = 0;
+		// Get the number of bytes of textures currently loaded for the given
+		// sprite. This is zero until the sprite has been uploaded.
+		virtual std::size_t Bytes(const Sprite *sprite) const = 0;
+		// Check whether the given sprite has been drawn since the last time
+		// this was called for it.
+		virtual bool WasDrawn(const Sprite *sprite) = 0;
+	};
+
+
+public:
+	explicit SpriteResidency(Backend &backend);
+	
+	// Set the maximum number of bytes that the managed sprites may use. Zero
+	// means that there is no limit.
+	void SetBudget(std::size_t bytes);
+	std::size_t Budget() const;
+	
+	// Start managing the given sprite, specifying whether it is already loaded
+	// (or about to be), or must wait until it is requested.
+	void Manage(const Sprite *sprite, bool isLoaded);
+	bool IsManaged(const Sprite *sprite) const;
+	// Make sure the given sprite is loaded, and treat it as if it was just
+	// drawn so that it is not immediately unloaded again. This does nothing if
+	// the sprite is not managed.
+	void Request(const Sprite *sprite);
+	// Check whether the given managed sprite is loaded or is being loaded.
+	bool IsResident(const Sprite *sprite) const;
+	
+	// Find out which sprites were drawn since the last step, load any of them
+	// that had been unloaded, and then unload the least recently drawn sprites
+	// until the total size is within the budget.
+	void Step();
+	// Get the number of bytes used by all the managed sprites that are loaded.
+	std::size_t ResidentBytes() const;
+
+
+private:
+	class Entry {
+	public:
+		bool isResident = false;
+		// The step in which this sprite was last drawn or requested.
+		int lastUsed = 0;
+	};
+
+
+private:
+	Backend &backend;
+	std::size_t budget = 0;
+	int step = 0;
+	std::map<const Sprite *, Entry> sprites;
+};
+
+
+
+#endif
@@ -13,6 +13,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "SpriteShader.h"
 
 #include "Point.h"
+#include "RenderCommands.h"
 #include "Screen.h"
 #include "Shader.h"
 #include "Sprite.h"
@@ -25,18 +26,61 @@ using namespace std;
 namespace {
 	Shader shader;
 	GLint scaleI;
-	GLint frameI;
-	GLint frameCountI;
-	GLint positionI;
-	GLint transformI;
-	GLint blurI;
-	GLint clipI;
-	GLint alphaI;
 	GLint swizzlerI;
 	
+	// Each sprite that is drawn has these attributes, which are the same for all
+	// four of its vertices. They are packed into an array of floats in this
+	// order, so that a whole batch of sprites can be drawn from one buffer.
+	class Attribute {
+	public:
+		const char *name;
+		int size;
+	};
+	const Attribute ATTRIBUTES[] = {
+		{"position", 2},
+		{"transform", 4},
+		{"blur", 2},
+		{"clip", 1},
+		{"firstRect", 4},
+		{"secondRect", 4},
+		{"layers", 2},
+		{"fade", 1},
+		{"alpha", 1}
+	};
+	const int ATTRIBUTE_COUNT = sizeof(ATTRIBUTES) / sizeof(ATTRIBUTES[0]);
+	const int INSTANCE_SIZE = 21;
+	GLint attributeI[ATTRIBUTE_COUNT];
+	
 	GLuint vao;
 	GLuint vbo;
-
+	// The buffer for the attributes of each sprite in a batch, if instancing is
+	// supported. Otherwise, each sprite is drawn separately, with its attributes
+	// set as constant values for all its vertices.
+	GLuint instanceVbo;
+	// The attributes of the sprites in the batch being drawn.
+	vector<float> instances;
+	// The texture that is currently bound. Consecutive sprites often share a
+	// texture atlas, so there is no need to bind it again for each of them.
+	GLuint boundTexture = 0;
+	
+	// Append the attributes for the given item to the given array.
+	void Pack(const SpriteShader::Item &item, bool withBlur, vector<float> &data)
+	{
+		data.insert(data.end(), item.position, item.position + 2);
+		data.insert(data.end(), item.transform, item.transform + 4);
+		// Special case: check if the blur should be applied or not.
+		data.push_back(withBlur ? item.blur[0] : 0.f);
+		data.push_back(withBlur ? item.blur[1] : 0.f);
+		// Clipping has the opposite sense in the shader.
+		data.push_back(1.f - item.clip);
+		data.insert(data.end(), item.first.rect, item.first.rect + 4);
+		data.insert(data.end(), item.second.rect, item.second.rect + 4);
+		data.push_back(item.first.layer);
+		data.push_back(item.second.layer);
+		data.push_back(item.fade);
+		data.push_back(item.alpha);
+	}
+	
 	const vector<vector<GLint>> SWIZZLE = {
 		{GL_RED, GL_GREEN, GL_BLUE, GL_ALPHA}, // 0 red + yellow markings (republic)
 		{GL_RED, GL_BLUE, GL_GREEN, GL_ALPHA}, // 1 red + magenta markings
@@ -71,60 +115,86 @@ namespace {
 }
 
 bool SpriteShader::useShaderSwizzle = false;
+bool SpriteShader::useInstancing = false;
 
 // Initialize the shaders.
-void SpriteShader::Init(bool useShaderSwizzle)
+void SpriteShader::Init(bool useShaderSwizzle, bool useInstancing)
 {
 	SpriteShader::useShaderSwizzle = useShaderSwizzle;
+	SpriteShader::useInstancing = useInstancing;
 	
 	static const char *vertexCode =
 		"// vertex sprite shader\n"
 		"uniform vec2 scale;\n"
-		"uniform vec2 position;\n"
-		"uniform mat2 transform;\n"
-		"uniform vec2 blur;\n"
-		"uniform float clip;\n"
 		
 		"in vec2 vert;\n"
+		"in vec2 position;\n"
+		"in vec4 transform;\n"
+		"in vec2 blur;\n"
+		"in float clip;\n"
+		"in vec4 firstRect;\n"
+		"in vec4 secondRect;\n"
+		"in vec2 layers;\n"
+		"in float fade;\n"
+		"in float alpha;\n"
+		
 		"out vec2 fragTexCoord;\n"
+		"flat out vec4 fragFirstRect;\n"
+		"flat out vec4 fragSecondRect;\n"
+		"flat out vec2 fragLayers;\n"
+		"flat out float fragFade;\n"
+		"flat out vec2 fragBlur;\n"
+		"flat out float fragAlpha;\n"
 		
 		"void main() {\n"
 		"  vec2 blurOff = 2 * vec2(vert.x * abs(blur.x), vert.y * abs(blur.y));\n"
-		"  gl_Position = vec4((transform * (vert + blurOff) + position) * scale, 0, 1);\n"
+		"  gl_Position = vec4((mat2(transform.xy, transform.zw) * (vert + blurOff) + position) * scale, 0, 1);\n"
 		"  vec2 texCoord = vert + vec2(.5, .5);\n"
 		"  fragTexCoord = vec2(texCoord.x, max(clip, texCoord.y)) + blurOff;\n"
+		"  fragFirstRect = firstRect;\n"
+		"  fragSecondRect = secondRect;\n"
+		"  fragLayers = layers;\n"
+		"  fragFade = fade;\n"
+		"  fragBlur = blur;\n"
+		"  fragAlpha = alpha;\n"
 		"}\n";
 	
 	ostringstream fragmentCodeStream;
 	fragmentCodeStream <<
 		"// fragment sprite shader\n"
-		"uniform sampler2DArray tex;\n"
-		"uniform float frame;\n"
-		"uniform float frameCount;\n"
-		"uniform vec2 blur;\n";
+		"uniform sampler2DArray tex;\n";
 	if(useShaderSwizzle) fragmentCodeStream <<
 		"uniform int swizzler;\n";
 	fragmentCodeStream <<
-		"uniform float alpha;\n"
 		"const int range = 5;\n"
 		
 		"in vec2 fragTexCoord;\n"
+		"flat in vec4 fragFirstRect;\n"
+		"flat in vec4 fragSecondRect;\n"
+		"flat in vec2 fragLayers;\n"
+		"flat in float fragFade;\n"
+		"flat in vec2 fragBlur;\n"
+		"flat in float fragAlpha;\n"
 		
 		"out vec4 finalColor;\n"
 		
+		// Sample one frame, given coordinates within the sprite. Samples past the
+		// edge of the sprite are clamped to it, just as a texture that is not in
+		// an atlas would be.
+		"vec4 Sample(vec2 coord, vec4 rect, float layer) {\n"
+		"  return texture(tex, vec3(mix(rect.xy, rect.zw, clamp(coord, 0., 1.)), layer));\n"
+		"}\n"
+		
 		"void main() {\n"
-		"  float first = floor(frame);\n"
-		"  float second = mod(ceil(frame), frameCount);\n"
-		"  float fade = frame - first;\n"
 		"  vec4 color;\n"
-		"  if(blur.x == 0 && blur.y == 0)\n"
+		"  if(fragBlur.x == 0 && fragBlur.y == 0)\n"
 		"  {\n"
-		"    if(fade != 0)\n"
+		"    if(fragFade != 0)\n"
 		"      color = mix(\n"
-		"        texture(tex, vec3(fragTexCoord, first)),\n"
-		"        texture(tex, vec3(fragTexCoord, second)), fade);\n"
+		"        Sample(fragTexCoord, fragFirstRect, fragLayers.x),\n"
+		"        Sample(fragTexCoord, fragSecondRect, fragLayers.y), fragFade);\n"
 		"    else\n"
-		"      color = texture(tex, vec3(fragTexCoord, first));\n"
+		"      color = Sample(fragTexCoord, fragFirstRect, fragLayers.x);\n"
 		"  }\n"
 		"  else\n"
 		"  {\n"
@@ -133,13 +203,13 @@ void SpriteShader::Init(bool useShaderSwizzle)
 		"    for(int i = -range; i <= range; ++i)\n"
 		"    {\n"
 		"      float scale = (range + 1 - abs(i)) / divisor;\n"
-		"      vec2 coord = fragTexCoord + (blur * i) / range;\n"
-		"      if(fade != 0)\n"
+		"      vec2 coord = fragTexCoord + (fragBlur * i) / range;\n"
+		"      if(fragFade != 0)\n"
 		"        color += scale * mix(\n"
-		"          texture(tex, vec3(coord, first)),\n"
-		"          texture(tex, vec3(coord, second)), fade);\n"
+		"          Sample(coord, fragFirstRect, fragLayers.x),\n"
+		"          Sample(coord, fragSecondRect, fragLayers.y), fragFade);\n"
 		"      else\n"
-		"        color += scale * texture(tex, vec3(coord, first));\n"
+		"        color += scale * Sample(coord, fragFirstRect, fragLayers.x);\n"
 		"    }\n"
 		"  }\n";
 	
@@ -238,7 +308,7 @@ void SpriteShader::Init(bool useShaderSwizzle)
 		"  }\n";
 	}
 	fragmentCodeStream <<
-		"  finalColor = color * alpha;\n"
+		"  finalColor = color * fragAlpha;\n"
 		"}\n";
 	
 	static const string fragmentCodeString = fragmentCodeStream.str();
@@ -246,26 +316,21 @@ void SpriteShader::Init(bool useShaderSwizzle)
 	
 	shader = Shader(vertexCode, fragmentCode);
 	scaleI = shader.Uniform("scale");
-	frameI = shader.Uniform("frame");
-	frameCountI = shader.Uniform("frameCount");
-	positionI = shader.Uniform("position");
-	transformI = shader.Uniform("transform");
-	blurI = shader.Uniform("blur");
-	clipI = shader.Uniform("clip");
-	alphaI = shader.Uniform("alpha");
 	if(useShaderSwizzle)
 		swizzlerI = shader.Uniform("swizzler");
+	for(int i = 0; i < ATTRIBUTE_COUNT; ++i)
+		attributeI[i] = shader.Attrib(ATTRIBUTES[i].name);
 	
-	glUseProgram(shader.Object());
-	glUniform1i(shader.Uniform("tex"), 0);
-	glUseProgram(0);
+	RenderCommands::UseProgram(shader.Object());
+	RenderCommands::Uniform1i(shader.Uniform("tex"), 0);
+	RenderCommands::UseProgram(0);
 	
 	// Generate the vertex data for drawing sprites.
-	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
+	vao = RenderCommands::GenVertexArray();
+	RenderCommands::BindVertexArray(vao);
 	
-	glGenBuffers(1, &vbo);
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	vbo = RenderCommands::GenBuffer();
+	RenderCommands::BindBuffer(GL_ARRAY_BUFFER, vbo);
 	
 	GLfloat vertexData[] = {
 		-.5f, -.5f,
@@ -273,14 +338,33 @@ void SpriteShader::Init(bool useShaderSwizzle)
 		 .5f, -.5f,
 		 .5f,  .5f
 	};
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertexData), vertexData, GL_STATIC_DRAW);
+	RenderCommands::BufferData(GL_ARRAY_BUFFER, sizeof(vertexData), vertexData, GL_STATIC_DRAW);
+	
+	RenderCommands::EnableVertexAttribArray(shader.Attrib("vert"));
+	RenderCommands::VertexAttribPointer(shader.Attrib("vert"), 2, GL_FLOAT, false, 2 * sizeof(GLfloat), 0);
 	
-	glEnableVertexAttribArray(shader.Attrib("vert"));
-	glVertexAttribPointer(shader.Attrib("vert"), 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), nullptr);
+	// If instancing is supported, the attributes of each sprite come from a
+	// separate buffer, and advance once per sprite instead of once per vertex.
+	if(useInstancing)
+	{
+		instanceVbo = RenderCommands::GenBuffer();
+		RenderCommands::BindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+		
+		constexpr auto stride = INSTANCE_SIZE * sizeof(float);
+		size_t offset = 0;
+		for(int i = 0; i < ATTRIBUTE_COUNT; ++i)
+		{
+			RenderCommands::EnableVertexAttribArray(attributeI[i]);
+			RenderCommands::VertexAttribPointer(attributeI[i], ATTRIBUTES[i].size, GL_FLOAT, false, stride,
+				offset * sizeof(float));
+			RenderCommands::VertexAttribDivisor(attributeI[i], 1);
+			offset += ATTRIBUTES[i].size;
+		}
+	}
 	
 	// unbind the VBO and VAO
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	RenderCommands::BindBuffer(GL_ARRAY_BUFFER, 0);
+	RenderCommands::BindVertexArray(0);
 }
 
 
@@ -292,8 +376,7 @@ void SpriteShader::Draw(const Sprite *sprite, const Point &position, float zoom,
 	
 	Item item;
 	item.texture = sprite->Texture();
-	item.frame = frame;
-	item.frameCount = sprite->Frames();
+	item.fade = sprite->GetRegions(frame, Screen::IsHighResolution(), item.first, item.second);
 	// Position.
 	item.position[0] = static_cast<float>(position.X());
 	item.position[1] = static_cast<float>(position.Y());
@@ -312,51 +395,95 @@ void SpriteShader::Draw(const Sprite *sprite, const Point &position, float zoom,
 
 void SpriteShader::Bind()
 {
-	glUseProgram(shader.Object());
-	glBindVertexArray(vao);
+	RenderCommands::UseProgram(shader.Object());
+	RenderCommands::BindVertexArray(vao);
 	
 	GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
-	glUniform2fv(scaleI, 1, scale);
+	RenderCommands::Uniform2fv(scaleI, scale);
+	
+	RenderCommands::BindTexture(GL_TEXTURE_2D_ARRAY, 0);
+	boundTexture = 0;
 }
 
 
 
 void SpriteShader::Add(const Item &item, bool withBlur)
 {
-	glBindTexture(GL_TEXTURE_2D_ARRAY, item.texture);
+	Add(&item, 1, withBlur);
+}
+
+
+
+// Draw several items that all use the same texture and swizzle. If instancing
+// is supported, they are all drawn with a single draw call.
+void SpriteShader::Add(const vector<Item> &items, bool withBlur)
+{
+	if(!items.empty())
+		Add(items.data(), items.size(), withBlur);
+}
+
 
-	glUniform1f(frameI, item.frame);
-	glUniform1f(frameCountI, item.frameCount);
-	glUniform2fv(positionI, 1, item.position);
-	glUniformMatrix2fv(transformI, 1, false, item.transform);
-	// Special case: check if the blur should be applied or not.
-	static const float UNBLURRED[2] = {0.f, 0.f};
-	glUniform2fv(blurI, 1, withBlur ? item.blur : UNBLURRED);
-	// Clipping has the opposite sense in the shader.
-	glUniform1f(clipI, 1.f - item.clip);
-	glUniform1f(alphaI, item.alpha);
+
+void SpriteShader::Unbind()
+{
+	RenderCommands::BindVertexArray(0);
+	RenderCommands::UseProgram(0);
 	
-	// Bounds check for the swizzle value:
-	int swizzle = (static_cast<size_t>(item.swizzle) >= SWIZZLE.size() ? 0 : item.swizzle);
-	// Set the color swizzle.
+	// Reset the swizzle.
 	if(SpriteShader::useShaderSwizzle)
-		glUniform1i(swizzlerI, swizzle);
+		RenderCommands::Uniform1i(swizzlerI, 0);
 	else
-		glTexParameteriv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_SWIZZLE_RGBA, SWIZZLE[swizzle].data());
-	
-	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+		RenderCommands::TexParameteriv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_SWIZZLE_RGBA, SWIZZLE[0].data());
 }
 
 
 
-void SpriteShader::Unbind()
+void SpriteShader::Add(const Item *items, size_t count, bool withBlur)
 {
-	glBindVertexArray(0);
-	glUseProgram(0);
+	const Item &front = items[0];
+	if(front.texture != boundTexture)
+	{
+		RenderCommands::BindTexture(GL_TEXTURE_2D_ARRAY, front.texture);
+		boundTexture = front.texture;
+	}
 	
-	// Reset the swizzle.
+	// Bounds check for the swizzle value:
+	int swizzle = (static_cast<size_t>(front.swizzle) >= SWIZZLE.size() ? 0 : front.swizzle);
+	// Set the color swizzle.
 	if(SpriteShader::useShaderSwizzle)
-		glUniform1i(swizzlerI, 0);
+		RenderCommands::Uniform1i(swizzlerI, swizzle);
 	else
-		glTexParameteriv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_SWIZZLE_RGBA, SWIZZLE[0].data());
+		RenderCommands::TexParameteriv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_SWIZZLE_RGBA, SWIZZLE[swizzle].data());
+	
+	instances.clear();
+	for(size_t i = 0; i < count; ++i)
+		Pack(items[i], withBlur, instances);
+	
+	if(useInstancing)
+	{
+		RenderCommands::BindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+		RenderCommands::BufferData(GL_ARRAY_BUFFER, sizeof(float) * instances.size(), instances.data(), GL_STREAM_DRAW);
+		RenderCommands::BindBuffer(GL_ARRAY_BUFFER, 0);
+		RenderCommands::DrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(count));
+		return;
+	}
+	
+	// Without instancing, the attributes are given as constant values for all
+	// the vertices of one sprite at a time.
+	const float *it = instances.data();
+	for(size_t i = 0; i < count; ++i)
+	{
+		for(const Attribute &attribute : ATTRIBUTES)
+		{
+			GLint index = attributeI[&attribute - ATTRIBUTES];
+			if(attribute.size == 1)
+				RenderCommands::VertexAttrib1fv(index, it);
+			else if(attribute.size == 2)
+				RenderCommands::VertexAttrib2fv(index, it);
+			else
+				RenderCommands::VertexAttrib4fv(index, it);
+			it += attribute.size;
+		}
+		RenderCommands::DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	}
 }
@@ -13,10 +13,13 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #ifndef SPRITE_SHADER_H_
 #define SPRITE_SHADER_H_
 
-class Sprite;
-class Point;
+#include "Sprite.h"
 
+#include <cstddef>
 #include <cstdint>
+#include <vector>
+
+class Point;
 
 
 
@@ -31,8 +34,11 @@ public:
 	public:
 		uint32_t texture = 0;
 		uint32_t swizzle = 0;
-		float frame = 0.f;
-		float frameCount = 1.f;
+		// Where the two frames to blend between are in the texture, and how
+		// much of the second one to blend in.
+		Sprite::Region first;
+		Sprite::Region second;
+		float fade = 0.f;
 		float position[2] = {0.f, 0.f};
 		float transform[4] = {0.f, 0.f, 0.f, 0.f};
 		float blur[2] = {0.f, 0.f};
@@ -43,18 +49,26 @@ public:
 	
 public:
 	// Initialize the shaders.
-	static void Init(bool useShaderSwizzle);
+	static void Init(bool useShaderSwizzle, bool useInstancing);
 	
 	// Draw a sprite.
 	static void Draw(const Sprite *sprite, const Point &position, float zoom = 1.f, int swizzle = 0, float frame = 0.f);
 	
 	static void Bind();
 	static void Add(const Item &item, bool withBlur = false);
+	// Draw several items that all use the same texture and swizzle. If instancing
+	// is supported, they are all drawn with a single draw call.
+	static void Add(const std::vector<Item> &items, bool withBlur = false);
 	static void Unbind();
 	
 	
+private:
+	static void Add(const Item *items, size_t count, bool withBlur);
+	
+	
 private:
 	static bool useShaderSwizzle;
+	static bool useInstancing;
 };
 
 
@@ -19,6 +19,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Point.h"
 #include "Preferences.h"
 #include "Random.h"
+#include "RenderCommands.h"
 #include "Screen.h"
 #include "Sprite.h"
 #include "SpriteSet.h"
@@ -93,8 +94,8 @@ void StarField::Draw(const Point &pos, const Point &vel, double zoom) const
 	// Draw the starfield unless it is disabled in the preferences.
 	if(Preferences::Has("Draw starfield"))
 	{
-		glUseProgram(shader.Object());
-		glBindVertexArray(vao);
+		RenderCommands::UseProgram(shader.Object());
+		RenderCommands::BindVertexArray(vao);
 	
 		float length = vel.Length();
 		Point unit = length ? vel.Unit() : Point(1., 0.);
@@ -104,15 +105,15 @@ void StarField::Draw(const Point &pos, const Point &vel, double zoom) const
 	
 		float baseZoom = static_cast<float>(2. * zoom);
 		GLfloat scale[2] = {baseZoom / Screen::Width(), -baseZoom / Screen::Height()};
-		glUniform2fv(scaleI, 1, scale);
+		RenderCommands::Uniform2fv(scaleI, scale);
 	
 		GLfloat rotate[4] = {
 			static_cast<float>(unit.Y()), static_cast<float>(-unit.X()),
 			static_cast<float>(unit.X()), static_cast<float>(unit.Y())};
-		glUniformMatrix2fv(rotateI, 1, false, rotate);
+		RenderCommands::UniformMatrix2fv(rotateI, rotate);
 	
-		glUniform1f(elongationI, length * zoom);
-		glUniform1f(brightnessI, min(1., pow(zoom, .5)));
+		RenderCommands::Uniform1f(elongationI, length * zoom);
+		RenderCommands::Uniform1f(brightnessI, min(1., pow(zoom, .5)));
 	
 		// Stars this far beyond the border may still overlap the screen.
 		double borderX = fabs(vel.X()) + 1.;
@@ -134,16 +135,16 @@ void StarField::Draw(const Point &pos, const Point &vel, double zoom) const
 					static_cast<float>(off.X()),
 					static_cast<float>(off.Y())
 				};
-				glUniform2fv(translateI, 1, translate);
+				RenderCommands::Uniform2fv(translateI, translate);
 				
 				int index = (gx & widthMod) / TILE_SIZE + ((gy & widthMod) / TILE_SIZE) * tileCols;
 				int first = 6 * tileIndex[index];
 				int count = 6 * tileIndex[index + 1] - first;
-				glDrawArrays(GL_TRIANGLES, first, count);
+				RenderCommands::DrawArrays(GL_TRIANGLES, first, count);
 			}
 	
-		glBindVertexArray(0);
-		glUseProgram(0);
+		RenderCommands::BindVertexArray(0);
+		RenderCommands::UseProgram(0);
 	}
 	
 	// Draw the background haze unless it is disabled in the preferences.
@@ -215,12 +216,12 @@ void StarField::SetUpGraphics()
 	shader = Shader(vertexCode, fragmentCode);
 	
 	// make and bind the VAO
-	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
+	vao = RenderCommands::GenVertexArray();
+	RenderCommands::BindVertexArray(vao);
 	
 	// make and bind the VBO
-	glGenBuffers(1, &vbo);
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	vbo = RenderCommands::GenBuffer();
+	RenderCommands::BindBuffer(GL_ARRAY_BUFFER, vbo);
 	
 	offsetI = shader.Attrib("offset");
 	sizeI = shader.Attrib("size");
@@ -328,23 +329,23 @@ void StarField::MakeStars(int stars, int width)
 	// Adjust the tile indices so that tileIndex[i] is the start of tile i.
 	tileIndex.insert(tileIndex.begin(), 0);
 
-	glBufferData(GL_ARRAY_BUFFER, sizeof(data.front()) * data.size(), data.data(), GL_STATIC_DRAW);
+	RenderCommands::BufferData(GL_ARRAY_BUFFER, sizeof(data.front()) * data.size(), data.data(), GL_STATIC_DRAW);
 	
 	// Connect the xy to the "vert" attribute of the vertex shader.
 	constexpr auto stride = 4 * sizeof(GLfloat);
-	glEnableVertexAttribArray(offsetI);
-	glVertexAttribPointer(offsetI, 2, GL_FLOAT, GL_FALSE,
-		stride, nullptr);
+	RenderCommands::EnableVertexAttribArray(offsetI);
+	RenderCommands::VertexAttribPointer(offsetI, 2, GL_FLOAT, false,
+		stride, 0);
 	
-	glEnableVertexAttribArray(sizeI);
-	glVertexAttribPointer(sizeI, 1, GL_FLOAT, GL_FALSE,
-		stride, reinterpret_cast<const GLvoid *>(2 * sizeof(GLfloat)));
+	RenderCommands::EnableVertexAttribArray(sizeI);
+	RenderCommands::VertexAttribPointer(sizeI, 1, GL_FLOAT, false,
+		stride, 2 * sizeof(GLfloat));
 	
-	glEnableVertexAttribArray(cornerI);
-	glVertexAttribPointer(cornerI, 1, GL_FLOAT, GL_FALSE,
-		stride, reinterpret_cast<const GLvoid *>(3 * sizeof(GLfloat)));
+	RenderCommands::EnableVertexAttribArray(cornerI);
+	RenderCommands::VertexAttribPointer(cornerI, 1, GL_FLOAT, false,
+		stride, 3 * sizeof(GLfloat));
 	
 	// unbind the VBO and VAO
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	RenderCommands::BindBuffer(GL_ARRAY_BUFFER, 0);
+	RenderCommands::BindVertexArray(0);
 }
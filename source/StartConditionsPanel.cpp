@@ -29,6 +29,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Planet.h"
 #include "Preferences.h"
 #include "Rectangle.h"
+#include "RenderCommands.h"
 #include "ShipyardPanel.h"
 #include "StarField.h"
 #include "StartConditions.h"
@@ -76,7 +77,7 @@ StartConditionsPanel::StartConditionsPanel(PlayerInfo &player, UI &gamePanels, c
 
 void StartConditionsPanel::Draw()
 {
-	glClear(GL_COLOR_BUFFER_BIT);
+	RenderCommands::Clear(GL_COLOR_BUFFER_BIT);
 	GameData::Background().Draw(Point(), Point());
 	
 	GameData::Interfaces().Get("menu background")->Draw(info, this);
@@ -237,7 +238,10 @@ void StartConditionsPanel::OnConversationEnd(int)
 	if(parent)
 		GetUI()->Pop(parent);
 	
-	GetUI()->Pop(GetUI()->Root().get());
+	// If the game is still loading, go back to the main menu, which lets the
+	// player enter the game once all the sprites have been loaded.
+	if(GameData::IsLoaded())
+		GetUI()->Pop(GetUI()->Root().get());
 	GetUI()->Pop(this);
 }
 
@@ -23,6 +23,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "Planet.h"
 #include "Random.h"
 #include "SpriteSet.h"
+#include "SystemGrid.h"
 
 #include <algorithm>
 #include <cmath>
@@ -392,25 +393,30 @@ void System::Load(const DataNode &node, Set<Planet> &planets)
 // Update any information about the system that may have changed due to events,
 // or because the game was started, e.g. neighbors, solar wind and power, or
 // if the system is inhabited.
-void System::UpdateSystem(const Set<System> &systems, const set<double> &neighborDistances)
+void System::UpdateSystem(const SystemGrid &grid, const set<double> &neighborDistances)
 {
 	neighbors.clear();
 	// Neighbors are cached for each system for the purpose of quicker
 	// pathfinding. If this system has a static jump range then that
 	// is the only range that we need to create jump neighbors for, but
 	// otherwise we must create a set of neighbors for every potential
-	// jump range that can be encountered.
+	// jump range that can be encountered. Only the systems that are near
+	// enough for the largest of those ranges need to be checked.
 	if(jumpRange)
 	{
-		UpdateNeighbors(systems, jumpRange);
+		const vector<const System *> nearby = grid.Near(position, max(jumpRange, DEFAULT_NEIGHBOR_DISTANCE));
+		UpdateNeighbors(nearby, jumpRange);
 		// Systems with a static jump range must also create a set for
 		// the DEFAULT_NEIGHBOR_DISTANCE to be returned for those systems
 		// which are visible from it.
-		UpdateNeighbors(systems, DEFAULT_NEIGHBOR_DISTANCE);
+		UpdateNeighbors(nearby, DEFAULT_NEIGHBOR_DISTANCE);
 	}
-	else
+	else if(!neighborDistances.empty())
+	{
+		const vector<const System *> nearby = grid.Near(position, *neighborDistances.rbegin());
 		for(const double distance : neighborDistances)
-			UpdateNeighbors(systems, distance);
+			UpdateNeighbors(nearby, distance);
+	}
 	
 	// Calculate the solar power and solar wind.
 	solarPower = 0.;
@@ -774,6 +780,16 @@ double System::Exports(const string &commodity) const
 
 
 
+// Get this system's price of the given commodity, or null if it is not
+// traded here. This stays valid until this system is changed.
+System::Price *System::GetPrice(const string &commodity)
+{
+	auto it = trade.find(commodity);
+	return (it == trade.end()) ? nullptr : &it->second;
+}
+
+
+
 // Get the probabilities of various fleets entering this system.
 const vector<System::FleetProbability> &System::Fleets() const
 {
@@ -848,7 +864,7 @@ void System::LoadObject(const DataNode &node, Set<Planet> &planets, int parent)
 // Once the star map is fully loaded or an event has changed systems
 // or links, figure out which stars are "neighbors" of this one, i.e.
 // close enough to see or to reach via jump drive.
-void System::UpdateNeighbors(const Set<System> &systems, double distance)
+void System::UpdateNeighbors(const vector<const System *> &nearby, double distance)
 {
 	set<const System *> &neighborSet = neighbors[distance];
 	
@@ -858,16 +874,10 @@ void System::UpdateNeighbors(const Set<System> &systems, double distance)
 		neighborSet.insert(system);
 	
 	// Any other star system that is within the neighbor distance is also a
-	// neighbor.
-	for(const auto &it : systems)
-	{
-		// Skip systems that have no name.
-		if(it.first.empty() || it.second.Name().empty())
-			continue;
-
-		if(&it.second != this && it.second.Position().Distance(position) <= distance)
-			neighborSet.insert(&it.second);
-	}
+	// neighbor. (The given systems never include ones that have no name.)
+	for(const System *system : nearby)
+		if(system != this && system->Position().Distance(position) <= distance)
+			neighborSet.insert(system);
 }
 
 
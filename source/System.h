@@ -30,6 +30,7 @@ class Minable;
 class Planet;
 class Ship;
 class Sprite;
+class SystemGrid;
 
 
 
@@ -83,13 +84,25 @@ public:
 		int period;
 	};
 	
+	// The price of one commodity, and the supply of it that determines the price.
+	class Price {
+	public:
+		void SetBase(int base);
+		void Update();
+		
+		int base = 0;
+		int price = 0;
+		double supply = 0.;
+		double exports = 0.;
+	};
+	
 	
 public:
 	// Load a system's description.
 	void Load(const DataNode &node, Set<Planet> &planets);
 	// Update any information about the system that may have changed due to events,
 	// e.g. neighbors, solar wind and power, or if the system is inhabited.
-	void UpdateSystem(const Set<System> &systems, const std::set<double> &neighborDistances);
+	void UpdateSystem(const SystemGrid &grid, const std::set<double> &neighborDistances);
 	
 	// Modify a system's links.
 	void Link(System *other);
@@ -162,6 +175,9 @@ public:
 	void SetSupply(const std::string &commodity, double tons);
 	double Supply(const std::string &commodity) const;
 	double Exports(const std::string &commodity) const;
+	// Get this system's price of the given commodity, or null if it is not
+	// traded here. This stays valid until this system is changed.
+	Price *GetPrice(const std::string &commodity);
 	
 	// Get the probabilities of various fleets entering this system.
 	const std::vector<FleetProbability> &Fleets() const;
@@ -177,20 +193,7 @@ private:
 	// Once the star map is fully loaded or an event has changed systems
 	// or links, figure out which stars are "neighbors" of this one, i.e.
 	// close enough to see or to reach via jump drive.
-	void UpdateNeighbors(const Set<System> &systems, double distance);
-	
-	
-private:
-	class Price {
-	public:
-		void SetBase(int base);
-		void Update();
-		
-		int base = 0;
-		int price = 0;
-		double supply = 0.;
-		double exports = 0.;
-	};
+	void UpdateNeighbors(const std::vector<const System *> &nearby, double distance);
 	
 	
 private:
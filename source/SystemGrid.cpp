@@ -0,0 +1,101 @@
+/* SystemGrid.cpp
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "SystemGrid.h"
+
+#include "System.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+	// Never make more than this many cells per system, even if the systems are
+	// spread out over a very large area.
+	const double MAX_CELLS_PER_SYSTEM = 16.;
+}
+
+
+
+// Sort all the named systems into cells of (at least) the given size.
+SystemGrid::SystemGrid(const Set<System> &systems, double cellSize)
+{
+	vector<const System *> named;
+	for(const auto &it : systems)
+		if(!it.first.empty() && !it.second.Name().empty())
+			named.push_back(&it.second);
+	if(named.empty())
+		return;
+	
+	Point topLeft = named.front()->Position();
+	Point bottomRight = topLeft;
+	for(const System *system : named)
+	{
+		topLeft = Point(min(topLeft.X(), system->Position().X()), min(topLeft.Y(), system->Position().Y()));
+		bottomRight = Point(max(bottomRight.X(), system->Position().X()), max(bottomRight.Y(), system->Position().Y()));
+	}
+	Point size = bottomRight - topLeft;
+	
+	// Make the cells bigger if there would otherwise be far more of them than
+	// there are systems to put in them.
+	this->cellSize = max(1., cellSize);
+	double maxCells = MAX_CELLS_PER_SYSTEM * named.size();
+	while((floor(size.X() / this->cellSize) + 1.) * (floor(size.Y() / this->cellSize) + 1.) > maxCells)
+		this->cellSize *= 2.;
+	
+	corner = topLeft;
+	columns = static_cast<int>(size.X() / this->cellSize) + 1;
+	rows = static_cast<int>(size.Y() / this->cellSize) + 1;
+	cells.resize(columns * rows);
+	for(const System *system : named)
+		cells[Row(system->Position().Y()) * columns + Column(system->Position().X())].push_back(system);
+}
+
+
+
+// Get the systems in every cell that is within the given distance of the
+// given point. This includes every system that is within that distance,
+// but may also include others that are farther away.
+vector<const System *> SystemGrid::Near(const Point &point, double distance) const
+{
+	vector<const System *> result;
+	if(cells.empty() || distance < 0.)
+		return result;
+	
+	int left = Column(point.X() - distance);
+	int right = Column(point.X() + distance);
+	int top = Row(point.Y() - distance);
+	int bottom = Row(point.Y() + distance);
+	for(int row = top; row <= bottom; ++row)
+		for(int column = left; column <= right; ++column)
+		{
+			const vector<const System *> &cell = cells[row * columns + column];
+			result.insert(result.end(), cell.begin(), cell.end());
+		}
+	return result;
+}
+
+
+
+// Get the column or row that the given coordinate is in, clamped to the grid.
+int SystemGrid::Column(double x) const
+{
+	return static_cast<int>(max(0., min(columns - 1., floor((x - corner.X()) / cellSize))));
+}
+
+
+
+int SystemGrid::Row(double y) const
+{
+	return static_cast<int>(max(0., min(rows - 1., floor((y - corner.Y()) / cellSize))));
+}
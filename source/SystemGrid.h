@@ -0,0 +1,57 @@
+/* SystemGrid.h
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef SYSTEM_GRID_H_
+#define SYSTEM_GRID_H_
+
+#include "Point.h"
+#include "Set.h"
+
+#include <vector>
+
+class System;
+
+
+
+// Class that sorts the star systems into a grid of square cells by their
+// positions on the map, so that the systems near a given point can be found
+// without checking the distance to every system in the universe.
+class SystemGrid {
+public:
+	// Sort all the named systems into cells of (at least) the given size.
+	SystemGrid(const Set<System> &systems, double cellSize);
+	
+	// Get the systems in every cell that is within the given distance of the
+	// given point. This includes every system that is within that distance,
+	// but may also include others that are farther away.
+	std::vector<const System *> Near(const Point &point, double distance) const;
+
+
+private:
+	// Get the column or row that the given coordinate is in, clamped to the grid.
+	int Column(double x) const;
+	int Row(double y) const;
+
+
+private:
+	// The top left corner of the grid, and the size of each cell.
+	Point corner;
+	double cellSize = 1.;
+	int columns = 0;
+	int rows = 0;
+	// The systems in each cell, row by row.
+	std::vector<std::vector<const System *>> cells;
+};
+
+
+
+#endif
@@ -0,0 +1,116 @@
+/* TextureAtlas.cpp
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "TextureAtlas.h"
+
+#include "ImageBuffer.h"
+#include "RenderCommands.h"
+
+#include "gl_header.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+	// Each page of the atlas has this many layers of this size (or the largest
+	// size the graphics card supports, if that is smaller). With 4 bytes per
+	// pixel, a page is 32 MB.
+	const int LAYER_SIZE = 2048;
+	const int LAYERS_PER_PAGE = 2;
+	// Each image is surrounded by a copy of its own edge pixels, so that linear
+	// filtering at its edges never picks up any of its neighbors' pixels.
+	const int PADDING = 1;
+	
+	int GetLayerSize()
+	{
+		GLint maxSize = RenderCommands::GetInteger(GL_MAX_TEXTURE_SIZE);
+		return maxSize > 0 ? min<int>(maxSize, LAYER_SIZE) : LAYER_SIZE;
+	}
+	
+	// Copy the given frame into a larger buffer, surrounded by its edge pixels.
+	void Pad(const ImageBuffer &image, int frame, vector<uint32_t> &result)
+	{
+		int width = image.Width();
+		int height = image.Height();
+		result.clear();
+		result.reserve((width + 2 * PADDING) * (height + 2 * PADDING));
+		for(int y = -PADDING; y < height + PADDING; ++y)
+		{
+			const uint32_t *row = image.Begin(max(0, min(height - 1, y)), frame);
+			result.insert(result.end(), PADDING, row[0]);
+			result.insert(result.end(), row, row + width);
+			result.insert(result.end(), PADDING, row[width - 1]);
+		}
+	}
+}
+
+
+
+// This must only be constructed once OpenGL has been initialized.
+TextureAtlas::TextureAtlas()
+	: packer(GetLayerSize(), LAYERS_PER_PAGE, PADDING)
+{
+}
+
+
+
+// Copy all the frames of the given image into the atlas, and get the place
+// where each of them was put. The returned texture is the page that holds
+// them. If they do not fit in the atlas, this returns 0 instead.
+uint32_t TextureAtlas::Add(const ImageBuffer &image, vector<TexturePacker::Rect> &rects)
+{
+	if(!image.Pixels() || !packer.Add(image.Width(), image.Height(), image.Frames(), rects))
+		return 0;
+	
+	// If a new page was needed for these images, create it.
+	const int size = packer.LayerSize();
+	while(static_cast<int>(pages.size()) < packer.Pages())
+	{
+		pages.push_back(RenderCommands::GenTexture());
+		RenderCommands::BindTexture(GL_TEXTURE_2D_ARRAY, pages.back());
+		
+		// Use the same settings as for the textures of individual sprites.
+		RenderCommands::TexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		RenderCommands::TexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		RenderCommands::TexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		RenderCommands::TexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		
+		// Allocate all the layers of the page, without initializing them.
+		RenderCommands::TexImage3D(GL_TEXTURE_2D_ARRAY, GL_RGBA8, size, size, LAYERS_PER_PAGE,
+			GL_BGRA, GL_UNSIGNED_BYTE, nullptr);
+	}
+	
+	uint32_t texture = pages[rects.front().page];
+	RenderCommands::BindTexture(GL_TEXTURE_2D_ARRAY, texture);
+	vector<uint32_t> padded;
+	for(int frame = 0; frame < image.Frames(); ++frame)
+	{
+		const TexturePacker::Rect &rect = rects[frame];
+		Pad(image, frame, padded);
+		RenderCommands::TexSubImage3D(GL_TEXTURE_2D_ARRAY, // target,
+			rect.x - PADDING, rect.y - PADDING, rect.layer, // x, y, and layer offsets,
+			image.Width() + 2 * PADDING, image.Height() + 2 * PADDING, 1, // width, height, depth,
+			GL_BGRA, GL_UNSIGNED_BYTE, padded.data()); // input format, data type, data.
+	}
+	RenderCommands::BindTexture(GL_TEXTURE_2D_ARRAY, 0);
+	
+	return texture;
+}
+
+
+
+// Get the size of each layer of the atlas, in pixels.
+int TextureAtlas::LayerSize() const
+{
+	return packer.LayerSize();
+}
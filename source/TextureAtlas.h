@@ -0,0 +1,51 @@
+/* TextureAtlas.h
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef TEXTURE_ATLAS_H_
+#define TEXTURE_ATLAS_H_
+
+#include "TexturePacker.h"
+
+#include <cstdint>
+#include <vector>
+
+class ImageBuffer;
+
+
+
+// Class that copies many small images into a few large array textures, so that
+// they can be drawn without switching textures in between. The TexturePacker
+// decides where each image goes, and this class owns the textures themselves.
+// Space in the atlas is never freed. This must only be used in the thread that
+// owns the OpenGL context.
+class TextureAtlas {
+public:
+	// This must only be constructed once OpenGL has been initialized.
+	TextureAtlas();
+	
+	// Copy all the frames of the given image into the atlas, and get the place
+	// where each of them was put. The returned texture is the page that holds
+	// them. If they do not fit in the atlas, this returns 0 instead.
+	uint32_t Add(const ImageBuffer &image, std::vector<TexturePacker::Rect> &rects);
+	
+	// Get the size of each layer of the atlas, in pixels.
+	int LayerSize() const;
+
+
+private:
+	TexturePacker packer;
+	std::vector<uint32_t> pages;
+};
+
+
+
+#endif
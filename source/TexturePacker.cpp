@@ -0,0 +1,183 @@
+/* TexturePacker.cpp
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "TexturePacker.h"
+
+#include <utility>
+
+using namespace std;
+
+namespace {
+	// An image may be put on an existing shelf that is up to this much taller
+	// than it. Otherwise, a new shelf is started so that little space is wasted.
+	bool IsGoodFit(int shelfHeight, int height)
+	{
+		return shelfHeight >= height && 2 * shelfHeight <= 3 * height;
+	}
+}
+
+
+
+// Each image is surrounded by the given number of pixels of padding, which
+// will not overlap with any other image or with the edge of the layer.
+TexturePacker::TexturePacker(int layerSize, int layersPerPage, int padding)
+	: layerSize(layerSize), layersPerPage(layersPerPage), padding(padding)
+{
+}
+
+
+
+// Find a place for the given number of images of the given size (i.e. the
+// frames of one sprite), all on the same page. A new page is added if none
+// of the existing ones have enough space. Returns false, without changing
+// anything, if the images would not fit even on an empty page.
+bool TexturePacker::Add(int width, int height, int count, vector<Rect> &result)
+{
+	result.clear();
+	if(width <= 0 || height <= 0 || count <= 0)
+		return false;
+	width += 2 * padding;
+	height += 2 * padding;
+	if(width > layerSize || height > layerSize)
+		return false;
+	
+	// Each page is modified through a copy, so that if only some of the images
+	// fit on it, it is left as it was.
+	bool added = false;
+	for(size_t i = 0; i < pages.size() && !added; ++i)
+	{
+		vector<Layer> page = pages[i];
+		added = AddToPage(page, i, width, height, count, result);
+		if(added)
+			pages[i].swap(page);
+	}
+	if(!added)
+	{
+		vector<Layer> page;
+		added = AddToPage(page, pages.size(), width, height, count, result);
+		if(!added)
+		{
+			result.clear();
+			return false;
+		}
+		pages.push_back(move(page));
+	}
+	
+	usedArea += static_cast<int64_t>(width) * height * count;
+	return true;
+}
+
+
+
+int TexturePacker::LayerSize() const
+{
+	return layerSize;
+}
+
+
+
+int TexturePacker::LayersPerPage() const
+{
+	return layersPerPage;
+}
+
+
+
+int TexturePacker::Pages() const
+{
+	return pages.size();
+}
+
+
+
+// Get the fraction of the area of all the pages that is in use, including
+// the padding around each image.
+double TexturePacker::Usage() const
+{
+	if(pages.empty())
+		return 0.;
+	
+	double totalArea = static_cast<double>(layerSize) * layerSize * layersPerPage * pages.size();
+	return usedArea / totalArea;
+}
+
+
+
+// Try to add the given images to the given page. If they do not all fit,
+// the page may have been partially modified.
+bool TexturePacker::AddToPage(vector<Layer> &page, int index, int width, int height, int count,
+	vector<Rect> &result) const
+{
+	result.clear();
+	for(int i = 0; i < count; ++i)
+	{
+		// First, look for the shortest shelf that this image fits well on.
+		Shelf *best = nullptr;
+		int bestLayer = 0;
+		for(size_t layer = 0; layer < page.size(); ++layer)
+			for(Shelf &shelf : page[layer].shelves)
+				if(IsGoodFit(shelf.height, height) && shelf.width + width <= layerSize
+						&& (!best || shelf.height < best->height))
+				{
+					best = &shelf;
+					bestLayer = layer;
+				}
+		
+		// If there is no such shelf, start a new one at the bottom of the first
+		// layer that has room for it, adding a layer if necessary.
+		if(!best)
+		{
+			for(size_t layer = 0; layer < page.size() && !best; ++layer)
+				if(page[layer].height + height <= layerSize)
+				{
+					Layer &it = page[layer];
+					it.shelves.emplace_back();
+					it.shelves.back().y = it.height;
+					it.shelves.back().height = height;
+					it.height += height;
+					best = &it.shelves.back();
+					bestLayer = layer;
+				}
+			if(!best && static_cast<int>(page.size()) < layersPerPage)
+			{
+				page.emplace_back();
+				page.back().shelves.emplace_back();
+				page.back().height = height;
+				best = &page.back().shelves.back();
+				best->height = height;
+				bestLayer = page.size() - 1;
+			}
+		}
+		
+		// As a last resort, use a shelf that is much taller than this image.
+		if(!best)
+			for(size_t layer = 0; layer < page.size(); ++layer)
+				for(Shelf &shelf : page[layer].shelves)
+					if(shelf.height >= height && shelf.width + width <= layerSize
+							&& (!best || shelf.height < best->height))
+					{
+						best = &shelf;
+						bestLayer = layer;
+					}
+		if(!best)
+			return false;
+		
+		result.emplace_back();
+		Rect &rect = result.back();
+		rect.page = index;
+		rect.layer = bestLayer;
+		rect.x = best->width + padding;
+		rect.y = best->y + padding;
+		best->width += width;
+	}
+	return true;
+}
@@ -0,0 +1,93 @@
+/* TexturePacker.h
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#ifndef TEXTURE_PACKER_H_
+#define TEXTURE_PACKER_H_
+
+#include <cstdint>
+#include <vector>
+
+
+
+// Class that decides where to put images within a texture atlas, without doing
+// any of the actual copying. The atlas is made up of "pages," each of which is
+// an array texture with a fixed number of square layers. Images are placed in
+// rows ("shelves") of images of similar heights. All the frames of a sprite are
+// kept on the same page, so that the sprite can be drawn (and blend between its
+// frames) with a single texture bound. A page that has space left over is used
+// for later sprites, so images can be added at any time.
+class TexturePacker {
+public:
+	// The location of the top left corner of one image.
+	class Rect {
+	public:
+		int page = 0;
+		int layer = 0;
+		int x = 0;
+		int y = 0;
+	};
+
+
+public:
+	// Each image is surrounded by the given number of pixels of padding, which
+	// will not overlap with any other image or with the edge of the layer.
+	TexturePacker(int layerSize, int layersPerPage, int padding);
+	
+	// Find a place for the given number of images of the given size (i.e. the
+	// frames of one sprite), all on the same page. A new page is added if none
+	// of the existing ones have enough space. Returns false, without changing
+	// anything, if the images would not fit even on an empty page.
+	bool Add(int width, int height, int count, std::vector<Rect> &result);
+	
+	int LayerSize() const;
+	int LayersPerPage() const;
+	int Pages() const;
+	// Get the fraction of the area of all the pages that is in use, including
+	// the padding around each image.
+	double Usage() const;
+
+
+private:
+	class Shelf {
+	public:
+		int y = 0;
+		int height = 0;
+		// How much of the width of this shelf is already used.
+		int width = 0;
+	};
+	class Layer {
+	public:
+		std::vector<Shelf> shelves;
+		// The bottom of the lowest shelf.
+		int height = 0;
+	};
+
+
+private:
+	// Try to add the given images to the given page. If they do not all fit,
+	// the page may have been partially modified.
+	bool AddToPage(std::vector<Layer> &page, int index, int width, int height, int count,
+		std::vector<Rect> &result) const;
+
+
+private:
+	int layerSize;
+	int layersPerPage;
+	int padding;
+	
+	std::vector<std::vector<Layer>> pages;
+	int64_t usedArea = 0;
+};
+
+
+
+#endif
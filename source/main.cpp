@@ -24,17 +24,25 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "FrameTimer.h"
 #include "GameData.h"
 #include "GameWindow.h"
+#include "MainPanel.h"
+#include "MapDetailPanel.h"
 #include "MenuPanel.h"
+#include "OutfitterPanel.h"
 #include "Panel.h"
 #include "PlayerInfo.h"
 #include "Preferences.h"
+#include "Profiler.h"
+#include "RenderCommands.h"
+#include "RenderCounter.h"
 #include "Screen.h"
+#include "ShipyardPanel.h"
 #include "SpriteSet.h"
 #include "SpriteShader.h"
 #include "Test.h"
 #include "UI.h"
 
 #include <chrono>
+#include <cstdint>
 #include <iostream>
 #include <map>
 
@@ -50,6 +58,8 @@ using namespace std;
 void PrintHelp();
 void PrintVersion();
 void GameLoop(PlayerInfo &player, const Conversation &conversation, const string &testToRun, bool debugMode);
+int BenchmarkRender(PlayerInfo &player);
+void BenchmarkPanel(const string &name, Panel *panel, bool step, RenderCounter &counter);
 Conversation LoadConversation();
 #ifdef _WIN32
 void InitConsole();
@@ -68,6 +78,8 @@ int main(int argc, char *argv[])
 	Conversation conversation;
 	bool debugMode = false;
 	bool loadOnly = false;
+	bool checkShips = false;
+	bool benchmarkRender = false;
 	string testToRunName = "";
 
 	for(const char *const *it = argv + 1; *it; ++it)
@@ -89,6 +101,10 @@ int main(int argc, char *argv[])
 			debugMode = true;
 		else if(arg == "-p" || arg == "--parse-save")
 			loadOnly = true;
+		else if(arg == "--check-ships")
+			checkShips = true;
+		else if(arg == "--benchmark-render")
+			benchmarkRender = true;
 		else if(arg == "--test" && *++it)
 			testToRunName = *it;
 	}
@@ -98,6 +114,13 @@ int main(int argc, char *argv[])
 		if(!GameData::BeginLoad(argv))
 			return 0;
 		
+		if(checkShips)
+		{
+			int mismatches = GameData::CheckShipStats();
+			cout << "Ship check found " << mismatches << " out of date stats." << endl;
+			return mismatches ? 1 : 0;
+		}
+		
 		if(!testToRunName.empty() && !GameData::Tests().Has(testToRunName))
 		{
 			Files::LogError("Test \"" + testToRunName + "\" not found.");
@@ -123,10 +146,13 @@ int main(int argc, char *argv[])
 		
 		Preferences::Load();
 		
+		if(benchmarkRender)
+			return BenchmarkRender(player);
+		
 		if(!GameWindow::Init())
 			return 1;
 		
-		GameData::LoadShaders(!GameWindow::HasSwizzle());
+		GameData::LoadShaders(!GameWindow::HasSwizzle(), GameWindow::HasInstancing());
 		
 		// Show something other than a blank window.
 		GameWindow::Step();
@@ -186,6 +212,9 @@ void GameLoop(PlayerInfo &player, const Conversation &conversation, const string
 	// Limit how quickly full-screen mode can be toggled.
 	int toggleTimeout = 0;
 	
+	// In debug mode, check once per second for data files that have changed.
+	int reloadTimeout = 0;
+	
 	// Data to track progress of testing if/when a test is running.
 	Test::Context testContext;
 	if(!testToRunName.empty())
@@ -268,6 +297,25 @@ void GameLoop(PlayerInfo &player, const Conversation &conversation, const string
 		if(Preferences::Has("Interrupt fast-forward") && !inFlight && isFastForward && !allowFastForward)
 			isFastForward = false;
 		
+		// Changed data files are only reloaded while a menu is open, because
+		// the game data must not change while the engine is running. The game
+		// panels are not stepped while the menu is open, but the engine may
+		// still be finishing the step it began before the menu opened.
+		if(reloadTimeout)
+			--reloadTimeout;
+		else if(debugMode && !menuPanels.IsEmpty())
+		{
+			reloadTimeout = 60;
+			MainPanel *mainPanel = dynamic_cast<MainPanel *>(gamePanels.Root().get());
+			if(mainPanel)
+				mainPanel->WaitForEngine();
+			GameData::ReloadChangedFiles();
+		}
+		
+		// Upload any sprites that have been loaded in the background, and unload
+		// any that are over the texture budget.
+		GameData::UpdateSprites();
+		
 		// Tell all the panels to step forward, then draw them.
 		((!isPaused && menuPanels.IsEmpty()) ? gamePanels : menuPanels).StepAll();
 		
@@ -325,6 +373,82 @@ void GameLoop(PlayerInfo &player, const Conversation &conversation, const string
 
 
 
+// Build frames of the main game panels without a window or a graphics card,
+// and report how long each frame took to build and how much work it would
+// have been for the graphics card to draw.
+int BenchmarkRender(PlayerInfo &player)
+{
+	// The panels can only be drawn for a pilot who is somewhere.
+	if(!player.IsLoaded() || !player.GetSystem() || !player.Flagship())
+	{
+		Files::LogError("Cannot benchmark rendering without a saved pilot who has a flagship.");
+		return 1;
+	}
+	
+	RenderCounter counter;
+	RenderCommands::SetBackend(&counter);
+	Profiler::Enable();
+	GameData::LoadShaders(false, true);
+	GameData::FinishLoading();
+	GameData::Progress();
+	Screen::SetRaw(1920, 1080);
+	
+	BenchmarkPanel("main panel", new MainPanel(player), true, counter);
+	BenchmarkPanel("map panel", new MapDetailPanel(player), false, counter);
+	// The shops can only be shown if the player is landed.
+	if(player.GetPlanet())
+	{
+		BenchmarkPanel("shipyard panel", new ShipyardPanel(player), false, counter);
+		BenchmarkPanel("outfitter panel", new OutfitterPanel(player), false, counter);
+	}
+	else
+		cout << "Skipping the shop panels, because the player is not landed." << endl;
+	
+	RenderCommands::SetBackend(nullptr);
+	return 0;
+}
+
+
+
+// Build a number of frames of the given panel, stepping it first each frame
+// if requested, and count the commands that they need. The panel is drawn
+// directly rather than through the UI, so any panels that it opens do not
+// replace it.
+void BenchmarkPanel(const string &name, Panel *panel, bool step, RenderCounter &counter)
+{
+	const int FRAMES = 300;
+	
+	UI ui;
+	ui.Push(panel);
+	ui.StepAll();
+	
+	counter.Clear();
+	uint64_t allocations = Profiler::Allocations();
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for(int i = 0; i < FRAMES; ++i)
+	{
+		if(step)
+			panel->Step();
+		panel->Draw();
+		RenderCommands::Execute();
+	}
+	chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+	allocations = Profiler::Allocations() - allocations;
+	
+	cout << name << ": " << elapsed.count() / FRAMES << " ms per frame, "
+		<< counter.drawCalls / FRAMES << " draw calls, "
+		<< counter.vertices / FRAMES << " vertices, "
+		<< counter.stateChanges / FRAMES << " state changes, "
+		<< counter.uniforms / FRAMES << " uniform changes, "
+		<< counter.bytes / FRAMES << " bytes uploaded";
+	// Allocations can only be counted in builds that define ES_COUNT_ALLOCATIONS.
+	if(Profiler::CountsAllocations())
+		cout << ", " << static_cast<double>(allocations) / FRAMES << " allocations";
+	cout << endl;
+}
+
+
+
 void PrintHelp()
 {
 	cerr << endl;
@@ -338,7 +462,15 @@ void PrintHelp()
 	cerr << "    -c, --config <path>: save user's files to given directory." << endl;
 	cerr << "    -d, --debug: turn on debugging features (e.g. Caps Lock slows down instead of speeds up)." << endl;
 	cerr << "    -p, --parse-save: load the most recent saved game and inspect it for content errors" << endl;
+	cerr << "    --benchmark-render: time building frames of the main panels for the most recent pilot, then exit." << endl;
+	cerr << "        (Allocations per frame are only counted in test builds, which define ES_COUNT_ALLOCATIONS.)" << endl;
 	cerr << "    --tests: print table of available tests, then exit." << endl;
+	cerr << "    --check-ships: check that every ship's cached stats match its outfits, then exit." << endl;
+	cerr << "    --load-times: print how long each phase of loading took, and the slowest files and sprites." << endl;
+	cerr << "    --image-cache: cache decoded images in the config directory, to speed up later launches." << endl;
+	cerr << "    --prune-image-cache: use the image cache, after removing images whose source has changed." << endl;
+	cerr << "    --clear-image-cache: use the image cache, after removing all the images in it." << endl;
+	cerr << "    --texture-budget <MB>: unload the least recently drawn sprites if they use more video memory." << endl;
 	cerr << "    --test <name>: run given test from resources directory" << endl;
 	cerr << endl;
 	cerr << "Report bugs to: <https://github.com/endless-sky/endless-sky/issues>" << endl;
@@ -17,6 +17,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "DisplayText.h"
 #include "../ImageBuffer.h"
 #include "../Point.h"
+#include "../RenderCommands.h"
 #include "../Screen.h"
 #include "truncate.hpp"
 
@@ -131,11 +132,11 @@ void Font::Draw(const string &str, const Point &point, const Color &color) const
 
 void Font::DrawAliased(const string &str, double x, double y, const Color &color) const
 {
-	glUseProgram(shader.Object());
-	glBindTexture(GL_TEXTURE_2D, texture);
-	glBindVertexArray(vao);
+	RenderCommands::UseProgram(shader.Object());
+	RenderCommands::BindTexture(GL_TEXTURE_2D, texture);
+	RenderCommands::BindVertexArray(vao);
 	
-	glUniform4fv(colorI, 1, color.Get());
+	RenderCommands::Uniform4fv(colorI, color.Get());
 	
 	// Update the scale, only if the screen size has changed.
 	if(Screen::Width() != screenWidth || Screen::Height() != screenHeight)
@@ -143,7 +144,7 @@ void Font::DrawAliased(const string &str, double x, double y, const Color &color
 		screenWidth = Screen::Width();
 		screenHeight = Screen::Height();
 		GLfloat scale[2] = {2.f / screenWidth, -2.f / screenHeight};
-		glUniform2fv(scaleI, 1, scale);
+		RenderCommands::Uniform2fv(scaleI, scale);
 	}
 	
 	GLfloat textPos[2] = {
@@ -171,31 +172,100 @@ void Font::DrawAliased(const string &str, double x, double y, const Color &color
 			continue;
 		}
 		
-		glUniform1i(glyphI, glyph);
-		glUniform1f(aspectI, 1.f);
+		RenderCommands::Uniform1i(glyphI, glyph);
+		RenderCommands::Uniform1f(aspectI, 1.f);
 		
 		textPos[0] += advance[previous * GLYPHS + glyph] + KERN;
-		glUniform2fv(positionI, 1, textPos);
+		RenderCommands::Uniform2fv(positionI, textPos);
 		
-		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+		RenderCommands::DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 		
 		if(underlineChar)
 		{
-			glUniform1i(glyphI, underscoreGlyph);
-			glUniform1f(aspectI, static_cast<float>(advance[glyph * GLYPHS] + KERN)
+			RenderCommands::Uniform1i(glyphI, underscoreGlyph);
+			RenderCommands::Uniform1f(aspectI, static_cast<float>(advance[glyph * GLYPHS] + KERN)
 				/ (advance[underscoreGlyph * GLYPHS] + KERN));
 			
-			glUniform2fv(positionI, 1, textPos);
+			RenderCommands::Uniform2fv(positionI, textPos);
 			
-			glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+			RenderCommands::DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 			underlineChar = false;
 		}
 		
 		previous = glyph;
 	}
 	
-	glBindVertexArray(0);
-	glUseProgram(0);
+	RenderCommands::BindVertexArray(0);
+	RenderCommands::UseProgram(0);
+}
+
+
+
+// Get the quads for the glyphs of the given string, with its top left corner
+// at the given point, so that the text can be drawn as part of a batch with
+// this font's texture. Each quad has four corners, in triangle strip order,
+// each of which is an (x, y) position and an (s, t) texture coordinate.
+void Font::Quads(const string &str, double x, double y, vector<float> &result) const
+{
+	// Lay out the glyphs the same way that DrawAliased() does.
+	float textPos[2] = {
+		static_cast<float>(x - 1.),
+		static_cast<float>(y)};
+	int previous = 0;
+	bool isAfterSpace = true;
+	bool underlineChar = false;
+	const int underscoreGlyph = max(0, min(GLYPHS - 1, '_' - 32));
+	auto addQuad = [this, &textPos, &result](int glyph, float aspect)
+	{
+		const float s = static_cast<float>(glyph) / GLYPHS;
+		const float ds = 1.f / GLYPHS;
+		const float left = textPos[0];
+		const float right = textPos[0] + aspect * glyphWidth;
+		const float top = textPos[1];
+		const float bottom = textPos[1] + glyphHeight;
+		result.insert(result.end(), {
+			left, top, s, 0.f,
+			left, bottom, s, 1.f,
+			right, top, s + ds, 0.f,
+			right, bottom, s + ds, 1.f});
+	};
+	
+	for(char c : str)
+	{
+		if(c == '_')
+		{
+			underlineChar = showUnderlines;
+			continue;
+		}
+		
+		int glyph = Glyph(c, isAfterSpace);
+		if(c != '"' && c != '\'')
+			isAfterSpace = !glyph;
+		if(!glyph)
+		{
+			textPos[0] += space;
+			continue;
+		}
+		
+		textPos[0] += advance[previous * GLYPHS + glyph] + KERN;
+		addQuad(glyph, 1.f);
+		
+		if(underlineChar)
+		{
+			addQuad(underscoreGlyph, static_cast<float>(advance[glyph * GLYPHS] + KERN)
+				/ (advance[underscoreGlyph * GLYPHS] + KERN));
+			underlineChar = false;
+		}
+		
+		previous = glyph;
+	}
+}
+
+
+
+uint32_t Font::Texture() const noexcept
+{
+	return texture;
 }
 
 
@@ -252,15 +322,15 @@ int Font::Glyph(char c, bool isAfterSpace) noexcept
 
 void Font::LoadTexture(ImageBuffer &image)
 {
-	glGenTextures(1, &texture);
-	glBindTexture(GL_TEXTURE_2D, texture);
+	texture = RenderCommands::GenTexture();
+	RenderCommands::BindTexture(GL_TEXTURE_2D, texture);
 	
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	RenderCommands::TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	RenderCommands::TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	RenderCommands::TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	RenderCommands::TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 	
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, image.Width(), image.Height(), 0,
+	RenderCommands::TexImage2D(GL_TEXTURE_2D, GL_RGBA8, image.Width(), image.Height(),
 		GL_BGRA, GL_UNSIGNED_BYTE, image.Pixels());
 }
 
@@ -332,18 +402,20 @@ void Font::SetUpShader(float glyphW, float glyphH)
 {
 	glyphW *= .5f;
 	glyphH *= .5f;
+	glyphWidth = glyphW;
+	glyphHeight = glyphH;
 	
 	shader = Shader(vertexCode, fragmentCode);
-	glUseProgram(shader.Object());
-	glUniform1i(shader.Uniform("tex"), 0);
-	glUseProgram(0);
+	RenderCommands::UseProgram(shader.Object());
+	RenderCommands::Uniform1i(shader.Uniform("tex"), 0);
+	RenderCommands::UseProgram(0);
 	
 	// Create the VAO and VBO.
-	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
+	vao = RenderCommands::GenVertexArray();
+	RenderCommands::BindVertexArray(vao);
 	
-	glGenBuffers(1, &vbo);
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	vbo = RenderCommands::GenBuffer();
+	RenderCommands::BindBuffer(GL_ARRAY_BUFFER, vbo);
 	
 	GLfloat vertices[] = {
 		   0.f,    0.f, 0.f, 0.f,
@@ -351,19 +423,19 @@ void Font::SetUpShader(float glyphW, float glyphH)
 		glyphW,    0.f, 1.f, 0.f,
 		glyphW, glyphH, 1.f, 1.f
 	};
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+	RenderCommands::BufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 	
 	// Connect the xy to the "vert" attribute of the vertex shader.
 	constexpr auto stride = 4 * sizeof(GLfloat);
-	glEnableVertexAttribArray(shader.Attrib("vert"));
-	glVertexAttribPointer(shader.Attrib("vert"), 2, GL_FLOAT, GL_FALSE, stride, nullptr);
+	RenderCommands::EnableVertexAttribArray(shader.Attrib("vert"));
+	RenderCommands::VertexAttribPointer(shader.Attrib("vert"), 2, GL_FLOAT, false, stride, 0);
 	
-	glEnableVertexAttribArray(shader.Attrib("corner"));
-	glVertexAttribPointer(shader.Attrib("corner"), 2, GL_FLOAT, GL_FALSE,
-		stride, reinterpret_cast<const GLvoid *>(2 * sizeof(GLfloat)));
+	RenderCommands::EnableVertexAttribArray(shader.Attrib("corner"));
+	RenderCommands::VertexAttribPointer(shader.Attrib("corner"), 2, GL_FLOAT, false,
+		stride, 2 * sizeof(GLfloat));
 	
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	RenderCommands::BindBuffer(GL_ARRAY_BUFFER, 0);
+	RenderCommands::BindVertexArray(0);
 	
 	// We must update the screen size next time we draw.
 	screenWidth = 0;
@@ -17,7 +17,9 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 #include "../gl_header.h"
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 class Color;
 class DisplayText;
@@ -43,6 +45,12 @@ public:
 	// Draw the given text string, e.g. post-formatting (or without regard to formatting).
 	void Draw(const std::string &str, const Point &point, const Color &color) const;
 	void DrawAliased(const std::string &str, double x, double y, const Color &color) const;
+	// Get the quads for the glyphs of the given string, with its top left corner
+	// at the given point, so that the text can be drawn as part of a batch with
+	// this font's texture. Each quad has four corners, in triangle strip order,
+	// each of which is an (x, y) position and an (s, t) texture coordinate.
+	void Quads(const std::string &str, double x, double y, std::vector<float> &result) const;
+	uint32_t Texture() const noexcept;
 	
 	// Determine the string's width, without considering formatting.
 	int Width(const std::string &str, char after = ' ') const;
@@ -82,6 +90,8 @@ private:
 	GLint aspectI = 0;
 	GLint positionI = 0;
 	
+	float glyphWidth = 0.f;
+	float glyphHeight = 0.f;
 	int height = 0;
 	int space = 0;
 	mutable int screenWidth = 0;
@@ -0,0 +1,103 @@
+/* test_batchDrawList.cpp
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../source/BatchDrawList.h"
+
+// Include helpers for making sprites to draw, and for counting allocations.
+#include "../../source/Body.h"
+#include "../../source/ImageBuffer.h"
+#include "../../source/Profiler.h"
+#include "../../source/RenderCommands.h"
+#include "../../source/RenderCounter.h"
+#include "../../source/Screen.h"
+#include "../../source/Sprite.h"
+
+// ... and any system includes needed for the test file.
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// Give the sprite the given number of blank frames of the given size. Small
+// sprites are put in a shared texture atlas, and large ones get their own.
+void AddFrames(Sprite &sprite, int width, int height, int frames)
+{
+	ImageBuffer buffer(frames);
+	buffer.Allocate(width, height);
+	sprite.AddFrames(buffer, false);
+}
+
+// Fill the list with one frame's worth of bodies, as the engine would.
+void AddFrame(BatchDrawList &list, const std::vector<Body> &bodies, int step)
+{
+	list.Clear(step);
+	list.SetCenter(Point());
+	for(const Body &body : bodies)
+		list.Add(body);
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Filling a batch draw list every frame", "[BatchDrawList][Allocations]" ) {
+	// Uploading the sprites needs a backend, but nothing is drawn.
+	RenderCounter counter;
+	RenderCommands::SetBackend(&counter);
+	Screen::SetRaw(1920, 1080);
+	
+	Sprite large;
+	AddFrames(large, 200, 200, 4);
+	Sprite small;
+	AddFrames(small, 32, 32, 2);
+	RenderCommands::Execute();
+	
+	GIVEN( "the same bodies are drawn in every frame" ) {
+		std::minstd_rand random(1);
+		std::vector<Body> bodies;
+		for(int i = 0; i < 100; ++i)
+			bodies.emplace_back(i % 3 ? &small : &large,
+				Point(random() % 1600 - 800., random() % 800 - 400.), Point(), Angle(static_cast<double>(random() % 360)));
+		
+		Profiler::Enable();
+		BatchDrawList list;
+		
+		WHEN( "more frames are filled in after the first one" ) {
+			// Measure without any test macros in between, since those may
+			// allocate memory themselves.
+			uint64_t start = Profiler::Allocations();
+			AddFrame(list, bodies, 0);
+			uint64_t warm = Profiler::Allocations();
+			for(int step = 1; step < 10; ++step)
+				AddFrame(list, bodies, step);
+			uint64_t after = Profiler::Allocations();
+			THEN( "only the first frame allocates any memory" ) {
+				CHECK( warm > start );
+				CHECK( after == warm );
+			}
+		}
+	}
+	
+	RenderCommands::SetBackend(nullptr);
+}
+// #endregion unit tests
+
+
+
+} // test namespace
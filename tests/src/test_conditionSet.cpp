@@ -21,12 +21,20 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "output-capture.hpp"
 
 // ... and any system includes needed for the test file.
-#include <map>
+#include <cstdint>
+#include <limits>
 #include <string>
 
 namespace { // test namespace
 
 // #region mock data
+
+// Test the given condition expressions, as a set of "and" conditions.
+bool Test(const std::string &expressions, const ConditionSet::Conditions &conditions)
+{
+	return ConditionSet{AsDataNode("and\n" + expressions)}.Test(conditions);
+}
+
 // #endregion mock data
 
 
@@ -85,6 +93,18 @@ SCENARIO( "Extending a ConditionSet", "[ConditionSet][Creation]" ) {
 			REQUIRE_FALSE( set.IsEmpty() );
 			REQUIRE( warnings.Flush() == "" );
 		}
+		WHEN( "expressions are added one at a time" ) {
+			set.Add("has", "a");
+			const auto conditions = ConditionSet::Conditions{{"a", 1}, {"b", 3}};
+			REQUIRE( set.Test(conditions) );
+			set.Add("b", ">", "4");
+			THEN( "every one of them is tested" ) {
+				CHECK_FALSE( set.Test(conditions) );
+				set.Add(std::vector<std::string>{"b"}, "=", std::vector<std::string>{"5"});
+				CHECK( set.Test(conditions) );
+				REQUIRE( warnings.Flush() == "" );
+			}
+		}
 	}
 }
 
@@ -170,9 +190,103 @@ SCENARIO( "Applying changes to conditions", "[ConditionSet][Usage]" ) {
 			CHECK( inserted->second == 3013 );
 		}
 	}
+	GIVEN( "a ConditionSet with assignments that depend on each other" ) {
+		const auto applySet = ConditionSet{AsDataNode("and\n"
+			"\ta = 3\n"
+			"\tb = a * ( a + 1 )\n"
+			"\tb -= 2\n"
+			"\tor\n"
+			"\t\tc = b / 0\n")};
+		mutableList.emplace("b", 100);
+		
+		THEN( "each assignment sees the result of the ones before it" ) {
+			applySet.Apply(mutableList);
+			CHECK( mutableList.find("a")->second == 3 );
+			CHECK( mutableList.find("b")->second == 10 );
+			CHECK( mutableList.find("c")->second == std::numeric_limits<int64_t>::max() );
+		}
+	}
+}
+
+SCENARIO( "Evaluating condition expressions", "[ConditionSet][Usage]" ) {
+	GIVEN( "a list of Conditions" ) {
+		const auto conditions = ConditionSet::Conditions{{"a", 3}, {"b", -2}, {"x y", 5}};
+		
+		THEN( "arithmetic follows the usual order of operations" ) {
+			CHECK( Test("\ta + b * 2 == -1", conditions) );
+			CHECK( Test("\t( a + b ) * 2 == 2", conditions) );
+			CHECK( Test("\ta - b - 1 == 4", conditions) );
+			CHECK( Test("\t\"x y\" % a * ( 1 + ( b + 4 ) ) == 6", conditions) );
+			CHECK( Test("\t\"x y\" / 2 * 2 == 4", conditions) );
+			CHECK( Test("\ta / ( b + 2 ) > 1000000", conditions) );
+		}
+		THEN( "conditions that are not in the list are 0" ) {
+			CHECK( Test("\tnot missing", conditions) );
+			CHECK( Test("\tmissing + a == 3", conditions) );
+		}
+		THEN( "comparisons on either side of the operator are evaluated" ) {
+			CHECK( Test("\ta * a > \"x y\" + 3", conditions) );
+			CHECK_FALSE( Test("\ta * a < \"x y\" + 3", conditions) );
+			CHECK( Test("\t0 <= random", conditions) );
+			CHECK( Test("\trandom < 100", conditions) );
+		}
+		THEN( "nested sets of conditions are combined with \"and\" and \"or\"" ) {
+			CHECK( Test("\thas a\n\tor\n\t\tnot a\n\t\tb < 0\n", conditions) );
+			CHECK_FALSE( Test("\thas a\n\tor\n\t\tnot a\n\t\tb > 0\n", conditions) );
+			CHECK( Test("\tor\n\t\tand\n\t\t\tnever\n\t\thas \"x y\"\n", conditions) );
+			CHECK_FALSE( Test("\tor\n\t\tand\n\t\t\thas a\n\t\t\tnever\n\t\tnot \"x y\"\n", conditions) );
+			CHECK_FALSE( ConditionSet{AsDataNode("or\n\tnot a\n\tnever")}.Test(conditions) );
+		}
+		THEN( "assignments in a set that is tested create temporary conditions" ) {
+			CHECK( Test("\tt = a * 2\n\tt == 6", conditions) );
+			CHECK( Test("\tt = a * 2\n\tt += t\n\tt == 12", conditions) );
+			AND_THEN( "they hide any conditions with the same name, and start at 0" ) {
+				CHECK( Test("\ta += 2\n\ta == 2", conditions) );
+				CHECK( Test("\tb = 7\n\tor\n\t\tb == 7\n\t\tnever", conditions) );
+			}
+			AND_THEN( "the given conditions are not changed" ) {
+				CHECK( conditions.size() == 3 );
+				CHECK( conditions.find("a")->second == 3 );
+			}
+		}
+	}
 }
 // #endregion unit tests
 
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark ConditionSet::Test", "[!benchmark][conditionset]" ) {
+	auto conditions = ConditionSet::Conditions{};
+	for(int i = 0; i < 10000; ++i)
+		conditions["mission " + std::to_string(i) + ": done"] = i % 2;
+	conditions["combat rating"] = 2000;
+	
+	// A set like one that a mission might use to decide whether to offer itself.
+	const auto set = ConditionSet{AsDataNode("and\n"
+		"\tnot \"mission 4000: done\"\n"
+		"\thas \"mission 4001: done\"\n"
+		"\t\"combat rating\" / 10 + 5 > 100\n"
+		"\tor\n"
+		"\t\thas \"event: war begins\"\n"
+		"\t\t\"mission 4003: done\" + \"mission 4005: done\" >= 2\n")};
+	REQUIRE( set.Test(conditions) );
+	BENCHMARK( "ConditionSet::Test()" ) {
+		return set.Test(conditions);
+	};
+	
+	// A set that assigns to temporary conditions before testing them.
+	const auto temporarySet = ConditionSet{AsDataNode("and\n"
+		"\tscore = \"combat rating\" / 100\n"
+		"\tscore += \"mission 4001: done\" * 5\n"
+		"\tscore >= 25\n")};
+	REQUIRE( temporarySet.Test(conditions) );
+	BENCHMARK( "ConditionSet::Test() with temporary conditions" ) {
+		return temporarySet.Test(conditions);
+	};
+}
+#endif
+// #endregion benchmarks
+
 
 
 } // test namespace
@@ -0,0 +1,262 @@
+/* test_conditionsStore.cpp
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../source/ConditionsStore.h"
+
+// ... and any system includes needed for the test file.
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// Make a store with the given number of conditions, named like the conditions
+// that a long-running pilot collects for the missions they have been offered.
+ConditionsStore MakeStore(int count)
+{
+	ConditionsStore store;
+	for(int i = 0; i < count; ++i)
+		store["mission " + std::to_string(i) + ": offered"] = i;
+	return store;
+}
+
+// Get the names of the conditions in the given store, in the order they are visited.
+std::vector<std::string> Names(const ConditionsStore &store)
+{
+	std::vector<std::string> names;
+	for(const auto &it : store)
+		names.push_back(it.first);
+	return names;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Giving conditions IDs", "[ConditionsStore]" ) {
+	GIVEN( "a condition name" ) {
+		const std::string name = "test: interned name";
+		ConditionsStore::Id id = ConditionsStore::GetId(name);
+		THEN( "it always gets the same ID" ) {
+			CHECK( ConditionsStore::GetId(name) == id );
+			CHECK( ConditionsStore::Name(id) == name );
+		}
+		THEN( "a different name gets a different ID" ) {
+			CHECK( ConditionsStore::GetId(name + "!") != id );
+		}
+	}
+}
+
+SCENARIO( "Storing conditions", "[ConditionsStore]" ) {
+	GIVEN( "an empty store" ) {
+		ConditionsStore store;
+		REQUIRE( store.empty() );
+		REQUIRE( store.begin() == store.end() );
+
+		THEN( "any condition has the value 0" ) {
+			CHECK( store.Get(ConditionsStore::GetId("test: missing")) == 0 );
+			CHECK_FALSE( store.Find(ConditionsStore::GetId("test: missing")) );
+			CHECK( store.find("test: never named") == store.end() );
+			CHECK( store.count("test: never named") == 0 );
+		}
+		WHEN( "conditions are set by name" ) {
+			store["b"] = 2;
+			store["a"] = 1;
+			store["c"] = 0;
+			THEN( "they can be found by name or by ID" ) {
+				REQUIRE( store.size() == 3 );
+				CHECK( store.find("b")->second == 2 );
+				CHECK( store.Get(ConditionsStore::GetId("a")) == 1 );
+				CHECK( store.count("c") == 1 );
+				CHECK( store.Has(ConditionsStore::GetId("c")) );
+			}
+			THEN( "they are visited in order of their names" ) {
+				CHECK( Names(store) == std::vector<std::string>{"a", "b", "c"} );
+			}
+			AND_WHEN( "one is added that is already there" ) {
+				auto result = store.emplace("a", 5);
+				THEN( "its value is not changed" ) {
+					CHECK_FALSE( result.second );
+					CHECK( result.first->second == 1 );
+				}
+			}
+			AND_WHEN( "one is erased" ) {
+				CHECK( store.erase("b") == 1 );
+				CHECK( store.erase("b") == 0 );
+				THEN( "it is no longer in the store" ) {
+					CHECK( store.size() == 2 );
+					CHECK( store.find("b") == store.end() );
+					CHECK( Names(store) == std::vector<std::string>{"a", "c"} );
+				}
+			}
+			AND_WHEN( "values are changed through an iterator" ) {
+				for(const auto &it : store)
+					it.second += 10;
+				THEN( "the stored values are changed" ) {
+					CHECK( store.find("a")->second == 11 );
+					CHECK( store.find("c")->second == 10 );
+				}
+			}
+		}
+	}
+	GIVEN( "a store with many conditions" ) {
+		const int COUNT = 5000;
+		ConditionsStore store = MakeStore(COUNT);
+		REQUIRE( store.size() == COUNT );
+
+		THEN( "every condition has the value it was given" ) {
+			bool allFound = true;
+			for(int i = 0; i < COUNT; ++i)
+				allFound &= (store.Get(ConditionsStore::GetId("mission " + std::to_string(i) + ": offered")) == i);
+			CHECK( allFound );
+		}
+		WHEN( "conditions are erased in a random order" ) {
+			std::map<std::string, int64_t> expected;
+			for(const auto &it : store)
+				expected[it.first] = it.second;
+			std::minstd_rand random(1);
+			for(int i = 0; i < COUNT / 2; ++i)
+			{
+				std::string name = "mission " + std::to_string(random() % COUNT) + ": offered";
+				CHECK( store.erase(name) == expected.erase(name) );
+			}
+			THEN( "the ones that are left can all still be found" ) {
+				REQUIRE( store.size() == expected.size() );
+				bool allFound = true;
+				for(const auto &it : expected)
+				{
+					const int64_t *value = store.Find(ConditionsStore::GetId(it.first));
+					allFound &= (value && *value == it.second);
+				}
+				CHECK( allFound );
+			}
+		}
+	}
+	GIVEN( "conditions with a shared prefix" ) {
+		ConditionsStore store = {{"ships: Light Warship", 2}, {"ships: Transport", 1},
+			{"ships:!", 7}, {"shields", 3}, {"ship", 4}};
+		WHEN( "the ones with the prefix are looked up" ) {
+			std::vector<std::string> names;
+			const std::string prefix = "ships: ";
+			for(auto it = store.lower_bound(prefix); it != store.end() && !it->first.compare(0, prefix.length(), prefix); ++it)
+				names.push_back(it->first);
+			THEN( "only they are found, in order" ) {
+				CHECK( names == std::vector<std::string>{"ships: Light Warship", "ships: Transport"} );
+			}
+		}
+		WHEN( "the ones with the prefix are erased" ) {
+			store.erase(store.lower_bound("ships: "), store.lower_bound("ships:!"));
+			THEN( "the others are left" ) {
+				CHECK( Names(store) == std::vector<std::string>{"shields", "ship", "ships:!"} );
+			}
+		}
+	}
+}
+
+SCENARIO( "Tracking changes to conditions", "[ConditionsStore]" ) {
+	GIVEN( "a store with some conditions" ) {
+		ConditionsStore store = {{"a", 1}, {"b", 2}};
+		const ConditionsStore::Id a = ConditionsStore::GetId("a");
+		const ConditionsStore::Id b = ConditionsStore::GetId("b");
+		const ConditionsStore::Id c = ConditionsStore::GetId("c");
+		const uint64_t revision = store.Revision();
+
+		THEN( "reading them does not count as changing them" ) {
+			const ConditionsStore &constStore = store;
+			CHECK( store.Get(a) == 1 );
+			CHECK( constStore.find("b")->second == 2 );
+			for(const auto &it : constStore)
+				CHECK( it.second > 0 );
+			CHECK( store.Revision() == revision );
+			CHECK_FALSE( store.HasChanged(a, revision) );
+			CHECK_FALSE( store.HasChanged(b, revision) );
+		}
+		WHEN( "one is changed" ) {
+			store["a"] = 3;
+			THEN( "only that one has changed" ) {
+				CHECK( store.Revision() > revision );
+				CHECK( store.HasChanged(a, revision) );
+				CHECK_FALSE( store.HasChanged(b, revision) );
+				CHECK_FALSE( store.HasChanged(c, revision) );
+				CHECK_FALSE( store.HasChanged(a, store.Revision()) );
+			}
+		}
+		WHEN( "one is erased" ) {
+			store.erase("b");
+			store.erase("c");
+			THEN( "only that one has changed" ) {
+				CHECK_FALSE( store.HasChanged(a, revision) );
+				CHECK( store.HasChanged(b, revision) );
+				CHECK_FALSE( store.HasChanged(c, revision) );
+			}
+		}
+		WHEN( "the store is cleared" ) {
+			store.clear();
+			THEN( "every condition has changed" ) {
+				CHECK( store.HasChanged(a, revision) );
+				CHECK( store.HasChanged(c, revision) );
+				CHECK_FALSE( store.HasChanged(c, store.Revision()) );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark ConditionsStore lookups", "[!benchmark][conditionsstore]" ) {
+	const int COUNT = 50000;
+	ConditionsStore store = MakeStore(COUNT);
+	std::map<std::string, int64_t> map;
+	std::vector<std::string> names;
+	std::vector<ConditionsStore::Id> ids;
+	for(int i = 0; i < COUNT; i += 50)
+	{
+		names.push_back("mission " + std::to_string(i) + ": offered");
+		ids.push_back(ConditionsStore::GetId(names.back()));
+	}
+	for(const auto &it : store)
+		map[it.first] = it.second;
+
+	BENCHMARK( "std::map lookups of 1000 of 50000 conditions" ) {
+		int64_t sum = 0;
+		for(const std::string &name : names)
+			sum += map.find(name)->second;
+		return sum;
+	};
+	BENCHMARK( "ConditionsStore lookups of 1000 of 50000 conditions by name" ) {
+		int64_t sum = 0;
+		for(const std::string &name : names)
+			sum += store.find(name)->second;
+		return sum;
+	};
+	BENCHMARK( "ConditionsStore lookups of 1000 of 50000 conditions by ID" ) {
+		int64_t sum = 0;
+		for(ConditionsStore::Id id : ids)
+			sum += store.Get(id);
+		return sum;
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
@@ -242,6 +242,59 @@ SCENARIO( "Determining if a token is numeric", "[IsNumber][Parsing][DataNode]" )
 		}
 	}
 }
+
+SCENARIO( "Converting a node's tokens to numbers", "[Value][Parsing][DataNode]" ) {
+	OutputSink traces(std::cerr);
+	GIVEN( "A node with numeric and non-numeric tokens" ) {
+		const DataNode node = AsDataNode("key 12 -2.5 +3e2 1.5E-1 text \"\" 4.2.0");
+		REQUIRE( node.Size() == 8 );
+		THEN( "numeric tokens are identified" ) {
+			CHECK_FALSE( node.IsNumber(0) );
+			CHECK( node.IsNumber(1) );
+			CHECK( node.IsNumber(2) );
+			CHECK( node.IsNumber(3) );
+			CHECK( node.IsNumber(4) );
+			CHECK_FALSE( node.IsNumber(5) );
+			CHECK_FALSE( node.IsNumber(6) );
+			CHECK_FALSE( node.IsNumber(7) );
+			CHECK_FALSE( node.IsNumber(8) );
+		}
+		THEN( "numeric tokens have the same value as the static conversion" ) {
+			for(int i = 1; i < 5; ++i)
+				CHECK( node.Value(i) == DataNode::Value(node.Token(i)) );
+			CHECK( node.Value(1) == 12. );
+			CHECK( node.Value(2) == -2.5 );
+			CHECK( node.Value(3) == 300. );
+			CHECK( node.Value(4) == Approx(.15) );
+		}
+		THEN( "non-numeric tokens have a value of 0" ) {
+			CHECK( node.Value(0) == 0. );
+			CHECK( traces.Flush() == "\nCannot convert value \"key\" to a number:\nkey 12 -2.5 +3e2 1.5E-1 text  4.2.0\n" );
+			CHECK( node.Value(8) == 0. );
+			CHECK( traces.Flush() == "\nRequested token index (8) is out of bounds:\n"
+				"key 12 -2.5 +3e2 1.5E-1 text  4.2.0\n" );
+		}
+		WHEN( "the node is copied" ) {
+			DataNode partner;
+			partner = node;
+			THEN( "the converted values are copied too" ) {
+				REQUIRE( partner.Size() == node.Size() );
+				for(int i = 0; i < node.Size(); ++i)
+					CHECK( partner.IsNumber(i) == node.IsNumber(i) );
+				CHECK( partner.Value(2) == -2.5 );
+			}
+		}
+		WHEN( "the node is moved" ) {
+			DataNode copy(node);
+			DataNode moved(std::move(copy));
+			THEN( "the converted values are moved too" ) {
+				REQUIRE( moved.Size() == node.Size() );
+				CHECK( moved.IsNumber(3) );
+				CHECK( moved.Value(3) == 300. );
+			}
+		}
+	}
+}
 // #endregion unit tests
 
 
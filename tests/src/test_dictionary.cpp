@@ -0,0 +1,147 @@
+/* test_dictionary.cpp
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../source/Dictionary.h"
+
+// Include the list of attributes that have compile-time IDs.
+#include "../../source/Attribute.h"
+
+// ... and any system includes needed for the test file.
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// Get the keys in the given dictionary, in the order they are visited.
+std::vector<std::string> Keys(const Dictionary &dictionary)
+{
+	std::vector<std::string> keys;
+	for(const auto &it : dictionary)
+		keys.push_back(it.first);
+	return keys;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Giving dictionary keys IDs", "[Dictionary]" ) {
+	GIVEN( "an attribute with a compile-time ID" ) {
+		THEN( "its name has that ID" ) {
+			CHECK( Dictionary::GetId("shield generation") == Attribute::SHIELD_GENERATION );
+			CHECK( !std::strcmp(Dictionary::Name(Attribute::SHIELD_GENERATION), "shield generation") );
+		}
+		THEN( "every one of them has the ID of its name" ) {
+			bool allMatch = true;
+			for(Dictionary::Id id = 0; id < Attribute::COUNT; ++id)
+				allMatch &= (Dictionary::GetId(Attribute::Name(id)) == id);
+			CHECK( allMatch );
+		}
+	}
+	GIVEN( "any other key" ) {
+		const std::string key = "test: dictionary key";
+		Dictionary::Id id = Dictionary::GetId(key);
+		THEN( "it always gets the same ID, after the compile-time ones" ) {
+			CHECK( id >= Attribute::COUNT );
+			CHECK( Dictionary::GetId(key.c_str()) == id );
+			CHECK( Dictionary::Name(id) == key );
+		}
+	}
+}
+
+SCENARIO( "Storing values in a Dictionary", "[Dictionary]" ) {
+	GIVEN( "an empty dictionary" ) {
+		Dictionary dictionary;
+		REQUIRE( dictionary.empty() );
+		
+		THEN( "every key has the value 0" ) {
+			CHECK( dictionary.Get("thrust") == 0. );
+			CHECK( dictionary.Get(Attribute::THRUST) == 0. );
+			CHECK( dictionary.Get(Dictionary::GetId("test: never set")) == 0. );
+		}
+		WHEN( "values are set by name and by ID" ) {
+			dictionary["turn"] = 2.;
+			dictionary[Attribute::DRAG] = 1.;
+			dictionary["test: dictionary value"] = 3.;
+			dictionary[std::string("afterburner thrust")] = 4.;
+			THEN( "they can be read back by name or by ID" ) {
+				CHECK( dictionary.Get(Attribute::TURN) == 2. );
+				CHECK( dictionary.Get("drag") == 1. );
+				CHECK( dictionary.Get(Dictionary::GetId("test: dictionary value")) == 3. );
+				CHECK( dictionary.Get(Attribute::AFTERBURNER_THRUST) == 4. );
+				CHECK( dictionary.Get(Attribute::THRUST) == 0. );
+			}
+			THEN( "they are visited in order of their names" ) {
+				CHECK( Keys(dictionary) == std::vector<std::string>{"afterburner thrust", "drag",
+					"test: dictionary value", "turn"} );
+			}
+			AND_WHEN( "a value is changed through a reference" ) {
+				dictionary[Attribute::TURN] += 5.;
+				dictionary["drag"] *= 3.;
+				THEN( "the new value is seen either way" ) {
+					CHECK( dictionary.Get("turn") == 7. );
+					CHECK( dictionary.Get(Attribute::DRAG) == 3. );
+				}
+			}
+			AND_WHEN( "the dictionary is copied and more values are added" ) {
+				Dictionary copy = dictionary;
+				copy["active cooling"] = 5.;
+				copy["zzz: test key"] = 6.;
+				THEN( "the copy has all the values" ) {
+					CHECK( copy.Get(Attribute::ACTIVE_COOLING) == 5. );
+					CHECK( copy.Get(Attribute::TURN) == 2. );
+					CHECK( copy.Get(Attribute::AFTERBURNER_THRUST) == 4. );
+					CHECK( copy.Get("zzz: test key") == 6. );
+				}
+				THEN( "the original is unchanged" ) {
+					CHECK( dictionary.Get(Attribute::ACTIVE_COOLING) == 0. );
+					CHECK( Keys(dictionary).size() == 4 );
+				}
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark Dictionary lookups", "[!benchmark][dictionary]" ) {
+	Dictionary dictionary;
+	for(Dictionary::Id id = 0; id < Attribute::COUNT; id += 2)
+		dictionary[id] = id;
+	
+	BENCHMARK( "Dictionary::Get() of every attribute by name" ) {
+		double sum = 0.;
+		for(Dictionary::Id id = 0; id < Attribute::COUNT; ++id)
+			sum += dictionary.Get(Attribute::Name(id));
+		return sum;
+	};
+	BENCHMARK( "Dictionary::Get() of every attribute by ID" ) {
+		double sum = 0.;
+		for(Dictionary::Id id = 0; id < Attribute::COUNT; ++id)
+			sum += dictionary.Get(id);
+		return sum;
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
@@ -0,0 +1,188 @@
+/* test_imageBuffer.cpp
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../source/ImageBuffer.h"
+
+// ... and any system includes needed for the test file.
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// Fill the given buffer with random pixels. Some of the pixels are fully
+// transparent or fully opaque, as in most real images.
+void Fill(ImageBuffer &buffer, int width, int height, unsigned seed)
+{
+	std::minstd_rand random(seed);
+	buffer.Allocate(width, height);
+	uint32_t *it = buffer.Pixels();
+	for(uint32_t *end = it + width * height * buffer.Frames(); it != end; ++it)
+	{
+		uint32_t value = random() ^ (random() << 16);
+		int kind = random() % 4;
+		if(kind == 0)
+			value &= 0x00FFFFFF;
+		else if(kind == 1)
+			value |= 0xFF000000;
+		*it = value;
+	}
+}
+
+std::vector<uint32_t> Copy(const ImageBuffer &buffer)
+{
+	return std::vector<uint32_t>(buffer.Pixels(), buffer.Pixels() + buffer.Width() * buffer.Height() * buffer.Frames());
+}
+
+// Reference implementations, converting one pixel at a time.
+uint32_t Premultiplied(uint32_t value, int additive)
+{
+	uint32_t alpha = value >> 24;
+	uint32_t result = 0;
+	for(int shift = 0; shift < 24; shift += 8)
+		result |= ((((value >> shift) & 0xFF) * alpha) / 255) << shift;
+	if(additive == 1)
+		alpha >>= 2;
+	if(additive != 2)
+		result |= alpha << 24;
+	return result;
+}
+
+std::vector<uint32_t> Shrunk(const std::vector<uint32_t> &pixels, int width, int height, int frames)
+{
+	std::vector<uint32_t> result;
+	for(int frame = 0; frame < frames; ++frame)
+		for(int y = 0; y < height / 2; ++y)
+			for(int x = 0; x < width / 2; ++x)
+			{
+				const uint32_t *a = pixels.data() + width * (2 * y + height * frame) + 2 * x;
+				const uint32_t *b = a + width;
+				uint32_t value = 0;
+				for(int shift = 0; shift < 32; shift += 8)
+				{
+					uint32_t sum = ((a[0] >> shift) & 0xFF) + ((a[1] >> shift) & 0xFF)
+						+ ((b[0] >> shift) & 0xFF) + ((b[1] >> shift) & 0xFF);
+					value |= ((sum + 2) / 4) << shift;
+				}
+				result.push_back(value);
+			}
+	return result;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Converting an image to premultiplied alpha", "[ImageBuffer][Premultiply]" ) {
+	GIVEN( "every possible combination of color and alpha" ) {
+		ImageBuffer buffer;
+		buffer.Allocate(256, 256);
+		for(uint32_t alpha = 0; alpha < 256; ++alpha)
+			for(uint32_t color = 0; color < 256; ++color)
+				buffer.Begin(alpha)[color] = (alpha << 24) | (color << 16) | ((255 - color) << 8) | (color ^ alpha);
+		const auto original = Copy(buffer);
+		
+		for(int additive = 0; additive < 3; ++additive)
+			WHEN( "the image is converted with additive mode " + std::to_string(additive) ) {
+				buffer.Premultiply(0, additive);
+				THEN( "each pixel matches the single-pixel conversion" ) {
+					const auto result = Copy(buffer);
+					int mismatches = 0;
+					for(size_t i = 0; i < original.size(); ++i)
+						mismatches += (result[i] != Premultiplied(original[i], additive));
+					CHECK( mismatches == 0 );
+				}
+			}
+	}
+	GIVEN( "images whose widths are not a multiple of the vector size" ) {
+		for(int width = 1; width < 12; ++width)
+		{
+			ImageBuffer buffer(2);
+			Fill(buffer, width, 3, width);
+			const auto original = Copy(buffer);
+			WHEN( "the second frame of a " + std::to_string(width) + " pixel wide image is converted" ) {
+				buffer.Premultiply(1);
+				THEN( "only that frame changes, and every pixel of it is converted" ) {
+					const auto result = Copy(buffer);
+					const size_t frameSize = width * 3;
+					for(size_t i = 0; i < result.size(); ++i)
+						CHECK( result[i] == (i < frameSize ? original[i] : Premultiplied(original[i], 0)) );
+				}
+			}
+		}
+	}
+}
+
+SCENARIO( "Shrinking an image to half size", "[ImageBuffer][ShrinkToHalfSize]" ) {
+	GIVEN( "images of various sizes, some of which are odd" ) {
+		for(int width = 2; width < 20; width += 3)
+			for(int height = 2; height < 6; ++height)
+			{
+				// Rows are paired up across the whole buffer, not within each
+				// frame, so only single frame images may have an odd height.
+				const int frames = (height % 2) ? 1 : 2;
+				ImageBuffer buffer(frames);
+				Fill(buffer, width, height, 100 * width + height);
+				const auto original = Copy(buffer);
+				WHEN( "a " + std::to_string(width) + "x" + std::to_string(height) + " image is shrunk" ) {
+					buffer.ShrinkToHalfSize();
+					THEN( "each pixel is the rounded average of a 2x2 block" ) {
+						REQUIRE( buffer.Width() == width / 2 );
+						REQUIRE( buffer.Height() == height / 2 );
+						REQUIRE( buffer.Frames() == frames );
+						CHECK( Copy(buffer) == Shrunk(original, width, height, frames) );
+					}
+				}
+			}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+// These are roughly the dimensions of the largest @2x planet sprites.
+const int BENCHMARK_WIDTH = 1024;
+const int BENCHMARK_HEIGHT = 1024;
+
+TEST_CASE( "Benchmark ImageBuffer::Premultiply", "[!benchmark][imagebuffer]" ) {
+	ImageBuffer buffer;
+	Fill(buffer, BENCHMARK_WIDTH, BENCHMARK_HEIGHT, 1);
+	BENCHMARK( "ImageBuffer::Premultiply()" ) {
+		buffer.Premultiply(0);
+		return buffer.Pixels()[0];
+	};
+	BENCHMARK( "ImageBuffer::Premultiply() with additive blending" ) {
+		buffer.Premultiply(0, 2);
+		return buffer.Pixels()[0];
+	};
+}
+
+TEST_CASE( "Benchmark ImageBuffer::ShrinkToHalfSize", "[!benchmark][imagebuffer]" ) {
+	BENCHMARK_ADVANCED( "ImageBuffer::ShrinkToHalfSize()" )(Catch::Benchmark::Chronometer meter) {
+		std::vector<ImageBuffer> buffers(meter.runs());
+		for(ImageBuffer &buffer : buffers)
+			Fill(buffer, BENCHMARK_WIDTH, BENCHMARK_HEIGHT, 1);
+		meter.measure([&buffers](int i) { buffers[i].ShrinkToHalfSize(); });
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
@@ -0,0 +1,87 @@
+/* test_profiler.cpp
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../source/Profiler.h"
+
+// ... and any system includes needed for the test file.
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace { // test namespace
+
+// #region unit tests
+SCENARIO( "Counting memory allocations", "[Profiler][Allocations]" ) {
+	// The tests are built with their own copy of the profiler that counts allocations.
+	REQUIRE( Profiler::CountsAllocations() );
+	
+	GIVEN( "the profiler is enabled" ) {
+		Profiler::Enable();
+		REQUIRE( Profiler::IsEnabled() );
+		std::vector<int> values;
+		
+		WHEN( "memory is allocated" ) {
+			uint64_t before = Profiler::Allocations();
+			values.reserve(100);
+			std::unique_ptr<int> single(new int(1));
+			std::unique_ptr<int[]> array(new int[10]);
+			uint64_t after = Profiler::Allocations();
+			THEN( "each allocation is counted" ) {
+				CHECK( values.capacity() >= 100 );
+				CHECK( *single == 1 );
+				CHECK( array != nullptr );
+				CHECK( after - before == 3 );
+			}
+		}
+		WHEN( "a container is cleared and filled again within its capacity" ) {
+			values.assign(100, 1);
+			uint64_t before = Profiler::Allocations();
+			for(int i = 0; i < 10; ++i)
+			{
+				values.clear();
+				for(int j = 0; j < 100; ++j)
+					values.push_back(j);
+			}
+			uint64_t after = Profiler::Allocations();
+			THEN( "no allocations are counted" ) {
+				CHECK( values.size() == 100 );
+				CHECK( after == before );
+			}
+		}
+		WHEN( "another thread allocates memory" ) {
+			uint64_t before = Profiler::Allocations();
+			uint64_t otherCount = 0;
+			std::thread other([&otherCount]() {
+				uint64_t otherBefore = Profiler::Allocations();
+				std::vector<int> otherValues(100);
+				otherCount = Profiler::Allocations() - otherBefore + (otherValues.size() != 100);
+			});
+			other.join();
+			uint64_t after = Profiler::Allocations();
+			THEN( "it is only counted for that thread" ) {
+				CHECK( otherCount == 1 );
+				// Starting the thread may allocate memory in this thread, but the
+				// other thread's allocation must not be counted here.
+				CHECK( after - before <= 1 );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -0,0 +1,224 @@
+/* test_renderCommands.cpp
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../source/RenderCommands.h"
+
+// Include a helper for counting the commands.
+#include "../../source/RenderCounter.h"
+
+// ... and any system includes needed for the test file.
+#include <cstdint>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// The OpenGL values that are used in these tests, so that this file does not
+// need to include the OpenGL headers.
+const uint32_t ARRAY_BUFFER = 0x8892;
+const uint32_t STATIC_DRAW = 0x88E4;
+const uint32_t TEXTURE_2D = 0x0DE1;
+const uint32_t RGBA8 = 0x8058;
+const uint32_t RGBA = 0x1908;
+const uint32_t UNSIGNED_BYTE = 0x1401;
+const uint32_t TRIANGLE_STRIP = 0x0005;
+
+// A backend that remembers every command that it was given, and a copy of
+// the data that came with it.
+class RecordingBackend : public RenderCommands::Backend {
+public:
+	virtual void Execute(const RenderCommands::Command &command, const void *data) override
+	{
+		commands.push_back(command);
+		const char *begin = static_cast<const char *>(data);
+		this->data.emplace_back(begin, begin + (data ? command.size : 0));
+	}
+	virtual uint32_t Create(RenderCommands::Object object) override { return ++created; }
+	virtual uint32_t CompileProgram(const char *vertex, const char *fragment) override { return ++created; }
+	virtual int32_t GetLocation(uint32_t program, const char *name, bool isAttribute) override { return 0; }
+	virtual int32_t GetInteger(uint32_t name) override { return 0; }
+
+
+public:
+	std::vector<RenderCommands::Command> commands;
+	std::vector<std::vector<char>> data;
+	uint32_t created = 0;
+};
+
+// Switch to the given backend for the rest of the current scope.
+class BackendScope {
+public:
+	explicit BackendScope(RenderCommands::Backend &backend) { RenderCommands::SetBackend(&backend); }
+	~BackendScope() { RenderCommands::SetBackend(nullptr); }
+};
+
+// Record the commands to draw one quad, as one of the shaders would.
+void DrawQuad(uint32_t program, uint32_t vao, float x, float y)
+{
+	RenderCommands::UseProgram(program);
+	RenderCommands::BindVertexArray(vao);
+	RenderCommands::Uniform2f(0, x, y);
+	RenderCommands::DrawArrays(TRIANGLE_STRIP, 0, 4);
+	RenderCommands::BindVertexArray(0);
+	RenderCommands::UseProgram(0);
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Recording render commands", "[RenderCommands]" ) {
+	GIVEN( "a backend" ) {
+		RecordingBackend backend;
+		BackendScope scope(backend);
+		
+		WHEN( "commands are recorded" ) {
+			RenderCommands::UseProgram(7);
+			RenderCommands::BindBuffer(ARRAY_BUFFER, 3);
+			RenderCommands::DrawArrays(TRIANGLE_STRIP, 0, 4);
+			THEN( "they are not carried out until the frame is done" ) {
+				CHECK( backend.commands.empty() );
+			}
+			AND_WHEN( "they are executed" ) {
+				RenderCommands::Execute();
+				THEN( "they are carried out in the order they were recorded" ) {
+					REQUIRE( backend.commands.size() == 3 );
+					CHECK( backend.commands[0].type == RenderCommands::Type::USE_PROGRAM );
+					CHECK( backend.commands[0].args[0] == 7 );
+					CHECK( backend.commands[1].type == RenderCommands::Type::BIND_BUFFER );
+					CHECK( backend.commands[1].args[0] == ARRAY_BUFFER );
+					CHECK( backend.commands[1].args[1] == 3 );
+					CHECK( backend.commands[2].type == RenderCommands::Type::DRAW_ARRAYS );
+					CHECK( backend.commands[2].args[2] == 4 );
+				}
+				AND_WHEN( "they are executed again" ) {
+					RenderCommands::Execute();
+					THEN( "nothing more is carried out" ) {
+						CHECK( backend.commands.size() == 3 );
+					}
+				}
+			}
+		}
+		WHEN( "a command with data is recorded" ) {
+			float values[4] = {1.f, 2.f, 3.f, 4.f};
+			std::vector<float> buffer = {5.f, 6.f, 7.f};
+			RenderCommands::Uniform4fv(2, values);
+			RenderCommands::BufferData(ARRAY_BUFFER, buffer.size() * sizeof(float), buffer.data(), STATIC_DRAW);
+			values[0] = 0.f;
+			buffer.assign(3, 0.f);
+			RenderCommands::Execute();
+			THEN( "a copy of the data is carried out, rather than the data as it is now" ) {
+				REQUIRE( backend.data.size() == 2 );
+				REQUIRE( backend.data[0].size() == 4 * sizeof(float) );
+				CHECK( reinterpret_cast<const float *>(backend.data[0].data())[0] == 1.f );
+				REQUIRE( backend.data[1].size() == 3 * sizeof(float) );
+				CHECK( reinterpret_cast<const float *>(backend.data[1].data())[2] == 7.f );
+				CHECK( backend.commands[1].args[1] == STATIC_DRAW );
+			}
+		}
+		WHEN( "an image is uploaded" ) {
+			const uint32_t pixels[4] = {};
+			uint32_t texture = RenderCommands::GenTexture();
+			RenderCommands::BindTexture(TEXTURE_2D, texture);
+			RenderCommands::TexImage2D(TEXTURE_2D, RGBA8, 2, 2, RGBA, UNSIGNED_BYTE, pixels);
+			THEN( "it is carried out right away, after the commands that came before it" ) {
+				REQUIRE( backend.commands.size() == 2 );
+				CHECK( backend.commands[0].type == RenderCommands::Type::BIND_TEXTURE );
+				CHECK( backend.commands[0].args[1] == texture );
+				CHECK( backend.commands[1].type == RenderCommands::Type::TEXTURE_IMAGE );
+				CHECK( backend.commands[1].size == sizeof(pixels) );
+				CHECK( backend.commands[1].args[4] == 2 );
+				CHECK( backend.commands[1].args[6] == 0 );
+			}
+		}
+		WHEN( "the backend is changed while commands are waiting" ) {
+			RenderCommands::UseProgram(1);
+			RecordingBackend other;
+			RenderCommands::SetBackend(&other);
+			RenderCommands::UseProgram(2);
+			RenderCommands::Execute();
+			RenderCommands::SetBackend(&backend);
+			THEN( "each command is carried out by the backend it was recorded for" ) {
+				CHECK( backend.commands.size() == 1 );
+				CHECK( other.commands.size() == 1 );
+			}
+		}
+	}
+}
+
+SCENARIO( "Counting render commands", "[RenderCounter]" ) {
+	GIVEN( "a counting backend" ) {
+		RenderCounter counter;
+		BackendScope scope(counter);
+		
+		WHEN( "objects are created" ) {
+			uint32_t first = RenderCommands::GenBuffer();
+			uint32_t second = RenderCommands::GenTexture();
+			THEN( "they are given different names" ) {
+				CHECK( first != 0 );
+				CHECK( second != 0 );
+				CHECK( first != second );
+			}
+		}
+		WHEN( "a frame is built" ) {
+			std::vector<float> vertices(8);
+			RenderCommands::BindBuffer(ARRAY_BUFFER, 1);
+			RenderCommands::BufferData(ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), STATIC_DRAW);
+			DrawQuad(1, 2, 0.f, 0.f);
+			DrawQuad(1, 2, 10.f, 0.f);
+			RenderCommands::DrawArraysInstanced(TRIANGLE_STRIP, 0, 4, 10);
+			RenderCommands::Execute();
+			THEN( "its draw calls, vertices, state changes, and uploads are counted" ) {
+				CHECK( counter.drawCalls == 3 );
+				CHECK( counter.vertices == 48 );
+				CHECK( counter.stateChanges == 9 );
+				CHECK( counter.uniforms == 2 );
+				CHECK( counter.bytes == 8 * sizeof(float) );
+			}
+			AND_WHEN( "the counts are cleared" ) {
+				counter.Clear();
+				THEN( "they are all zero" ) {
+					CHECK( counter.drawCalls == 0 );
+					CHECK( counter.vertices == 0 );
+					CHECK( counter.stateChanges == 0 );
+					CHECK( counter.uniforms == 0 );
+					CHECK( counter.bytes == 0 );
+				}
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark RenderCommands recording", "[!benchmark][rendercommands]" ) {
+	RenderCounter counter;
+	BackendScope scope(counter);
+	BENCHMARK( "Record and execute 1000 quads" ) {
+		for(int i = 0; i < 1000; ++i)
+			DrawQuad(1, 2, i, i);
+		RenderCommands::Execute();
+		return counter.drawCalls;
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
@@ -136,6 +136,59 @@ SCENARIO( "A Set can be reverted to an earlier state", "[Set]" ) {
 					CHECK( instance.Find("A")->a == original.Find("A")->a );
 					CHECK( instance.Find("A") != original.Find("A") );
 				}
+				THEN( "a removed key can be added again" ) {
+					CHECK( instance.Find("D") == nullptr );
+					CHECK( instance.Get("D")->a == 1 );
+					CHECK( instance.size() == original.size() + 1 );
+				}
+			}
+		}
+	}
+}
+
+SCENARIO( "A Set keeps its objects in place and in order", "[Set]" ) {
+	GIVEN( "a Set<T> with data" ) {
+		auto s = Set<T>{};
+		const T *first = s.Get("m");
+		
+		WHEN( "many more objects are added" ) {
+			for(int i = 0; i < 1000; ++i)
+				s.Get("key " + std::to_string(i))->a = i;
+			THEN( "pointers to existing objects are still valid" ) {
+				CHECK( s.Find("m") == first );
+				CHECK( s.Get("m") == first );
+				CHECK( s.Find("key 500")->a == 500 );
+			}
+			THEN( "iteration is in order of the keys" ) {
+				std::string previous;
+				for(const auto &it : s)
+				{
+					CHECK( previous < it.first );
+					CHECK( s.Find(it.first) == &it.second );
+					previous = it.first;
+				}
+			}
+		}
+		
+		WHEN( "the Set is copied" ) {
+			auto copy = s;
+			THEN( "lookups in the copy return the copy's objects" ) {
+				REQUIRE( copy.Has("m") );
+				CHECK( copy.Find("m") != first );
+				CHECK( copy.Get("m") == copy.Find("m") );
+			}
+			THEN( "adding to the copy does not change the original" ) {
+				copy.Get("n");
+				CHECK( copy.Has("n") );
+				CHECK_FALSE( s.Has("n") );
+			}
+		}
+		
+		WHEN( "the Set is moved" ) {
+			auto moved = std::move(s);
+			THEN( "the objects are still at the same addresses" ) {
+				CHECK( moved.Find("m") == first );
+				CHECK( moved.Get("m") == first );
 			}
 		}
 	}
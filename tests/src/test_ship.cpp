@@ -15,7 +15,15 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 // Include only the tested class's header.
 #include "../../source/Ship.h"
 
+// Include a helper for creating well-formed DataNodes.
+#include "datanode-factory.h"
+
+// Include the classes needed to give the ship attributes.
+#include "../../source/Attribute.h"
+#include "../../source/Outfit.h"
+
 // ... and any system includes needed for the test file.
+#include <cmath>
 #include <memory>
 #include <string>
 #include <type_traits>
@@ -24,8 +32,77 @@ namespace { // test namespace
 
 // #region mock data
 
-// Insert file-local data here, e.g. classes, structs, or fixtures that will be useful
-// to help test this class/method.
+// A ship model whose attributes touch every stat that the ship caches.
+const std::string MODEL = R"(ship "test: model"
+	attributes
+		"mass" 100
+		"drag" 2
+		"thrust" 20
+		"reverse thrust" 8
+		"turn" 400
+		"heat dissipation" 0.7
+		"cooling" 3
+		"active cooling" 5
+		"cooling inefficiency" 4
+		"hull repair rate" 0.5
+		"hull energy" 1
+		"shield generation" 2
+		"shield energy" 1.5
+		"shield heat" 0.25
+		"outfit space" 100
+		"engine capacity" 50)";
+
+// An afterburner, which only counts as thrust if there is no other thrust.
+Outfit MakeAfterburner()
+{
+	Outfit outfit;
+	outfit.Load(AsDataNode(R"(outfit "test: afterburner"
+	"mass" 5
+	"afterburner thrust" 60)"));
+	return outfit;
+}
+
+// An outfit that changes most of the cached stats.
+Outfit MakeRefit()
+{
+	Outfit outfit;
+	outfit.Load(AsDataNode(R"(outfit "test: refit"
+	"mass" 10
+	"thrust" 5
+	"drag" 0.5
+	"cooling inefficiency" 3
+	"hull repair multiplier" 0.5
+	"hull fuel" 0.1
+	"shield generation multiplier" -0.25
+	"shield fuel" 0.3)"));
+	return outfit;
+}
+
+// Check that the ship's cached stats match the ones computed from its attributes.
+void CheckDerivedStats(const Ship &ship)
+{
+	const Outfit &attributes = ship.Attributes();
+	double x = attributes.Get(Attribute::COOLING_INEFFICIENCY);
+	double efficiency = 2. + 2. / (1. + std::exp(x / -2.)) - 4. / (1. + std::exp(x / -4.));
+	double thrust = attributes.Get(Attribute::THRUST);
+	if(!thrust)
+		thrust = attributes.Get(Attribute::AFTERBURNER_THRUST);
+	double drag = attributes.Get(Attribute::DRAG);
+	
+	CHECK( ship.CoolingEfficiency() == Approx(efficiency) );
+	CHECK( ship.HeatDissipation() == Approx(.001 * attributes.Get(Attribute::HEAT_DISSIPATION)) );
+	CHECK( ship.Acceleration() == Approx(thrust / ship.Mass()) );
+	CHECK( ship.MaxVelocity() == Approx(thrust / drag) );
+	CHECK( ship.MaxReverseVelocity() == Approx(attributes.Get(Attribute::REVERSE_THRUST) / drag) );
+	CHECK( ship.TurnRate() == Approx(attributes.Get(Attribute::TURN) / ship.Mass()) );
+	
+	// Idle heat is where the heat dissipation balances the heat produced.
+	double cooling = efficiency * attributes.Get(Attribute::COOLING);
+	double activeCooling = efficiency * attributes.Get(Attribute::ACTIVE_COOLING);
+	double production = std::max(0., attributes.Get(Attribute::HEAT_GENERATION) - cooling);
+	double dissipation = .001 * attributes.Get(Attribute::HEAT_DISSIPATION) + activeCooling / ship.MaximumHeat();
+	CHECK( ship.IdleHeat() == Approx(production / dissipation) );
+}
 
 // #endregion mock data
 
@@ -95,6 +172,84 @@ SCENARIO( "A Ship::Bay instance is being copied", "[ship][bay]") {
 		}
 	}
 }
+
+SCENARIO( "Caching a ship's derived stats", "[ship]" ) {
+	GIVEN( "a ship loaded from a model" ) {
+		Ship ship(AsDataNode(MODEL));
+		ship.FinishLoading(true);
+		REQUIRE( ship.Mass() == 100. );
+		
+		THEN( "its stats match its attributes" ) {
+			CheckDerivedStats(ship);
+			CHECK( ship.MaxVelocity() == Approx(10.) );
+		}
+		WHEN( "outfits are added" ) {
+			const Outfit refit = MakeRefit();
+			ship.AddOutfit(&refit, 2);
+			THEN( "its stats change to match" ) {
+				CheckDerivedStats(ship);
+				CHECK( ship.MaxVelocity() == Approx(10.) );
+				CHECK( ship.Acceleration() == Approx(30. / 120.) );
+			}
+			AND_WHEN( "they are removed again" ) {
+				ship.AddOutfit(&refit, -2);
+				THEN( "its stats are back where they started" ) {
+					CheckDerivedStats(ship);
+					CHECK( ship.Acceleration() == Approx(.2) );
+				}
+			}
+		}
+		WHEN( "its only thrust comes from an afterburner" ) {
+			const Outfit afterburner = MakeAfterburner();
+			ship.AddOutfit(&afterburner, 1);
+			Outfit removeThrust;
+			removeThrust.Load(AsDataNode("outfit \"test: no thrust\"\n\t\"thrust\" -20"));
+			ship.AddOutfit(&removeThrust, 1);
+			THEN( "the afterburner determines its speed" ) {
+				CheckDerivedStats(ship);
+				CHECK( ship.MaxVelocity() == Approx(30.) );
+			}
+		}
+	}
+}
+
+SCENARIO( "Copying a ship", "[ship]" ) {
+	GIVEN( "a ship loaded from a model" ) {
+		Ship model(AsDataNode(MODEL));
+		model.FinishLoading(true);
+		const Outfit refit = MakeRefit();
+		
+		WHEN( "it is copied" ) {
+			Ship copy = model;
+			THEN( "the copy has the same outfits and attributes" ) {
+				CHECK( &copy.Attributes() == &model.Attributes() );
+				CHECK( copy.Outfits() == model.Outfits() );
+				CHECK( copy.MaxVelocity() == model.MaxVelocity() );
+			}
+			AND_WHEN( "the copy's outfits are changed" ) {
+				copy.AddOutfit(&refit, 1);
+				THEN( "only the copy is changed" ) {
+					CHECK( copy.OutfitCount(&refit) == 1 );
+					CHECK( copy.Attributes().Get(Attribute::THRUST) == 25. );
+					CHECK_FALSE( model.OutfitCount(&refit) );
+					CHECK( model.Attributes().Get(Attribute::THRUST) == 20. );
+					CHECK( model.Mass() == 100. );
+					CheckDerivedStats(copy);
+					CheckDerivedStats(model);
+				}
+			}
+			AND_WHEN( "the original's outfits are changed" ) {
+				model.AddOutfit(&refit, 1);
+				THEN( "the copy is not changed" ) {
+					CHECK_FALSE( copy.OutfitCount(&refit) );
+					CHECK( copy.Attributes().Get(Attribute::THRUST) == 20. );
+					CHECK( model.Attributes().Get(Attribute::THRUST) == 25. );
+				}
+			}
+		}
+	}
+}
+
 // Constructing useful Ship instances requires Ship::Load, which requires all of GameData & runtime deps.
 
 
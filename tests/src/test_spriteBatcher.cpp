@@ -0,0 +1,194 @@
+/* test_spriteBatcher.cpp
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../source/SpriteBatcher.h"
+
+// ... and any system includes needed for the test file.
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// Get an unrotated, square item of the given size, centered on the given point.
+// The item's alpha is used to tell the items apart.
+SpriteShader::Item MakeItem(uint32_t texture, float x, float y, float size = 10.f, float alpha = 1.f)
+{
+	SpriteShader::Item item;
+	item.texture = texture;
+	item.position[0] = x;
+	item.position[1] = y;
+	item.transform[0] = size;
+	item.transform[3] = size;
+	item.alpha = alpha;
+	return item;
+}
+
+// Get the alpha of each item in the given batch, in the order they are drawn.
+std::vector<float> Alphas(const SpriteBatcher::Batch &batch)
+{
+	std::vector<float> result;
+	for(const SpriteShader::Item &item : batch.items)
+		result.push_back(item.alpha);
+	return result;
+}
+
+// Fill the batcher with many items scattered across a screen, with a handful
+// of different textures, like the ships and effects in a busy battle.
+void AddRandomItems(SpriteBatcher &batcher, int count, unsigned seed)
+{
+	std::minstd_rand random(seed);
+	for(int i = 0; i < count; ++i)
+		batcher.Add(MakeItem(1 + random() % 20, random() % 1920 - 960.f, random() % 1080 - 540.f,
+			10.f + random() % 100));
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Grouping sprites into batches", "[SpriteBatcher]" ) {
+	GIVEN( "an empty batcher" ) {
+		SpriteBatcher batcher;
+		REQUIRE( batcher.Size() == 0 );
+		REQUIRE( batcher.begin() == batcher.end() );
+		
+		WHEN( "sprites with different textures that do not overlap are added" ) {
+			batcher.Add(MakeItem(1, 0.f, 0.f, 10.f, .1f));
+			batcher.Add(MakeItem(2, 100.f, 0.f, 10.f, .2f));
+			batcher.Add(MakeItem(1, 200.f, 0.f, 10.f, .3f));
+			batcher.Add(MakeItem(2, 300.f, 0.f, 10.f, .4f));
+			THEN( "the sprites with the same texture are drawn together, in the order they were added" ) {
+				REQUIRE( batcher.Size() == 2 );
+				const SpriteBatcher::Batch &first = *batcher.begin();
+				const SpriteBatcher::Batch &second = *(batcher.begin() + 1);
+				CHECK( first.texture == 1 );
+				CHECK( Alphas(first) == std::vector<float>{.1f, .3f} );
+				CHECK( second.texture == 2 );
+				CHECK( Alphas(second) == std::vector<float>{.2f, .4f} );
+			}
+		}
+		WHEN( "a sprite overlaps a sprite with a different texture that was added before it" ) {
+			batcher.Add(MakeItem(1, 0.f, 0.f, 10.f, .1f));
+			batcher.Add(MakeItem(2, 5.f, 5.f, 10.f, .2f));
+			batcher.Add(MakeItem(1, 10.f, 0.f, 10.f, .3f));
+			THEN( "it is not moved below that sprite" ) {
+				REQUIRE( batcher.Size() == 3 );
+				std::vector<float> order;
+				for(const SpriteBatcher::Batch &batch : batcher)
+					for(float alpha : Alphas(batch))
+						order.push_back(alpha);
+				CHECK( order == std::vector<float>{.1f, .2f, .3f} );
+			}
+		}
+		WHEN( "a sprite would only overlap another one because of its rotation" ) {
+			// Rotated by 45 degrees, this sprite is about 141 pixels wide.
+			SpriteShader::Item rotated = MakeItem(1, 0.f, 0.f, 100.f);
+			rotated.transform[0] = rotated.transform[1] = rotated.transform[3] = 70.71f;
+			rotated.transform[2] = -70.71f;
+			batcher.Add(MakeItem(1, 0.f, 0.f, 10.f));
+			batcher.Add(MakeItem(2, 65.f, 0.f, 10.f));
+			batcher.Add(rotated);
+			THEN( "the rotation is taken into account" ) {
+				CHECK( batcher.Size() == 3 );
+			}
+		}
+		WHEN( "a sprite would only overlap another one because of its motion blur" ) {
+			SpriteShader::Item blurred = MakeItem(2, 0.f, 0.f, 10.f);
+			blurred.blur[1] = 2.f;
+			batcher.Add(MakeItem(1, 0.f, 0.f, 10.f));
+			batcher.Add(blurred);
+			batcher.Add(MakeItem(1, 0.f, 20.f, 10.f));
+			THEN( "the blur is taken into account" ) {
+				CHECK( batcher.Size() == 3 );
+			}
+		}
+		WHEN( "sprites with the same texture but different swizzles or blur are added" ) {
+			SpriteShader::Item swizzled = MakeItem(1, 100.f, 0.f);
+			swizzled.swizzle = 3;
+			SpriteShader::Item blurred = MakeItem(1, 200.f, 0.f);
+			blurred.blur[0] = .1f;
+			batcher.Add(MakeItem(1, 0.f, 0.f));
+			batcher.Add(swizzled);
+			batcher.Add(blurred);
+			batcher.Add(MakeItem(1, 300.f, 0.f));
+			THEN( "they are put in different batches" ) {
+				REQUIRE( batcher.Size() == 3 );
+				auto it = batcher.begin();
+				CHECK( it->items.size() == 2 );
+				CHECK( (++it)->swizzle == 3 );
+				CHECK( (++it)->isBlurred );
+			}
+		}
+		WHEN( "a sprite is added after many batches that it does not overlap" ) {
+			for(uint32_t i = 1; i <= 100; ++i)
+				batcher.Add(MakeItem(i, 100.f * i, 0.f));
+			batcher.Add(MakeItem(1, 0.f, 100.f));
+			batcher.Add(MakeItem(100, 0.f, 200.f));
+			THEN( "it is only added to a batch that is not too far back" ) {
+				CHECK( batcher.Size() == 101 );
+				CHECK( (batcher.end() - 1)->texture == 1 );
+				CHECK( (batcher.end() - 2)->items.size() == 2 );
+			}
+		}
+	}
+	
+	GIVEN( "a batcher that was used before" ) {
+		SpriteBatcher batcher;
+		AddRandomItems(batcher, 1000, 1);
+		size_t size = batcher.Size();
+		REQUIRE( size > 20 );
+		REQUIRE( size < 1000 );
+		
+		WHEN( "it is cleared" ) {
+			batcher.Clear();
+			THEN( "it has no batches" ) {
+				CHECK( batcher.Size() == 0 );
+				CHECK( batcher.begin() == batcher.end() );
+			}
+			AND_WHEN( "the same sprites are added again" ) {
+				AddRandomItems(batcher, 1000, 1);
+				THEN( "the same batches are made" ) {
+					CHECK( batcher.Size() == size );
+					size_t items = 0;
+					for(const SpriteBatcher::Batch &batch : batcher)
+						items += batch.items.size();
+					CHECK( items == 1000 );
+				}
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark SpriteBatcher::Add", "[!benchmark][spritebatcher]" ) {
+	SpriteBatcher batcher;
+	BENCHMARK( "SpriteBatcher::Add() for 2000 sprites" ) {
+		batcher.Clear();
+		AddRandomItems(batcher, 2000, 1);
+		return batcher.Size();
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
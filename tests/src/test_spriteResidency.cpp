@@ -0,0 +1,208 @@
+/* test_spriteResidency.cpp
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../source/SpriteResidency.h"
+
+// ... and any system includes needed for the test file.
+#include <cstddef>
+#include <map>
+#include <set>
+
+namespace { // test namespace
+
+// #region mock data
+
+// The residency manager never looks inside the sprites, so any distinct
+// addresses can stand in for them.
+const int SPRITE_COUNT = 4;
+const char SPRITES[SPRITE_COUNT] = {};
+const Sprite *GetSprite(int index)
+{
+	return reinterpret_cast<const Sprite *>(SPRITES + index);
+}
+
+// A backend that "uploads" each sprite as soon as it is asked to load it, and
+// just keeps count of how many bytes are loaded.
+class MockBackend : public SpriteResidency::Backend {
+public:
+	virtual void Load(const Sprite *sprite) override
+	{
+		++loads;
+		loaded.insert(sprite);
+	}
+	virtual void Unload(const Sprite *sprite) override
+	{
+		++unloads;
+		loaded.erase(sprite);
+	}
+	virtual size_t Bytes(const Sprite *sprite) const override
+	{
+		auto it = sizes.find(sprite);
+		return (loaded.count(sprite) && it != sizes.end()) ? it->second : 0;
+	}
+	virtual bool WasDrawn(const Sprite *sprite) override
+	{
+		return drawn.erase(sprite);
+	}
+	
+	size_t LoadedBytes() const
+	{
+		size_t total = 0;
+		for(const Sprite *sprite : loaded)
+			total += Bytes(sprite);
+		return total;
+	}
+	
+	std::map<const Sprite *, size_t> sizes;
+	std::set<const Sprite *> loaded;
+	std::set<const Sprite *> drawn;
+	int loads = 0;
+	int unloads = 0;
+};
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Keeping sprites within a texture budget", "[SpriteResidency]" ) {
+	MockBackend backend;
+	for(int i = 0; i < SPRITE_COUNT; ++i)
+		backend.sizes[GetSprite(i)] = 100;
+	SpriteResidency residency(backend);
+	
+	GIVEN( "a sprite that is not managed" ) {
+		WHEN( "it is requested" ) {
+			residency.Request(GetSprite(0));
+			THEN( "nothing is loaded" ) {
+				CHECK_FALSE( residency.IsManaged(GetSprite(0)) );
+				CHECK_FALSE( residency.IsResident(GetSprite(0)) );
+				CHECK( backend.loads == 0 );
+			}
+		}
+	}
+	
+	GIVEN( "a managed sprite that is not loaded yet" ) {
+		residency.Manage(GetSprite(0), false);
+		REQUIRE( residency.IsManaged(GetSprite(0)) );
+		REQUIRE_FALSE( residency.IsResident(GetSprite(0)) );
+		
+		WHEN( "it is requested twice" ) {
+			residency.Request(GetSprite(0));
+			residency.Request(GetSprite(0));
+			THEN( "it is only loaded once" ) {
+				CHECK( residency.IsResident(GetSprite(0)) );
+				CHECK( backend.loads == 1 );
+				CHECK( residency.ResidentBytes() == 100 );
+			}
+		}
+	}
+	
+	GIVEN( "loaded sprites that fit within the budget" ) {
+		residency.SetBudget(300);
+		for(int i = 0; i < 3; ++i)
+		{
+			residency.Manage(GetSprite(i), true);
+			backend.loaded.insert(GetSprite(i));
+		}
+		WHEN( "time passes without any of them being drawn" ) {
+			for(int i = 0; i < 10; ++i)
+				residency.Step();
+			THEN( "none of them are unloaded" ) {
+				CHECK( backend.unloads == 0 );
+				CHECK( residency.ResidentBytes() == 300 );
+			}
+		}
+	}
+	
+	GIVEN( "more loaded sprites than fit within the budget" ) {
+		for(int i = 0; i < SPRITE_COUNT; ++i)
+		{
+			residency.Manage(GetSprite(i), true);
+			backend.loaded.insert(GetSprite(i));
+		}
+		// Draw the sprites in order, so that sprite 0 was drawn least recently
+		// and sprite 3 most recently.
+		for(int i = 0; i < SPRITE_COUNT; ++i)
+		{
+			backend.drawn.insert(GetSprite(i));
+			residency.Step();
+		}
+		residency.SetBudget(250);
+		WHEN( "enough time passes for the sprites to no longer be on screen" ) {
+			for(int i = 0; i < 5; ++i)
+				residency.Step();
+			THEN( "the least recently drawn sprites are unloaded until the rest fit" ) {
+				CHECK( backend.unloads == 2 );
+				CHECK_FALSE( residency.IsResident(GetSprite(0)) );
+				CHECK_FALSE( residency.IsResident(GetSprite(1)) );
+				CHECK( residency.IsResident(GetSprite(2)) );
+				CHECK( residency.IsResident(GetSprite(3)) );
+				CHECK( residency.ResidentBytes() == 200 );
+				CHECK( backend.LoadedBytes() == 200 );
+			}
+			AND_WHEN( "an unloaded sprite is drawn again" ) {
+				backend.drawn.insert(GetSprite(0));
+				residency.Step();
+				THEN( "it is loaded again right away" ) {
+					CHECK( residency.IsResident(GetSprite(0)) );
+					CHECK( backend.loaded.count(GetSprite(0)) );
+				}
+				AND_THEN( "the least recently drawn of the others makes room for it" ) {
+					for(int i = 0; i < 5; ++i)
+						residency.Step();
+					CHECK( residency.IsResident(GetSprite(0)) );
+					CHECK_FALSE( residency.IsResident(GetSprite(2)) );
+					CHECK( residency.IsResident(GetSprite(3)) );
+					CHECK( residency.ResidentBytes() == 200 );
+				}
+			}
+		}
+		WHEN( "a sprite keeps being drawn" ) {
+			for(int i = 0; i < 5; ++i)
+			{
+				backend.drawn.insert(GetSprite(0));
+				residency.Step();
+			}
+			THEN( "it is kept loaded" ) {
+				CHECK( residency.IsResident(GetSprite(0)) );
+				CHECK_FALSE( residency.IsResident(GetSprite(1)) );
+				CHECK_FALSE( residency.IsResident(GetSprite(2)) );
+				CHECK( residency.ResidentBytes() <= 250 );
+			}
+		}
+	}
+	
+	GIVEN( "no budget" ) {
+		for(int i = 0; i < SPRITE_COUNT; ++i)
+		{
+			residency.Manage(GetSprite(i), true);
+			backend.loaded.insert(GetSprite(i));
+		}
+		WHEN( "none of the sprites are drawn for a long time" ) {
+			for(int i = 0; i < 100; ++i)
+				residency.Step();
+			THEN( "they all stay loaded" ) {
+				CHECK( backend.unloads == 0 );
+				CHECK( residency.ResidentBytes() == 400 );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
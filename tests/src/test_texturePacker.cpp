@@ -0,0 +1,243 @@
+/* test_texturePacker.cpp
+Copyright (c) 2021 by Benjamin Hauch
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../source/TexturePacker.h"
+
+// ... and any system includes needed for the test file.
+#include <random>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// An image that was placed by the packer, including its padding.
+class Placed {
+public:
+	TexturePacker::Rect rect;
+	int width;
+	int height;
+};
+
+// Add the given images to the packer, keeping track of where they were placed.
+bool Add(TexturePacker &packer, int width, int height, int count, std::vector<Placed> &placed)
+{
+	std::vector<TexturePacker::Rect> rects;
+	if(!packer.Add(width, height, count, rects))
+		return false;
+	for(const TexturePacker::Rect &rect : rects)
+		placed.push_back(Placed{rect, width, height});
+	return true;
+}
+
+// Count how many of the given images overlap each other or the edges of their
+// layers, including their padding.
+int CountOverlaps(const std::vector<Placed> &placed, int layerSize, int padding)
+{
+	int overlaps = 0;
+	for(size_t i = 0; i < placed.size(); ++i)
+	{
+		const Placed &a = placed[i];
+		overlaps += (a.rect.x - padding < 0 || a.rect.y - padding < 0
+			|| a.rect.x + a.width + padding > layerSize || a.rect.y + a.height + padding > layerSize);
+		for(size_t j = i + 1; j < placed.size(); ++j)
+		{
+			const Placed &b = placed[j];
+			if(a.rect.page != b.rect.page || a.rect.layer != b.rect.layer)
+				continue;
+			overlaps += (a.rect.x - padding < b.rect.x + b.width + padding
+				&& b.rect.x - padding < a.rect.x + a.width + padding
+				&& a.rect.y - padding < b.rect.y + b.height + padding
+				&& b.rect.y - padding < a.rect.y + a.height + padding);
+		}
+	}
+	return overlaps;
+}
+
+// Get a set of image sizes similar to those of the game's small sprites: many
+// projectiles and effects with several frames each.
+class Image {
+public:
+	int width;
+	int height;
+	int frames;
+};
+std::vector<Image> RandomImages(int count, unsigned seed)
+{
+	std::minstd_rand random(seed);
+	std::vector<Image> images;
+	for(int i = 0; i < count; ++i)
+		images.push_back(Image{1 + static_cast<int>(random() % 128), 1 + static_cast<int>(random() % 128),
+			1 + static_cast<int>(random() % 8)});
+	return images;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Packing images into a texture atlas", "[TexturePacker]" ) {
+	GIVEN( "an empty packer" ) {
+		TexturePacker packer(256, 2, 1);
+		REQUIRE( packer.Pages() == 0 );
+		REQUIRE( packer.Usage() == 0. );
+		std::vector<TexturePacker::Rect> rects;
+		
+		WHEN( "a single image is added" ) {
+			REQUIRE( packer.Add(10, 20, 1, rects) );
+			THEN( "it is placed in the corner of the first layer, inside its padding" ) {
+				REQUIRE( rects.size() == 1 );
+				CHECK( rects[0].page == 0 );
+				CHECK( rects[0].layer == 0 );
+				CHECK( rects[0].x == 1 );
+				CHECK( rects[0].y == 1 );
+				CHECK( packer.Pages() == 1 );
+				CHECK( packer.Usage() == Approx(12. * 22. / (256. * 256. * 2.)) );
+			}
+		}
+		WHEN( "an image that is too large is added" ) {
+			THEN( "it is rejected without adding a page" ) {
+				CHECK_FALSE( packer.Add(255, 10, 1, rects) );
+				CHECK_FALSE( packer.Add(10, 300, 1, rects) );
+				CHECK( rects.empty() );
+				CHECK( packer.Pages() == 0 );
+			}
+		}
+		WHEN( "an image with no frames or no area is added" ) {
+			THEN( "it is rejected" ) {
+				CHECK_FALSE( packer.Add(10, 10, 0, rects) );
+				CHECK_FALSE( packer.Add(0, 10, 1, rects) );
+				CHECK( packer.Pages() == 0 );
+			}
+		}
+		WHEN( "images of the same height are added" ) {
+			REQUIRE( packer.Add(30, 30, 3, rects) );
+			THEN( "they are placed side by side on one shelf" ) {
+				REQUIRE( rects.size() == 3 );
+				for(int i = 0; i < 3; ++i)
+				{
+					CHECK( rects[i].layer == 0 );
+					CHECK( rects[i].x == 1 + 32 * i );
+					CHECK( rects[i].y == 1 );
+				}
+			}
+		}
+		WHEN( "a much shorter image is added after a tall one" ) {
+			REQUIRE( packer.Add(30, 100, 1, rects) );
+			REQUIRE( packer.Add(30, 10, 1, rects) );
+			THEN( "it starts a new shelf instead of wasting the tall one's space" ) {
+				REQUIRE( rects.size() == 1 );
+				CHECK( rects[0].x == 1 );
+				CHECK( rects[0].y == 103 );
+			}
+		}
+	}
+	
+	GIVEN( "a packer with small layers" ) {
+		TexturePacker packer(64, 2, 0);
+		std::vector<Placed> placed;
+		
+		WHEN( "more frames are added than fit in one layer" ) {
+			REQUIRE( Add(packer, 32, 32, 6, placed) );
+			THEN( "the rest of them go on the next layer of the same page" ) {
+				REQUIRE( placed.size() == 6 );
+				for(int i = 0; i < 6; ++i)
+				{
+					CHECK( placed[i].rect.page == 0 );
+					CHECK( placed[i].rect.layer == i / 4 );
+				}
+				CHECK( CountOverlaps(placed, 64, 0) == 0 );
+			}
+		}
+		WHEN( "a sprite's frames do not all fit in the space left on a page" ) {
+			REQUIRE( Add(packer, 32, 32, 6, placed) );
+			REQUIRE( Add(packer, 32, 32, 3, placed) );
+			THEN( "all of its frames are put on a new page together" ) {
+				REQUIRE( placed.size() == 9 );
+				for(int i = 6; i < 9; ++i)
+					CHECK( placed[i].rect.page == 1 );
+				CHECK( packer.Pages() == 2 );
+			}
+			AND_WHEN( "a later sprite fits in the space left on the first page" ) {
+				REQUIRE( Add(packer, 32, 32, 2, placed) );
+				THEN( "that space is used" ) {
+					REQUIRE( placed.size() == 11 );
+					CHECK( placed[9].rect.page == 0 );
+					CHECK( placed[10].rect.page == 0 );
+					CHECK( packer.Pages() == 2 );
+					CHECK( CountOverlaps(placed, 64, 0) == 0 );
+				}
+			}
+		}
+		WHEN( "a sprite has more frames than fit on a whole page" ) {
+			std::vector<TexturePacker::Rect> rects;
+			THEN( "it is rejected" ) {
+				CHECK_FALSE( packer.Add(32, 32, 9, rects) );
+				CHECK( rects.empty() );
+				CHECK( packer.Pages() == 0 );
+			}
+		}
+	}
+	
+	GIVEN( "many images of random sizes" ) {
+		const int layerSize = 1024;
+		const int padding = 1;
+		TexturePacker packer(layerSize, 2, padding);
+		std::vector<Placed> placed;
+		int frames = 0;
+		for(const Image &image : RandomImages(300, 1))
+		{
+			REQUIRE( Add(packer, image.width, image.height, image.frames, placed) );
+			frames += image.frames;
+		}
+		THEN( "none of them overlap, and each sprite's frames are on one page" ) {
+			REQUIRE( static_cast<int>(placed.size()) == frames );
+			CHECK( CountOverlaps(placed, layerSize, padding) == 0 );
+			int mixedPages = 0;
+			size_t i = 0;
+			for(const Image &image : RandomImages(300, 1))
+			{
+				for(int j = 1; j < image.frames; ++j)
+					mixedPages += (placed[i + j].rect.page != placed[i].rect.page);
+				i += image.frames;
+			}
+			CHECK( mixedPages == 0 );
+		}
+		THEN( "most of the space in the atlas is used" ) {
+			CHECK( packer.Usage() > .7 );
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark TexturePacker::Add", "[!benchmark][texturepacker]" ) {
+	const std::vector<Image> images = RandomImages(1000, 1);
+	BENCHMARK( "TexturePacker::Add() for 1000 sprites" ) {
+		TexturePacker packer(2048, 2, 1);
+		std::vector<TexturePacker::Rect> rects;
+		for(const Image &image : images)
+			packer.Add(image.width, image.height, image.frames, rects);
+		return packer.Pages();
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
@@ -35,3 +35,13 @@ elif [ -f "$ERR_FILE" ] && [ -s "$ERR_FILE" ]; then
   exit 1
 fi
 echo "Parse test completed successfully."
+
+# Check that every ship's cached stats match its outfits.
+if ! "$1" --check-ships 2>"$RUNTIME_ERRS"; then
+  cat "$RUNTIME_ERRS"
+  rm -f "$RUNTIME_ERRS"
+  echo && echo "Assertion failed: ships have out of date stats" && echo
+  exit 1
+fi
+rm -f "$RUNTIME_ERRS"
+echo "Ship stats test completed successfully."